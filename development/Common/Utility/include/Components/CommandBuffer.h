@@ -0,0 +1,281 @@
+//////////////////////////////////////////////////////////////////////
+// CommandBuffer.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Deferred structural changes (add/remove components and items)
+//      for CoordinatorSet. Systems record into it while iterating
+//      and owner plays all of them back at a safe point, where no one
+//      iterates over coordinators (SystemsCoordinator::Tick end).
+//
+//      Not thread safe, CoordinatorSet hands one to each recording thread,
+//      see CoordinatorSet::Commands().
+//
+//  #include "Components/CommandBuffer.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+#pragma once
+
+#include "Components/ComponentTypes.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <vector>
+
+
+namespace yaget::comp
+{
+    // Record changes for CS (CoordinatorSet) to be applied later in the same order as recorded.
+    // Each change is plain record (operation, id, component index) in one vector. Arguments for new components
+    // (decayed copies) and ids of removed items are constructed inline in payload blocks owned by this buffer.
+    // Records and payload blocks are kept between playbacks, so recording does not allocate once buffer warmed up.
+    template <typename CS>
+    class CommandBuffer : public Noncopyable<CommandBuffer<CS>>
+    {
+    public:
+        using CoordinatorSet = CS;
+
+        CommandBuffer() = default;
+        ~CommandBuffer() { Reset(0); }
+
+        // Create and add new component with id, initialized with args... parameters
+        template <typename C, typename... Args>
+        void AddComponent(comp::Id_t id, Args&&... args)
+        {
+            Record record{ Op::AddComponent, ComponentIndex<C>(), id };
+            if constexpr (sizeof...(Args) > 0)
+            {
+                using Parameters = std::tuple<std::decay_t<Args>...>;
+                static_assert(alignof(Parameters) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "CommandBuffer payload does not support over aligned component parameters.");
+
+                record.mPayload = AllocatePayload(sizeof(Parameters), alignof(Parameters));
+                new (record.mPayload) Parameters(std::forward<Args>(args)...);
+            }
+
+            record.mFunction = &PlaybackAddComponent<C, Args...>;
+            mRecords.push_back(record);
+        }
+
+        // Remove and delete component type C from item id
+        template <typename C>
+        void RemoveComponent(comp::Id_t id)
+        {
+            mRecords.push_back({ Op::RemoveComponent, ComponentIndex<C>(), id });
+        }
+
+        // Remove all components of all items in ids
+        void RemoveItems(const comp::ItemIds& ids)
+        {
+            Record record{ Op::RemoveItems };
+            record.mPayload = AllocatePayload(sizeof(comp::Id_t) * ids.size(), alignof(comp::Id_t));
+            record.mPayloadSize = ids.size();
+            std::uninitialized_copy(ids.begin(), ids.end(), reinterpret_cast<comp::Id_t*>(record.mPayload));
+
+            mRecords.push_back(record);
+        }
+
+        // Load all components of TT from DB for item id
+        template <typename TT = typename CS::FullRow>
+        void LoadItem(comp::Id_t id)
+        {
+            Record record{ Op::LoadItem, 0, id };
+            record.mFunction = &PlaybackLoadItem<TT>;
+
+            mRecords.push_back(record);
+        }
+
+        // Apply all recorded commands to coordinatorSet and clear this buffer.
+        // Nothing can record into this buffer while it plays back (CoordinatorSet hands out other buffer instead).
+        // Return number of commands executed.
+        std::size_t Playback(CoordinatorSet& coordinatorSet)
+        {
+            std::size_t index = 0;
+            try
+            {
+                for (; index < mRecords.size(); ++index)
+                {
+                    Execute(coordinatorSet, mRecords[index]);
+                }
+            }
+            catch (...)
+            {
+                // failed command already released it's payload
+                Reset(index + 1);
+                throw;
+            }
+
+            const std::size_t numCommands = mRecords.size();
+            Reset(numCommands);
+
+            return numCommands;
+        }
+
+        // Drop all recorded commands without executing them.
+        void Clear() { Reset(0); }
+
+        bool IsEmpty() const { return mRecords.empty(); }
+        std::size_t Size() const { return mRecords.size(); }
+
+    private:
+        enum class Op : uint8_t { AddComponent, RemoveComponent, RemoveItems, LoadItem };
+
+        struct Record;
+        // typed part of command, with coordinatorSet nullptr it only destroys payload
+        using Function = void(*)(CoordinatorSet* coordinatorSet, const Record& record);
+
+        struct Record
+        {
+            Op mOp = Op::AddComponent;
+            uint32_t mComponent = 0;            // index of component type in CS::FullRow
+            comp::Id_t mId = comp::INVALID_ID;
+            std::byte* mPayload = nullptr;      // inline parameters or ids, nullptr if none
+            std::size_t mPayloadSize = 0;       // number of ids for RemoveItems
+            Function mFunction = nullptr;       // AddComponent and LoadItem
+        };
+        static_assert(std::is_trivially_copyable_v<Record>, "CommandBuffer Record must stay plain data.");
+
+        struct PayloadBlock
+        {
+            std::unique_ptr<std::byte[]> mData;
+            std::size_t mSize = 0;
+        };
+
+        static constexpr std::size_t PayloadBlockSize = 4096;
+
+        template <std::size_t I>
+        using Component = meta::strip_qualifiers_t<std::tuple_element_t<I, typename CS::FullRow>>;
+
+        template <typename C>
+        static constexpr uint32_t ComponentIndex()
+        {
+            return static_cast<uint32_t>(meta::Index<C*, typename CS::FullRow>::value);
+        }
+
+        template <typename C, typename... Args>
+        static void PlaybackAddComponent(CoordinatorSet* coordinatorSet, const Record& record)
+        {
+            if constexpr (sizeof...(Args) > 0)
+            {
+                using Parameters = std::tuple<std::decay_t<Args>...>;
+                Parameters* parameters = std::launder(reinterpret_cast<Parameters*>(record.mPayload));
+
+                // parameters are destroyed even when component constructor throws
+                struct ParametersGuard
+                {
+                    ~ParametersGuard() { std::destroy_at(mParameters); }
+                    Parameters* mParameters;
+                } parametersGuard{ parameters };
+
+                if (coordinatorSet)
+                {
+                    std::apply([coordinatorSet, &record](auto&... args)
+                    {
+                        coordinatorSet->template AddComponent<C>(record.mId, std::move(args)...);
+                    }, *parameters);
+                }
+            }
+            else if (coordinatorSet)
+            {
+                coordinatorSet->template AddComponent<C>(record.mId);
+            }
+        }
+
+        template <typename TT>
+        static void PlaybackLoadItem(CoordinatorSet* coordinatorSet, const Record& record)
+        {
+            if (coordinatorSet)
+            {
+                coordinatorSet->template LoadItem<TT>(record.mId);
+            }
+        }
+
+        template <typename C>
+        static void PlaybackRemoveComponent(CoordinatorSet& coordinatorSet, comp::Id_t id)
+        {
+            coordinatorSet.template RemoveComponent<C>(id);
+        }
+
+        // remove function per component of CS::FullRow, indexed by Record::mComponent
+        template <std::size_t... I>
+        static constexpr auto MakeRemoveFunctions(std::index_sequence<I...>)
+        {
+            return std::array<void(*)(CoordinatorSet&, comp::Id_t), sizeof...(I)>{ &PlaybackRemoveComponent<Component<I>>... };
+        }
+
+        static void Execute(CoordinatorSet& coordinatorSet, const Record& record)
+        {
+            switch (record.mOp)
+            {
+            case Op::AddComponent:
+            case Op::LoadItem:
+                record.mFunction(&coordinatorSet, record);
+                break;
+
+            case Op::RemoveComponent:
+            {
+                static constexpr auto removeFunctions = MakeRemoveFunctions(std::make_index_sequence<std::tuple_size_v<typename CS::FullRow>>{});
+                removeFunctions[record.mComponent](coordinatorSet, record.mId);
+                break;
+            }
+
+            case Op::RemoveItems:
+            {
+                const comp::Id_t* ids = reinterpret_cast<const comp::Id_t*>(record.mPayload);
+                coordinatorSet.RemoveItems(comp::ItemIds(ids, ids + record.mPayloadSize));
+                break;
+            }
+            }
+        }
+
+        // Carve size bytes from payload blocks, new block is only allocated when none of existing ones has space left
+        std::byte* AllocatePayload(std::size_t size, std::size_t alignment)
+        {
+            for (; mCurrentBlock < mPayloadBlocks.size(); ++mCurrentBlock, mBlockOffset = 0)
+            {
+                const PayloadBlock& block = mPayloadBlocks[mCurrentBlock];
+                const std::size_t offset = (mBlockOffset + alignment - 1) & ~(alignment - 1);
+                if (offset + size <= block.mSize)
+                {
+                    mBlockOffset = offset + size;
+                    return block.mData.get() + offset;
+                }
+            }
+
+            const std::size_t blockSize = std::max(size, PayloadBlockSize);
+            mPayloadBlocks.push_back({ std::make_unique_for_overwrite<std::byte[]>(blockSize), blockSize });
+            mCurrentBlock = mPayloadBlocks.size() - 1;
+            mBlockOffset = size;
+
+            return mPayloadBlocks.back().mData.get();
+        }
+
+        // Destroy payloads of records from firstPending (not played back) and clear records,
+        // keeping capacity and payload blocks for next recording
+        void Reset(std::size_t firstPending)
+        {
+            for (std::size_t i = firstPending; i < mRecords.size(); ++i)
+            {
+                if (mRecords[i].mFunction)
+                {
+                    mRecords[i].mFunction(nullptr, mRecords[i]);
+                }
+            }
+
+            mRecords.clear();
+            mCurrentBlock = 0;
+            mBlockOffset = 0;
+        }
+
+        std::vector<Record> mRecords;
+        std::vector<PayloadBlock> mPayloadBlocks;
+        std::size_t mCurrentBlock = 0;
+        std::size_t mBlockOffset = 0;
+    };
+
+} // namespace yaget::comp
@@ -82,6 +82,7 @@ namespace yaget
         //{
         //    using AutoCleanup = bool; // cleanup any left over components on shutdown
         //    using Global = bool;      // used as a global entity
+        //    using Chunked = bool;     // store items in archetype chunks (see CoordinatorStorage.h)
         //};
         //
         template <internal::RowDataType... IS>
@@ -105,6 +106,15 @@ namespace yaget
             using Global = bool;
         };
 
+        // Helper struct to expose row policy which keeps components by value in archetype chunks,
+        // one contiguous column per component type, for faster iteration over large number of items.
+        // Components must be nothrow move constructible, see Coordinator.
+        template <typename... IS>
+        struct ChunkedRowPolicy : RowPolicy<IS...>
+        {
+            using Chunked = bool;
+        };
+
     } // namespace comp
 
     namespace items
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "Components/ComponentTypes.h"
+#include "Components/CoordinatorStorage.h"
 #include "Components/GameCoordinatorGenerator.h"
 #include "Metrics/Concurrency.h"
 
@@ -61,9 +62,21 @@ namespace yaget::comp
     template<typename Tuple>
     using coordinator_allocator_combine_t = typename coordinator_allocator_combine<Tuple>::type;
 
+    namespace internal
+    {
+        // chunked storage owns components itself, no pool allocators are needed
+        template <typename P>
+        using coordinator_allocators_t = std::conditional_t<has_chunked_storage<P>, std::tuple<>, coordinator_allocator_combine_t<typename P::Row>>;
+    }
+
 
     // Coordinator stores map of items (keyed on item id), manages creation, storage and deletion of components.
     // It uses PoolAllocator as a storage for components.
+    // If policy P declares 'using Chunked = bool;' (see ChunkedRowPolicy), components are stored by value in fixed size
+    // chunks per pattern, contiguous column per type, which ForEachUnordered walks directly without id lookups.
+    // Chunked storage does not keep ids sorted, components must be nothrow move constructible, and since they move,
+    // component pointers are only valid until next add/remove of any component in this Coordinator.
+    // Items must not be added/removed while iterating.
     template <typename P>
     class Coordinator : public Noncopyable<Coordinator<P>>
     {
@@ -74,7 +87,8 @@ namespace yaget::comp
         static constexpr size_t NumComponents = Policy::NumComponents;
 
         using PatternSet = std::bitset<NumComponents>;
-        using Allocators = coordinator_allocator_combine_t<FullRow>;
+        using Allocators = internal::coordinator_allocators_t<Policy>;
+        using Storage = std::conditional_t<internal::has_chunked_storage<Policy>, internal::ChunkStorage<FullRow, PatternSet>, internal::PatternStorage<FullRow, PatternSet>>;
 
         ~Coordinator();
 
@@ -97,9 +111,23 @@ namespace yaget::comp
         // Remove all components with this id
         void RemoveComponents(comp::Id_t id);
 
-        // Remove items 
+        // Remove all components of items in ids, each item must exist.
+        // Items are taken out of their pattern once, without moving trough intermediate patterns.
         void RemoveItems(const comp::ItemIds& ids);
 
+        // Create all components of R (RowPolicy) for each item in ids, none of which can exist yet.
+        // Pool memory is reserved up front and each item is moved to it's new pattern once.
+        // Optional initializer is called for each new item after it's components are created.
+        template<typename R>
+        void AddItems(const comp::ItemIds& ids, const std::function<void(comp::Id_t id, const typename R::Row& row)>& initializer = {});
+
+        // Remove all items and their components
+        void Clear();
+
+        // Give memory of empty pool lines back, keeping at least keepFreeSlots free slots per component type.
+        // Components do not move. Return number of released lines.
+        std::size_t ReleaseMemory(std::size_t keepFreeSlots = 0);
+
         // Return a component for specific item if one exist
         template<typename T>
         T* FindComponent(comp::Id_t id) const;
@@ -119,15 +147,62 @@ namespace yaget::comp
         template<typename R>
         void ForEach(const comp::ItemIds& ids, std::function<bool(comp::Id_t id, const typename R::Row& row)> callback) const;
 
-        // Iterate over all items that conform to pattern R
+        // Iterate over all items that conform to pattern R, in ascending id order
         // Return number of matched items, or 0 if none.
         template<typename R>
         std::size_t ForEach(std::function<bool(comp::Id_t id, const typename R::Row& row)> callback) const;
 
+        // Iterate over all items that conform to pattern R, walking matching patterns directly.
+        // Items are visited grouped by pattern (not sorted by id) and no heap allocations are done per call.
+        // callback(comp::Id_t id, const R::Row& row) return false to stop iteration.
+        // Return number of matched items, or 0 if none.
+        template<typename R, typename C>
+        std::size_t ForEachUnordered(C&& callback) const;
+
+        // Iterate over chunks of items that conform to pattern R, only available for chunked storage.
+        // callback(std::span<const comp::Id_t> ids, const R::Row& columns) where each element of columns points to
+        // first component of contiguous column, and index i in every column belongs to ids[i].
+        // Return number of matched items, or 0 if none.
+        template<typename R, typename C>
+        std::size_t ForEachChunk(C&& callback) const;
+
         template<typename T>
         memory::PoolAllocator<T>& GetAllocator() const;
 
+        // Called after component was added to or removed from an item, used by owners (CoordinatorSet)
+        // to keep any cached views of items in sync. Only one callback is supported.
+        using ChangeCallback = std::function<void(comp::Id_t id)>;
+        void SetChangeCallback(ChangeCallback changeCallback) { mChangeCallback = std::move(changeCallback); }
+
+        // Defer pattern updates and change notifications of Add/RemoveComponent until EndChanges,
+        // so item touched many times moves between patterns once. Components are created/deleted right away
+        // and FindComponent/FindItem see them, but ForEach and GetItemIds will not until EndChanges is called.
+        // Chunked storage keeps components in their pattern, so only notifications are deferred.
+        void BeginChanges();
+        void EndChanges();
+
     private:
+        // Item id had pattern oldBits before it's components changed, move it to it's current pattern
+        // or remember it for EndChanges
+        void OnItemChanged(comp::Id_t id, const PatternSet& oldBits);
+        void UpdatePattern(comp::Id_t id, const PatternSet& oldBits);
+
+        // free all components of item and remove it from collection
+        void RemoveItem(typename std::unordered_map<comp::Id_t, FullRow>::iterator it);
+
+        // Chunked storage moves item id from oldBits to newBits pattern, creating new components with
+        // construct(std::type_identity<T>, void* memory). Items collection is updated with new row.
+        template<typename C>
+        FullRow MoveItem(comp::Id_t id, const PatternSet& oldBits, const PatternSet& newBits, C&& construct);
+
+        void NotifyChange(comp::Id_t id) const
+        {
+            if (mChangeCallback)
+            {
+                mChangeCallback(id);
+            }
+        }
+
         // Helper method to find a specific component allocator
         template<typename T>
         memory::PoolAllocator<T>& FindAllocator() const;
@@ -165,8 +240,13 @@ namespace yaget::comp
         ItemsCollection mItems{};
 
         // map from unique bits to all id's which contain that specific set of components
-        using Patterns = std::unordered_map<PatternSet, std::set<comp::Id_t>>;
-        Patterns mPatterns{};
+        Storage mStorage{};
+
+        ChangeCallback mChangeCallback;
+
+        // item id to it's pattern before first change, while inside BeginChanges/EndChanges
+        std::unordered_map<comp::Id_t, PatternSet> mPendingChanges;
+        bool mDeferChanges = false;
 
         const Strings mComponentNames = comp::db::GetPolicyRowNames<typename P::Row>();
     };
@@ -228,24 +308,32 @@ T* yaget::comp::Coordinator<P>::AddComponent(comp::Id_t id, Args&&... args)
     error_handlers::ThrowOnCheck((currentBits & newBit) != newBit, fmt::format("Requested new component of type: '%s' for Item: '%d' already exist in Coordinator.", typeid(T).name(), id).c_str());
     //YAGET_ASSERT((currentBits & newBit) != newBit, "Reqested new component of type: '%s' for Item: '%d' already exist in Coordinator.", typeid(T).name(), id);
 
-    if (currentBits)
+    T* newComponent = nullptr;
+    if constexpr (internal::has_chunked_storage<Policy>)
     {
-        mPatterns[currentBits].erase(id);
-        if (mPatterns[currentBits].empty())
+        const FullRow newRow = MoveItem(id, currentBits, currentBits | newBit, [id, &args...]<typename C>(std::type_identity<C>, void* memory)
         {
-            mPatterns.erase(currentBits);
-        }
-    }
+            if constexpr (std::is_same_v<C, T>)
+            {
+                return internal::construct_component<C>(memory, id, std::forward<Args>(args)...);
+            }
+            else
+            {
+                return internal::construct_component<C>(memory, id);
+            }
+        });
 
-    memory::PoolAllocator<T>& componentAllocator = FindAllocator<T>();
-    T* newComponent = componentAllocator.Allocate(std::forward<comp::Id_t>(id), std::forward<Args>(args)...);
+        newComponent = std::get<T*>(newRow);
+    }
+    else
+    {
+        memory::PoolAllocator<T>& componentAllocator = FindAllocator<T>();
+        newComponent = componentAllocator.Allocate(std::forward<comp::Id_t>(id), std::forward<Args>(args)...);
 
-    std::get<T*>(mItems[id]) = newComponent;
+        std::get<T*>(mItems[id]) = newComponent;
+    }
 
-    FullRow newRow = FindItem(id);
-    PatternSet newBits = GetValidBits(newRow);
-    YAGET_ASSERT(newBits.any(), "Adding new Component to an item did not create any new pattern bits.");
-    mPatterns[newBits].insert(id);
+    OnItemChanged(id, currentBits);
 
     return newComponent;
 }
@@ -259,30 +347,33 @@ bool yaget::comp::Coordinator<P>::RemoveComponent(comp::Id_t id, T*& component)
 
     FullRow row = FindItem(id);
     PatternSet currentBits = GetValidBits(row);
-    mPatterns[currentBits].erase(id);
-
-    memory::PoolAllocator<T>& componentAllocator = FindAllocator<T>();
-    componentAllocator.Free(component);
-    std::get<T*>(mItems[id]) = nullptr;
-    component = nullptr;
 
-    if (mItems[id] == FullRow{})
+    bool componentsLeft = false;
+    if constexpr (internal::has_chunked_storage<Policy>)
     {
-        mItems.erase(id);
-        mPatterns.erase(currentBits);
+        // component may point into items collection, which MoveItem changes
+        component = nullptr;
+
+        const PatternSet newBits = currentBits & ~PatternSet(MakeBit<T>());
+        MoveItem(id, currentBits, newBits, []<typename C>(std::type_identity<C>, void*) -> C* { return nullptr; });
+        componentsLeft = newBits.any();
     }
     else
     {
-        FullRow newRow = FindItem(id);
-        PatternSet newBits = GetValidBits(newRow);
-        if (newBits.any())
+        memory::PoolAllocator<T>& componentAllocator = FindAllocator<T>();
+        componentAllocator.Free(component);
+        std::get<T*>(mItems[id]) = nullptr;
+        component = nullptr;
+
+        componentsLeft = mItems[id] != FullRow{};
+        if (!componentsLeft)
         {
-            mPatterns[newBits].insert(id);
-            return true;
+            mItems.erase(id);
         }
     }
 
-    return false;
+    OnItemChanged(id, currentBits);
+    return componentsLeft;
 }
 
 template<typename P>
@@ -300,16 +391,123 @@ void yaget::comp::Coordinator<P>::RemoveComponents(comp::Id_t id)
     auto it = mItems.find(id);
     YAGET_ASSERT(it != mItems.end(), "Item id: '%d' does not exist in collection.", id);
 
-    FullRow row = it->second;
-    meta::for_each(row, [this, id](auto& item)
+    RemoveItem(it);
+}
+
+template<typename P>
+void yaget::comp::Coordinator<P>::BeginChanges()
+{
+    YAGET_ASSERT(!mDeferChanges, "Coordinator BeginChanges was already called.");
+    mDeferChanges = true;
+}
+
+template<typename P>
+void yaget::comp::Coordinator<P>::EndChanges()
+{
+    YAGET_ASSERT(mDeferChanges, "Coordinator EndChanges called without BeginChanges.");
+    mDeferChanges = false;
+
+    for (const auto& [id, oldBits] : mPendingChanges)
+    {
+        UpdatePattern(id, oldBits);
+    }
+
+    for (const auto& [id, oldBits] : mPendingChanges)
+    {
+        NotifyChange(id);
+    }
+
+    mPendingChanges.clear();
+}
+
+template<typename P>
+void yaget::comp::Coordinator<P>::OnItemChanged(comp::Id_t id, const PatternSet& oldBits)
+{
+    if (mDeferChanges)
+    {
+        // only first change matters, that is pattern item is stored under
+        mPendingChanges.try_emplace(id, oldBits);
+    }
+    else
     {
-        if (item)
+        UpdatePattern(id, oldBits);
+        NotifyChange(id);
+    }
+}
+
+template<typename P>
+void yaget::comp::Coordinator<P>::UpdatePattern(comp::Id_t id, const PatternSet& oldBits)
+{
+    // chunked storage already placed item in it's current pattern trough MoveItem
+    if constexpr (!internal::has_chunked_storage<Policy>)
+    {
+        const FullRow newRow = FindItem(id);
+        const PatternSet newBits = GetValidBits(newRow);
+
+        if (oldBits.any())
+        {
+            mStorage.Erase(oldBits, id);
+        }
+
+        if (newBits.any())
         {
-            RemoveComponent(id, item);
+            mStorage.Insert(newBits, id, newRow);
         }
+    }
+}
+
+template<typename P>
+void yaget::comp::Coordinator<P>::RemoveItem(typename std::unordered_map<comp::Id_t, FullRow>::iterator it)
+{
+    const comp::Id_t id = it->first;
+    const PatternSet oldBits = GetValidBits(it->second);
+
+    if constexpr (internal::has_chunked_storage<Policy>)
+    {
+        MoveItem(id, oldBits, PatternSet{}, []<typename C>(std::type_identity<C>, void*) -> C* { return nullptr; });
+    }
+    else
+    {
+        meta::for_each(it->second, [this]<typename T0>(T0& component)
+        {
+            if (component)
+            {
+                using CompType = meta::strip_qualifiers_t<T0>;
+                FindAllocator<CompType>().Free(component);
+                component = nullptr;
+            }
+        });
+
+        mItems.erase(it);
+    }
+
+    OnItemChanged(id, oldBits);
+}
+
+template<typename P>
+template<typename C>
+typename yaget::comp::Coordinator<P>::FullRow yaget::comp::Coordinator<P>::MoveItem(comp::Id_t id, const PatternSet& oldBits, const PatternSet& newBits, C&& construct)
+{
+    const FullRow newRow = mStorage.Move(id, oldBits, newBits, construct, [this](comp::Id_t movedId, const FullRow& movedRow)
+    {
+        // other item took old place of id, it's pattern did not change but pointers did
+        auto movedIt = mItems.find(movedId);
+        YAGET_ASSERT(movedIt != mItems.end(), "Relocated item id: '%d' does not exist in collection.", movedId);
+        movedIt->second = movedRow;
+
+        OnItemChanged(movedId, GetValidBits(movedRow));
     });
 
-    YAGET_ASSERT(mItems.contains(id) == false, "Item id: '%d' still exist in collection.", id);
+    if (newBits.any())
+    {
+        mItems[id] = newRow;
+    }
+    else
+    {
+        mItems.erase(id);
+    }
+
+    return newRow;
 }
 
 template<typename P>
@@ -317,7 +515,94 @@ void yaget::comp::Coordinator<P>::RemoveItems(const comp::ItemIds& ids)
 {
     for (const auto& id : ids)
     {
-        RemoveComponents(id);
+        auto it = mItems.find(id);
+        YAGET_ASSERT(it != mItems.end(), "Item id: '%d' does not exist in collection.", id);
+
+        RemoveItem(it);
+    }
+}
+
+template<typename P>
+void yaget::comp::Coordinator<P>::Clear()
+{
+    while (!mItems.empty())
+    {
+        RemoveItem(mItems.begin());
+    }
+}
+
+template<typename P>
+std::size_t yaget::comp::Coordinator<P>::ReleaseMemory(std::size_t keepFreeSlots)
+{
+    if constexpr (internal::has_chunked_storage<Policy>)
+    {
+        return mStorage.ReleaseMemory(keepFreeSlots);
+    }
+    else
+    {
+        std::size_t numReleased = 0;
+        meta::for_each(mAllocators, [&numReleased, keepFreeSlots](auto& allocator)
+        {
+            numReleased += allocator.ReleaseEmptyLines(keepFreeSlots);
+        });
+
+        return numReleased;
+    }
+}
+
+template<typename P>
+template<typename R>
+void yaget::comp::Coordinator<P>::AddItems(const comp::ItemIds& ids, const std::function<void(comp::Id_t id, const typename R::Row& row)>& initializer)
+{
+    using Row = typename R::Row;
+
+    const PatternSet requestBits = meta::tuple_bit_pattern_v<FullRow, Row>;
+    YAGET_ASSERT(requestBits.any(), "AddItems requested row does not have any components of this Coordinator [%s].", conv::Combine(mComponentNames, ", ").c_str());
+
+    if constexpr (!internal::has_chunked_storage<Policy>)
+    {
+        meta::for_each_type<Row>([this, &ids]<typename T0>(const T0&)
+        {
+            using CompType = meta::strip_qualifiers_t<T0>;
+            FindAllocator<CompType>().Reserve(ids.size());
+        });
+    }
+
+    mItems.reserve(mItems.size() + ids.size());
+
+    for (const auto& id : ids)
+    {
+        const PatternSet oldBits = GetValidBits(FindItem(id));
+
+        error_handlers::ThrowOnCheck((oldBits & requestBits).none(), fmt::format("Requested new components for Item: '{}' already exist in Coordinator.", id).c_str());
+
+        Row row{};
+        if constexpr (internal::has_chunked_storage<Policy>)
+        {
+            const FullRow newRow = MoveItem(id, oldBits, oldBits | requestBits, [id]<typename C>(std::type_identity<C>, void* memory)
+            {
+                return internal::construct_component<C>(memory, id);
+            });
+
+            internal::RowCopy<std::tuple_size_v<Row>, Row, FullRow>(row, newRow);
+        }
+        else
+        {
+            FullRow& item = mItems[id];
+            meta::for_each(row, [this, id, &item]<typename T0>(T0& component)
+            {
+                using CompType = meta::strip_qualifiers_t<T0>;
+                component = FindAllocator<CompType>().Allocate(id);
+                std::get<CompType*>(item) = component;
+            });
+        }
+
+        OnItemChanged(id, oldBits);
+
+        if (initializer)
+        {
+            initializer(id, row);
+        }
     }
 }
 
@@ -360,20 +645,17 @@ template<typename P>
 template<typename R>
 yaget::comp::ItemIds yaget::comp::Coordinator<P>::GetItemIds() const
 {
-    metrics::Channel system("Coordinator.GetItemIds ");
+    metrics::Channel system("Coordinator.GetItemIds");
 
     std::set<yaget::comp::Id_t> results;
 
     PatternSet requestBits = meta::tuple_bit_pattern_v<FullRow, typename R::Row>;
     if (requestBits.any())
     {
-        for (const auto& it : mPatterns)
+        mStorage.ForEachId(requestBits, [&results](comp::Id_t id)
         {
-            if ((it.first & requestBits) == requestBits)
-            {
-                results.insert(it.second.begin(), it.second.end());
-            }
-        }
+            results.insert(id);
+        });
     }
 
     return results;
@@ -399,6 +681,7 @@ template<typename P>
 template<typename T>
 yaget::memory::PoolAllocator<T>& yaget::comp::Coordinator<P>::GetAllocator() const
 {
+    static_assert(!internal::has_chunked_storage<Policy>, "Chunked Coordinator stores components in it's own chunks, there are no allocators.");
     return FindAllocator<T>();
 }
 
@@ -406,7 +689,7 @@ template<typename P>
 template<typename R>
 void yaget::comp::Coordinator<P>::ForEach(const comp::ItemIds& ids, std::function<bool(comp::Id_t id, const typename R::Row& row)> callback) const
 {
-    metrics::Channel system("Coordinator.ForEach ");
+    metrics::Channel system("Coordinator.ForEach");
 
     for (const auto& id : ids)
     {
@@ -427,3 +710,23 @@ std::size_t yaget::comp::Coordinator<P>::ForEach(std::function<bool(comp::Id_t i
 
     return ids.size();
 }
+
+template<typename P>
+template<typename R, typename C>
+std::size_t yaget::comp::Coordinator<P>::ForEachUnordered(C&& callback) const
+{
+    static_assert(std::is_invocable_r_v<bool, C&, comp::Id_t, const typename R::Row&>, "ForEachUnordered callback must be callable as bool(comp::Id_t id, const R::Row& row).");
+
+    const PatternSet requestBits = meta::tuple_bit_pattern_v<FullRow, typename R::Row>;
+    return requestBits.any() ? mStorage.template ForEachRow<R>(requestBits, callback) : 0;
+}
+
+template<typename P>
+template<typename R, typename C>
+std::size_t yaget::comp::Coordinator<P>::ForEachChunk(C&& callback) const
+{
+    static_assert(internal::has_chunked_storage<Policy>, "ForEachChunk requires Coordinator with chunked storage (ChunkedRowPolicy).");
+
+    const PatternSet requestBits = meta::tuple_bit_pattern_v<FullRow, typename R::Row>;
+    return requestBits.any() ? mStorage.template ForEachChunk<R>(requestBits, callback) : 0;
+}
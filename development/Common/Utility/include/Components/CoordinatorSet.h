@@ -18,15 +18,30 @@
 //      If we are going to pass as ref from GameCoordinator to Systems,
 //      then it also may cache previous frame, tick
 //
+//      Each QueryRow used in ForEach gets it's own cache (QueryCache),
+//      dense array of rows sorted by id, which is build on first use and
+//      then updated incrementally from change notifications of Coordinators.
+//
+//      Structural changes done while iterating (from systems) are recorded
+//      into per thread CommandBuffer (Commands()) and applied in one batch
+//      with PlaybackCommands().
+//
 //  #include "Components/CoordinatorSet.h"
 //
 //////////////////////////////////////////////////////////////////////
 //! \file
 #pragma once
 
+#include "Components/CommandBuffer.h"
 #include "Components/Coordinator.h"
 #include "Items/ItemsDirector.h"
+#include <atomic>
 #include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 
 namespace yaget::comp
@@ -175,6 +190,140 @@ namespace yaget::comp
             return std::tuple_size_v<RequestedRow> > 0;
         }
 
+        // Return bit mask of coordinators which provide any of QueryRow components
+        template <typename Coordinators, typename QueryRow>
+        constexpr uint64_t query_coordinators_mask()
+        {
+            static_assert(std::tuple_size_v<Coordinators> <= 64, "Query mask supports up to 64 coordinators");
+
+            uint64_t mask = 0;
+            meta::for_loop<Coordinators>([&mask]<std::size_t T0>()
+            {
+                using CoordinatorPolicy = typename std::tuple_element_t<T0, Coordinators>::Policy;
+                if constexpr (std::tuple_size_v<tuple_get_union_t<QueryRow, typename CoordinatorPolicy::Row>> > 0)
+                {
+                    mask |= static_cast<uint64_t>(1) << T0;
+                }
+            });
+
+            return mask;
+        }
+
+        // Return index of first non global coordinator which provides all of QueryRow components,
+        // or number of coordinators if there is none
+        template <typename Coordinators, typename QueryRow>
+        constexpr std::size_t query_single_coordinator()
+        {
+            std::size_t index = std::tuple_size_v<Coordinators>;
+            meta::for_loop<Coordinators>([&index]<std::size_t T0>()
+            {
+                using CoordinatorPolicy = typename std::tuple_element_t<T0, Coordinators>::Policy;
+                if constexpr (!requires_global_coordinator<CoordinatorPolicy> && std::tuple_size_v<tuple_get_union_t<QueryRow, typename CoordinatorPolicy::Row>> == std::tuple_size_v<QueryRow>)
+                {
+                    index = std::min(index, T0);
+                }
+            });
+
+            return index;
+        }
+
+        // Each QueryRow type gets unique index, used to find it's cache in CoordinatorSet
+        inline std::size_t NextQueryIndex()
+        {
+            static std::atomic<std::size_t> queryCounter{ 0 };
+            return queryCounter++;
+        }
+
+        template <typename QueryRow>
+        std::size_t QueryIndex()
+        {
+            static const std::size_t queryIndex = NextQueryIndex();
+            return queryIndex;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Type erased part of QueryCache, which receives change notifications from coordinators
+        class QueryCacheBase : public Noncopyable<QueryCacheBase>
+        {
+        public:
+            explicit QueryCacheBase(uint64_t coordinatorsMask) : mCoordinatorsMask(coordinatorsMask)
+            {}
+
+            virtual ~QueryCacheBase() = default;
+
+            // coordinatorIndex - which coordinator in CoordinatorSet changed
+            // global - global coordinators are merged into every row, so any change there requires full rebuild
+            void OnChanged(std::size_t coordinatorIndex, comp::Id_t id, bool global)
+            {
+                if (mCoordinatorsMask & (static_cast<uint64_t>(1) << coordinatorIndex))
+                {
+                    std::unique_lock<std::mutex> locker(mMutex);
+                    if (global)
+                    {
+                        mRebuild = true;
+                    }
+                    else if (!mRebuild)
+                    {
+                        // past this point updating rows one by one costs more then rebuilding them
+                        if (mDirtyIds.size() >= mNumRows)
+                        {
+                            mRebuild = true;
+                            mDirtyIds.clear();
+                        }
+                        else
+                        {
+                            mDirtyIds.push_back(id);
+                        }
+                    }
+                }
+            }
+
+            const uint64_t mCoordinatorsMask;
+
+            // guards mDirtyIds, mRebuild, mNumRows and updates to rows of derived cache
+            std::mutex mMutex;
+            std::vector<comp::Id_t> mDirtyIds;
+            bool mRebuild = true;
+            // number of rows in cache after last refresh, bounds size of mDirtyIds
+            std::size_t mNumRows = 0;
+
+            // number of ForEach currently iterating this cache, rows are only updated when there are none
+            std::atomic<int> mIterating{ 0 };
+        };
+
+        //-------------------------------------------------------------------------------------------------
+        // Dense array of rows (sorted by id) for one QueryRow with global items already merged in.
+        template <typename QueryRow>
+        class QueryCache : public QueryCacheBase
+        {
+        public:
+            using QueryCacheBase::QueryCacheBase;
+
+            struct Entry
+            {
+                comp::Id_t mId = comp::INVALID_ID;
+                QueryRow mRow{};
+            };
+
+            using Entries = std::vector<Entry>;
+
+            static bool IdLess(const Entry& entry, comp::Id_t id) { return entry.mId < id; }
+
+            Entries mEntries;
+            Entries mGlobalEntries;
+        };
+
+        // Marks cache as being iterated over for the life of this object
+        class QueryIterationScope : public Noncopyable<QueryIterationScope>
+        {
+        public:
+            explicit QueryIterationScope(QueryCacheBase& query) : mQuery(query) {}
+            ~QueryIterationScope() { --mQuery.mIterating; }
+
+        private:
+            QueryCacheBase& mQuery;
+        };
+
     } // namespace internalc
 
     template <typename... Tuple>
@@ -198,12 +347,33 @@ namespace yaget::comp
         static constexpr size_t NumCoordinators = std::tuple_size_v<std::remove_reference_t<Coordinators>>;
 
         using FullRow = coordinator_row_combine_t<T...>;
+        using CommandBuffer = comp::CommandBuffer<CoordinatorSet>;
         //static_assert(meta::tuple_is_unique_v<FullRow>, "Duplicate element types in CoordinatorSet FullRow");
         const Strings mComponentNames = comp::db::GetPolicyRowNames<FullRow>();
 
         CoordinatorSet(items::Director* director)
             : mDirector(director)
-        {}
+        {
+            meta::for_loop<NumCoordinators>([this]<std::size_t T0>()
+            {
+                using CoordinatorPolicy = typename std::tuple_element_t<T0, Coordinators>::Policy;
+                constexpr bool global = internalc::requires_global_coordinator<CoordinatorPolicy>;
+
+                GetCoordinator<T0>().SetChangeCallback([this](comp::Id_t id)
+                {
+                    OnCoordinatorChanged(T0, id, global);
+                });
+            });
+        }
+
+        ~CoordinatorSet()
+        {
+            // coordinators may still clean up left over items, no need to update queries anymore
+            meta::for_loop<NumCoordinators>([this]<std::size_t T0>()
+            {
+                GetCoordinator<T0>().SetChangeCallback({});
+            });
+        }
 
         // find all rows which contain QueryRow, and call callback for each one
         // return True to keep iterating, otherwise return False to stop
@@ -213,103 +383,88 @@ namespace yaget::comp
         template <typename QueryRow>
         std::size_t ForEach(RowCallback<QueryRow> callback) const
         {
-            constexpr bool usesGlobal = internalc::uses_global_coordinator<Coordinators, QueryRow>();
-
-            // we want to compare QueryRow against each Coordinator::FullRow,
-            // and collect same elements into one tuple type and return that.
-            // with this type we can enumerate over all rows using returned tuple.
-
-            using Items = std::map<comp::Id_t, QueryRow>;
-            Items collectedItems;
-            Items collectedGlobalItem;
-
-            //---------------------------------------------------------------------------------------------
-            // collect global row if coordinator exists
-            if constexpr (usesGlobal)
+            return VisitRows<QueryRow>([&callback](const auto& entries)
             {
-                meta::for_loop<NumCoordinators>([this, &collectedGlobalItem]<std::size_t T0>()
+                std::size_t numProcessedElements = 0;
+                for (const auto& entry : entries)
                 {
-                    constexpr std::size_t coordinatorIndex = T0;
-
-                    using CoordinatorPolicy = typename std::tuple_element_t<coordinatorIndex, Coordinators>::Policy;
-
-                    if constexpr (internalc::requires_global_coordinator<CoordinatorPolicy>)
+                    if (callback(entry.mId, entry.mRow))
                     {
-                        using RequestedRow = tuple_get_union_t<QueryRow, typename CoordinatorPolicy::Row>;
-                        using RequestedRowPolicy = comp::GlobalRowPolicy<RequestedRow>;
-                        
-                        if constexpr (std::tuple_size_v<RequestedRow> > 0)
-                        {
-                            auto& coordinator = GetCoordinator<coordinatorIndex>();
-                            const std::size_t numItems = coordinator.template ForEach<RequestedRowPolicy>([&collectedGlobalItem](comp::Id_t id, const auto& row)
-                            {
-                                internalc::tuple_copy(row, collectedGlobalItem[id]);
-                                return true;
-                            });
-                        }
+                        ++numProcessedElements;
                     }
-                });
-            }
-
-            //---------------------------------------------------------------------------------------------
-            // we need to iterate over each coordinator and collect results
-            meta::for_loop<NumCoordinators>([this, &collectedItems]<std::size_t T0>()
-            {
-                constexpr std::size_t coordinatorIndex = T0;
-
-                using CoordinatorPolicy = typename std::tuple_element_t<coordinatorIndex, Coordinators>::Policy;
-                if constexpr (!internalc::requires_global_coordinator<CoordinatorPolicy>)
-                {
-                    using RequestedRow = tuple_get_union_t<QueryRow, typename CoordinatorPolicy::Row>;
-
-                    if constexpr (std::tuple_size_v<RequestedRow> > 0)
+                    else
                     {
-                        using RequestedRowPolicy = comp::RowPolicy<RequestedRow>;
-
-                        auto& coordinator = GetCoordinator<coordinatorIndex>();
-                        const std::size_t numItems = coordinator.template ForEach<RequestedRowPolicy>([&collectedItems](comp::Id_t id, const auto& row)
-                        {
-                            internalc::tuple_copy(row, collectedItems[id]);
-                            return true;
-                        });
+                        break;
                     }
                 }
+
+                return numProcessedElements;
             });
+        }
 
-            //---------------------------------------------------------------------------------------------
-            // iterate over collected rows and trigger callback
-            std::size_t numProcessedElements = 0;
+        // Dense array of cached rows (sorted by id) for QueryRow, each entry has mId and mRow
+        template <typename QueryRow>
+        using QueryEntries = typename internalc::QueryCache<QueryRow>::Entries;
+
+        // Bring QueryRow cache up to date and call callback(const QueryEntries<QueryRow>& entries) once,
+        // which allows to split rows into batches (for example to process them in parallel).
+        // Entries are valid and will not be changed until callback returns, but components must not be added
+        // or removed by anyone while callback executes on other threads.
+        // Return value of callback.
+        template <typename QueryRow, typename C>
+        auto VisitRows(C&& callback) const
+        {
+            using Query = internalc::QueryCache<QueryRow>;
 
-            if constexpr (usesGlobal)
-            {
-                // only if there is no regular items (collectedItems) and we have ONE global item (collectedGlobalItem)
-                if (collectedItems.empty() && !collectedGlobalItem.empty() && collectedGlobalItem.size() == 1)
-                {
-                    collectedItems = collectedGlobalItem;
-                }
-            }
+            Query& query = GetQuery<QueryRow>();
 
-            for (auto& [id, element] : collectedItems)
+            // rows collected for this call only, used when cached ones are out of date but can not be touched
+            typename Query::Entries snapshotEntries;
+            typename Query::Entries snapshotGlobalEntries;
+            bool useSnapshot = false;
             {
-                auto elementRow = element;
-                if constexpr (usesGlobal)
+                std::unique_lock<std::mutex> locker(query.mMutex);
+                // do not touch rows if someone is already iterating over them (callback calling ForEach with the same QueryRow),
+                // cached rows may point to removed components, so collect current ones instead
+                if (query.mIterating == 0)
                 {
-                    const auto& globalElement = collectedGlobalItem.begin();
-                    // if we do have global elements copy them into parameter before triggering callback
-                    internalc::tuple_copy_if_source(globalElement->second, elementRow);
+                    RefreshQuery(query);
                 }
-
-                if (callback(id, elementRow))
+                else if (query.mRebuild || !query.mDirtyIds.empty())
                 {
-                    ++numProcessedElements;
-                }
-                else
-                {
-                    break;
+                    CollectEntries<QueryRow>(snapshotEntries, snapshotGlobalEntries);
+                    useSnapshot = true;
                 }
+
+                ++query.mIterating;
             }
 
-            return numProcessedElements;
+            internalc::QueryIterationScope iterationScope(query);
+
+            const typename Query::Entries& regularEntries = useSnapshot ? snapshotEntries : query.mEntries;
+            const typename Query::Entries& globalEntries = useSnapshot ? snapshotGlobalEntries : query.mGlobalEntries;
+
+            // only if there is no regular items and we have ONE global item
+            const typename Query::Entries& entries = regularEntries.empty() && globalEntries.size() == 1 ? globalEntries : regularEntries;
+            return callback(entries);
+        }
+
+        // Iterate over packed component columns of QueryRow, all of which must be stored in one chunked coordinator.
+        // callback(std::span<const comp::Id_t> ids, const QueryRow& columns) is called for each chunk, where each
+        // element of columns points to first component of contiguous column and index i in every column belongs to ids[i].
+        // Chunks are visited in storage order (not sorted by id) and no query cache is used.
+        // Components must not be added or removed by anyone while callback executes.
+        // Return number of visited rows.
+        template <typename QueryRow, typename C>
+        std::size_t ForEachChunk(C&& callback) const
+        {
+            constexpr std::size_t coordinatorIndex = internalc::query_single_coordinator<Coordinators, QueryRow>();
+            static_assert(coordinatorIndex < NumCoordinators, "ForEachChunk requires all of QueryRow components to be in one non global coordinator.");
+
+            using CoordinatorPolicy = typename std::tuple_element_t<coordinatorIndex, Coordinators>::Policy;
+            static_assert(internal::has_chunked_storage<CoordinatorPolicy>, "ForEachChunk requires coordinator with chunked storage (ChunkedRowPolicy).");
+
+            return GetCoordinator<coordinatorIndex>().template ForEachChunk<comp::RowPolicy<QueryRow>>(std::forward<C>(callback));
         }
 
         template <typename C>
@@ -444,6 +599,180 @@ namespace yaget::comp
             return result;
         }
 
+        //-------------------------------------------------------------------------------------------------
+        // Remove all components of items in ids, from every coordinator that has them
+        void RemoveItems(const comp::ItemIds& ids)
+        {
+            meta::for_loop<NumCoordinators>([this, &ids]<std::size_t T0>()
+            {
+                auto& coordinator = GetCoordinator<T0>();
+                using CoordinatorRow = typename std::remove_reference_t<decltype(coordinator)>::FullRow;
+
+                comp::ItemIds coordinatorIds;
+                for (const auto& id : ids)
+                {
+                    if (coordinator.FindItem(id) != CoordinatorRow{})
+                    {
+                        coordinatorIds.insert(id);
+                    }
+                }
+
+                coordinator.RemoveItems(coordinatorIds);
+            });
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Create all components of R (RowPolicy) for each item in ids, in every coordinator which
+        // has any of R components. None of those components can exist yet.
+        // Optional initializer is called for each new item with all of it's R components created.
+        // When all of R components live in one coordinator, initializer is passed to it's AddItems,
+        // otherwise row is collected from all coordinators after they added their components.
+        template <typename R>
+        void AddItems(const comp::ItemIds& ids, const std::function<void(comp::Id_t id, const typename R::Row& row)>& initializer = {})
+        {
+            using Row = typename R::Row;
+            constexpr std::size_t singleCoordinator = internalc::query_single_coordinator<Coordinators, Row>();
+
+            meta::for_loop<NumCoordinators>([this, &ids, &initializer]<std::size_t T0>()
+            {
+                using CoordinatorPolicy = typename std::tuple_element_t<T0, Coordinators>::Policy;
+                using RequestedRow = tuple_get_union_t<Row, typename CoordinatorPolicy::Row>;
+
+                if constexpr (std::tuple_size_v<RequestedRow> > 0)
+                {
+                    auto& coordinator = GetCoordinator<T0>();
+                    if (T0 == singleCoordinator && initializer)
+                    {
+                        coordinator.template AddItems<comp::RowPolicy<RequestedRow>>(ids, [&initializer](comp::Id_t id, const RequestedRow& row)
+                        {
+                            // same components as Row, possibly in different order
+                            Row itemRow{};
+                            internalc::tuple_copy(row, itemRow);
+                            initializer(id, itemRow);
+                        });
+                    }
+                    else
+                    {
+                        coordinator.template AddItems<comp::RowPolicy<RequestedRow>>(ids);
+                    }
+                }
+            });
+
+            if constexpr (singleCoordinator == NumCoordinators)
+            {
+                if (initializer)
+                {
+                    for (const auto& id : ids)
+                    {
+                        Row itemRow{};
+                        CollectItem(id, itemRow);
+                        initializer(id, itemRow);
+                    }
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Remove all items from all coordinators
+        void Clear()
+        {
+            meta::for_loop<NumCoordinators>([this]<std::size_t T0>()
+            {
+                GetCoordinator<T0>().Clear();
+            });
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Give memory of empty pool lines back from all coordinators, see Coordinator::ReleaseMemory.
+        // Return number of released lines.
+        std::size_t ReleaseMemory(std::size_t keepFreeSlots = 0)
+        {
+            std::size_t numReleased = 0;
+            meta::for_loop<NumCoordinators>([this, &numReleased, keepFreeSlots]<std::size_t T0>()
+            {
+                numReleased += GetCoordinator<T0>().ReleaseMemory(keepFreeSlots);
+            });
+
+            return numReleased;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Command buffer for calling thread, to defer adding/removing of components while iterating.
+        // Lookup is guarded by lock, fetch it once per update batch rather then per item.
+        // Buffer is only valid until next PlaybackCommands, which recycles it for any thread.
+        CommandBuffer& Commands()
+        {
+            const auto threadId = std::this_thread::get_id();
+
+            std::unique_lock<std::mutex> locker(mCommandsMutex);
+            auto& commandBuffer = mCommandBuffers[threadId];
+            if (!commandBuffer)
+            {
+                if (mFreeCommandBuffers.empty())
+                {
+                    commandBuffer = std::make_unique<CommandBuffer>();
+                }
+                else
+                {
+                    commandBuffer = std::move(mFreeCommandBuffers.back());
+                    mFreeCommandBuffers.pop_back();
+                }
+            }
+
+            return *commandBuffer;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Apply recorded commands of all threads in one batch, where each item moves between patterns
+        // and updates cached queries once. Commands of one thread are applied in recorded order, but there is
+        // no order between threads. No one can iterate or record commands while this executes.
+        // Return number of commands executed.
+        std::size_t PlaybackCommands()
+        {
+            bool hasCommands = false;
+            {
+                // threads get buffer from free list on next Commands() call, so only threads
+                // which recorded since last playback have entry and one buffer exist per concurrently recording thread
+                std::unique_lock<std::mutex> locker(mCommandsMutex);
+                for (auto& [threadId, commandBuffer] : mCommandBuffers)
+                {
+                    hasCommands = hasCommands || !commandBuffer->IsEmpty();
+                    mPlaybackCommandBuffers.push_back(std::move(commandBuffer));
+                }
+
+                mCommandBuffers.clear();
+            }
+
+            // ends changes and recycles buffers even if command throws, so already applied commands
+            // update patterns and queries and next playback starts clean
+            struct PlaybackGuard
+            {
+                ~PlaybackGuard() { mCoordinatorSet.EndPlayback(mChangesBegun); }
+                CoordinatorSet& mCoordinatorSet;
+                bool mChangesBegun = false;
+            } playbackGuard{ *this };
+
+            std::size_t numCommands = 0;
+            if (hasCommands)
+            {
+                metrics::Channel channel(YAGET_TRACE_NAME("CoordinatorSet.PlaybackCommands"));
+
+                meta::for_loop<NumCoordinators>([this]<std::size_t T0>()
+                {
+                    GetCoordinator<T0>().BeginChanges();
+                });
+                playbackGuard.mChangesBegun = true;
+
+                // commands recorded while playing back (from component constructors) go into other buffers, part of next playback
+                for (auto& commandBuffer : mPlaybackCommandBuffers)
+                {
+                    numCommands += commandBuffer->Playback(*this);
+                }
+            }
+
+            return numCommands;
+        }
+
         //-------------------------------------------------------------------------------------------------
         template <typename TT = FullRow>
         TT LoadItem(comp::Id_t id)
@@ -460,7 +789,311 @@ namespace yaget::comp
         }
 
     private:
+        //-------------------------------------------------------------------------------------------------
+        // Return cache for QueryRow, creating one if needed
+        template <typename QueryRow>
+        internalc::QueryCache<QueryRow>& GetQuery() const
+        {
+            using Query = internalc::QueryCache<QueryRow>;
+
+            const std::size_t queryIndex = internalc::QueryIndex<QueryRow>();
+
+            std::unique_lock<std::mutex> locker(mQueriesMutex);
+            if (queryIndex >= mQueries.size())
+            {
+                mQueries.resize(queryIndex + 1);
+            }
+
+            auto& query = mQueries[queryIndex];
+            if (!query)
+            {
+                query = std::make_unique<Query>(internalc::query_coordinators_mask<Coordinators, QueryRow>());
+            }
+
+            return static_cast<Query&>(*query);
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Finish PlaybackCommands, buffers which did not play back (earlier one threw) drop their commands
+        void EndPlayback(bool endChanges)
+        {
+            if (endChanges)
+            {
+                meta::for_loop<NumCoordinators>([this]<std::size_t T0>()
+                {
+                    GetCoordinator<T0>().EndChanges();
+                });
+            }
+
+            std::unique_lock<std::mutex> locker(mCommandsMutex);
+            for (auto& commandBuffer : mPlaybackCommandBuffers)
+            {
+                commandBuffer->Clear();
+                mFreeCommandBuffers.push_back(std::move(commandBuffer));
+            }
+
+            mPlaybackCommandBuffers.clear();
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        void OnCoordinatorChanged(std::size_t coordinatorIndex, comp::Id_t id, bool global)
+        {
+            std::unique_lock<std::mutex> locker(mQueriesMutex);
+            for (auto& query : mQueries)
+            {
+                if (query)
+                {
+                    query->OnChanged(coordinatorIndex, id, global);
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Bring query rows up to date, called with query mutex locked and no one iterating
+        template <typename QueryRow>
+        void RefreshQuery(internalc::QueryCache<QueryRow>& query) const
+        {
+            using Query = internalc::QueryCache<QueryRow>;
+
+            if (query.mRebuild)
+            {
+                metrics::Channel channel(YAGET_TRACE_NAME("CoordinatorSet.RebuildQuery"));
+
+                CollectEntries<QueryRow>(query.mEntries, query.mGlobalEntries);
+
+                query.mRebuild = false;
+                query.mDirtyIds.clear();
+                query.mNumRows = query.mEntries.size();
+            }
+            else if (!query.mDirtyIds.empty())
+            {
+                metrics::Channel channel(YAGET_TRACE_NAME("CoordinatorSet.UpdateQuery"));
+
+                auto& dirtyIds = query.mDirtyIds;
+                std::sort(dirtyIds.begin(), dirtyIds.end());
+                dirtyIds.erase(std::unique(dirtyIds.begin(), dirtyIds.end()), dirtyIds.end());
+
+                typename Query::Entries insertedEntries;
+                std::vector<comp::Id_t> removedIds;
+
+                for (const auto& id : dirtyIds)
+                {
+                    QueryRow row{};
+                    const bool found = CollectItem<QueryRow>(id, row);
+
+                    auto it = std::lower_bound(query.mEntries.begin(), query.mEntries.end(), id, &Query::IdLess);
+                    const bool exists = it != query.mEntries.end() && it->mId == id;
+
+                    if (found)
+                    {
+                        MergeGlobalItem(query.mGlobalEntries, row);
+                        if (exists)
+                        {
+                            it->mRow = row;
+                        }
+                        else
+                        {
+                            insertedEntries.push_back({ id, row });
+                        }
+                    }
+                    else if (exists)
+                    {
+                        removedIds.push_back(id);
+                    }
+                }
+
+                // dirtyIds are sorted, so removedIds and insertedEntries are too
+                if (!removedIds.empty())
+                {
+                    std::erase_if(query.mEntries, [&removedIds](const auto& entry)
+                    {
+                        return std::binary_search(removedIds.begin(), removedIds.end(), entry.mId);
+                    });
+                }
+
+                if (!insertedEntries.empty())
+                {
+                    const auto numEntries = query.mEntries.size();
+                    query.mEntries.insert(query.mEntries.end(), insertedEntries.begin(), insertedEntries.end());
+                    std::inplace_merge(query.mEntries.begin(), query.mEntries.begin() + numEntries, query.mEntries.end(), [](const auto& lh, const auto& rh)
+                    {
+                        return lh.mId < rh.mId;
+                    });
+                }
+
+                dirtyIds.clear();
+                query.mNumRows = query.mEntries.size();
+            }
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Collect all current rows (sorted by id) for QueryRow with global item merged in
+        template <typename QueryRow>
+        void CollectEntries(QueryEntries<QueryRow>& entries, QueryEntries<QueryRow>& globalEntries) const
+        {
+            globalEntries = CollectGlobalItems<QueryRow>();
+
+            std::map<comp::Id_t, QueryRow> collectedItems;
+            CollectItems<QueryRow>(collectedItems);
+
+            entries.clear();
+            entries.reserve(collectedItems.size());
+            for (auto& [id, row] : collectedItems)
+            {
+                MergeGlobalItem(globalEntries, row);
+                entries.push_back({ id, row });
+            }
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // if we do have global elements copy them into row
+        template <typename QueryRow>
+        static void MergeGlobalItem(const QueryEntries<QueryRow>& globalEntries, QueryRow& row)
+        {
+            if constexpr (internalc::uses_global_coordinator<Coordinators, QueryRow>())
+            {
+                if (!globalEntries.empty())
+                {
+                    internalc::tuple_copy_if_source(globalEntries.front().mRow, row);
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // collect global rows (sorted by id) if coordinator exists
+        template <typename QueryRow>
+        typename internalc::QueryCache<QueryRow>::Entries CollectGlobalItems() const
+        {
+            std::map<comp::Id_t, QueryRow> collectedGlobalItem;
+
+            if constexpr (internalc::uses_global_coordinator<Coordinators, QueryRow>())
+            {
+                meta::for_loop<NumCoordinators>([this, &collectedGlobalItem]<std::size_t T0>()
+                {
+                    constexpr std::size_t coordinatorIndex = T0;
+
+                    using CoordinatorPolicy = typename std::tuple_element_t<coordinatorIndex, Coordinators>::Policy;
+
+                    if constexpr (internalc::requires_global_coordinator<CoordinatorPolicy>)
+                    {
+                        using RequestedRow = tuple_get_union_t<QueryRow, typename CoordinatorPolicy::Row>;
+                        using RequestedRowPolicy = comp::GlobalRowPolicy<RequestedRow>;
+
+                        if constexpr (std::tuple_size_v<RequestedRow> > 0)
+                        {
+                            auto& coordinator = GetCoordinator<coordinatorIndex>();
+                            coordinator.template ForEachUnordered<RequestedRowPolicy>([&collectedGlobalItem](comp::Id_t id, const auto& row)
+                            {
+                                internalc::tuple_copy(row, collectedGlobalItem[id]);
+                                return true;
+                            });
+                        }
+                    }
+                });
+            }
+
+            typename internalc::QueryCache<QueryRow>::Entries globalEntries;
+            for (const auto& [id, row] : collectedGlobalItem)
+            {
+                globalEntries.push_back({ id, row });
+            }
+
+            return globalEntries;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // we need to iterate over each non global coordinator and collect results
+        template <typename QueryRow>
+        void CollectItems(std::map<comp::Id_t, QueryRow>& collectedItems) const
+        {
+            meta::for_loop<NumCoordinators>([this, &collectedItems]<std::size_t T0>()
+            {
+                constexpr std::size_t coordinatorIndex = T0;
+
+                using CoordinatorPolicy = typename std::tuple_element_t<coordinatorIndex, Coordinators>::Policy;
+                if constexpr (!internalc::requires_global_coordinator<CoordinatorPolicy>)
+                {
+                    using RequestedRow = tuple_get_union_t<QueryRow, typename CoordinatorPolicy::Row>;
+
+                    if constexpr (std::tuple_size_v<RequestedRow> > 0)
+                    {
+                        using RequestedRowPolicy = comp::RowPolicy<RequestedRow>;
+
+                        auto& coordinator = GetCoordinator<coordinatorIndex>();
+                        coordinator.template ForEachUnordered<RequestedRowPolicy>([&collectedItems](comp::Id_t id, const auto& row)
+                        {
+                            internalc::tuple_copy(row, collectedItems[id]);
+                            return true;
+                        });
+                    }
+                }
+            });
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Same as CollectItems but only for one item, return true if any of coordinators matched
+        template <typename QueryRow>
+        bool CollectItem(comp::Id_t id, QueryRow& collectedRow) const
+        {
+            bool found = false;
+
+            meta::for_loop<NumCoordinators>([this, id, &collectedRow, &found]<std::size_t T0>()
+            {
+                constexpr std::size_t coordinatorIndex = T0;
+
+                using CoordinatorPolicy = typename std::tuple_element_t<coordinatorIndex, Coordinators>::Policy;
+                if constexpr (!internalc::requires_global_coordinator<CoordinatorPolicy>)
+                {
+                    using RequestedRow = tuple_get_union_t<QueryRow, typename CoordinatorPolicy::Row>;
+
+                    if constexpr (std::tuple_size_v<RequestedRow> > 0)
+                    {
+                        using RequestedRowPolicy = comp::RowPolicy<RequestedRow>;
+
+                        auto& coordinator = GetCoordinator<coordinatorIndex>();
+                        const auto row = coordinator.template FindItem<RequestedRowPolicy>(id);
+
+                        bool hasAll = true;
+                        meta::for_each(row, [&hasAll](const auto& component)
+                        {
+                            hasAll = hasAll && component != nullptr;
+                        });
+
+                        if (hasAll)
+                        {
+                            internalc::tuple_copy(row, collectedRow);
+                            found = true;
+                        }
+                    }
+                }
+            });
+
+            return found;
+        }
+
         //-------------------------------------------------------------------------------------------------
+        template <typename C>
+        constexpr void FindMatchCoordinator(auto callback)
+        {
+            bool coordinatorFound = false;
+
+            meta::for_loop<NumCoordinators>([&]<std::size_t T0>()
+            {
+                constexpr std::size_t coordinatorIndex = T0;
+
+                if (!coordinatorFound)
+                {
+                    if constexpr (internalc::IsCoordinatorHasPolicy<C, Coordinators, coordinatorIndex>())
+                    {
+                        auto& coordinator = GetCoordinator<coordinatorIndex>();
+                        callback(&coordinator);
+
+                        coordinatorFound = true;
+                    }
+                }
+            });
+        }
+
         template <typename C>
         constexpr void FindMatchCoordinator(auto callback) const
         {
@@ -485,5 +1118,16 @@ namespace yaget::comp
         
         Coordinators mCoordinators;
         items::Director* mDirector{};
+
+        // cached rows per QueryRow type, indexed by internalc::QueryIndex<QueryRow>()
+        mutable std::mutex mQueriesMutex;
+        mutable std::vector<std::unique_ptr<internalc::QueryCacheBase>> mQueries;
+
+        // buffers of deferred changes for threads which recorded since last playback,
+        // played back buffers are recycled trough free list
+        std::mutex mCommandsMutex;
+        std::unordered_map<std::thread::id, std::unique_ptr<CommandBuffer>> mCommandBuffers;
+        std::vector<std::unique_ptr<CommandBuffer>> mPlaybackCommandBuffers;
+        std::vector<std::unique_ptr<CommandBuffer>> mFreeCommandBuffers;
     };
 }
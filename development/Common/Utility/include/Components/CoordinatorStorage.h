@@ -0,0 +1,576 @@
+//////////////////////////////////////////////////////////////////////
+// CoordinatorStorage.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Pattern storage used by Coordinator to keep track which items
+//      have which set of components (pattern).
+//      PatternStorage - dense arrays of item id's and their rows per pattern (default)
+//      ChunkStorage   - archetype storage, owns components by value in fixed size
+//                       chunks per pattern, where each component type is packed
+//                       in it's own contiguous column (SoA).
+//                       Selected by RowPolicy declaring 'using Chunked = bool;'
+//
+//      With PatternStorage components are owned by PoolAllocator and never move.
+//      ChunkStorage moves components when item changes pattern or another item
+//      is removed, so components must be nothrow move constructible and pointers
+//      are only valid until next add/remove on the same Coordinator.
+//
+//  #include "Components/CoordinatorStorage.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+#pragma once
+
+#include "Components/ComponentTypes.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <new>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+
+namespace yaget::comp::internal
+{
+    // compile time switch to use archetype chunk storage for items of this policy
+    template<typename T>
+    concept has_chunked_storage = requires { typename T::Chunked; };
+
+    // alignment needed by chunk memory to hold item id's and any of the row components
+    template <typename Row>
+    struct row_alignment;
+
+    template <typename... T>
+    struct row_alignment<std::tuple<T...>>
+    {
+        static constexpr std::size_t value = std::max({ alignof(comp::Id_t), alignof(std::remove_pointer_t<T>)... });
+    };
+
+    // true if all components of a row can be moved to a new chunk without throwing
+    template <typename Row>
+    struct row_relocatable;
+
+    template <typename... T>
+    struct row_relocatable<std::tuple<T...>> : std::conjunction<std::is_nothrow_move_constructible<std::remove_pointer_t<T>>...>
+    {};
+
+    // Construct component in memory the same way PoolAllocator does, T(args...) if such constructor exist,
+    // otherwise value initialized T{}
+    template <typename T, typename... Args>
+    T* construct_component(void* memory, Args&&... args)
+    {
+        if constexpr (std::is_constructible_v<T, Args...>)
+        {
+            return new(memory) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            (static_cast<void>(args), ...);
+            return new(memory) T{};
+        }
+    }
+
+    // build Row (subset of full row) from any source where getter(type_identity<T>) returns T
+    template <typename Row, typename G, std::size_t... I>
+    Row make_row(G&& getter, std::index_sequence<I...>)
+    {
+        return Row{ getter(std::type_identity<std::tuple_element_t<I, Row>>{})... };
+    }
+
+    template <typename Row, typename G>
+    Row make_row(G&& getter)
+    {
+        return make_row<Row>(std::forward<G>(getter), std::make_index_sequence<std::tuple_size_v<Row>>{});
+    }
+
+
+    //-------------------------------------------------------------------------------------------------
+    // Default storage, each pattern keeps dense arrays of item id's and copies of their rows,
+    // so iteration does not need to go back to Coordinator items collection.
+    // Removing item will swap last item into it's place, so iteration order is not sorted by id.
+    template <typename FullRow, typename PatternSet>
+    class PatternStorage
+    {
+    public:
+        void Insert(const PatternSet& pattern, comp::Id_t id, const FullRow& row)
+        {
+            Items& items = mPatterns[pattern];
+
+            auto [it, inserted] = mSlots.try_emplace(id, items.mIds.size());
+            if (inserted)
+            {
+                items.mIds.push_back(id);
+                items.mRows.push_back(row);
+            }
+            else
+            {
+                items.mRows[it->second] = row;
+            }
+        }
+
+        void Erase(const PatternSet& pattern, comp::Id_t id)
+        {
+            auto it = mPatterns.find(pattern);
+            auto slotIt = mSlots.find(id);
+            if (it == mPatterns.end() || slotIt == mSlots.end())
+            {
+                return;
+            }
+
+            Items& items = it->second;
+            const std::size_t slot = slotIt->second;
+            const std::size_t lastSlot = items.mIds.size() - 1;
+
+            if (slot != lastSlot)
+            {
+                const comp::Id_t movedId = items.mIds[lastSlot];
+                items.mIds[slot] = movedId;
+                items.mRows[slot] = items.mRows[lastSlot];
+                mSlots[movedId] = slot;
+            }
+
+            // we keep empty patterns around, items tend to cycle trough the same patterns
+            items.mIds.pop_back();
+            items.mRows.pop_back();
+            mSlots.erase(slotIt);
+        }
+
+        // callback(comp::Id_t id) for each item which contains all requestBits
+        template <typename C>
+        void ForEachId(const PatternSet& requestBits, C&& callback) const
+        {
+            for (const auto& [pattern, items] : mPatterns)
+            {
+                if ((pattern & requestBits) == requestBits)
+                {
+                    for (const auto& id : items.mIds)
+                    {
+                        callback(id);
+                    }
+                }
+            }
+        }
+
+        // Iterate over rows (R::Row) which contains all requestBits.
+        // callback(comp::Id_t id, const R::Row& row) return false to stop iteration.
+        // Return number of items passed to callback.
+        template <typename R, typename C>
+        std::size_t ForEachRow(const PatternSet& requestBits, C&& callback) const
+        {
+            using Row = typename R::Row;
+
+            std::size_t numItems = 0;
+            for (const auto& [pattern, items] : mPatterns)
+            {
+                if ((pattern & requestBits) != requestBits)
+                {
+                    continue;
+                }
+
+                const std::size_t numRows = items.mIds.size();
+                for (std::size_t i = 0; i < numRows; ++i)
+                {
+                    const FullRow& fullRow = items.mRows[i];
+                    const Row row = make_row<Row>([&fullRow]<typename T>(std::type_identity<T>) { return std::get<T>(fullRow); });
+
+                    ++numItems;
+                    if (!callback(items.mIds[i], row))
+                    {
+                        return numItems;
+                    }
+                }
+            }
+
+            return numItems;
+        }
+
+    private:
+        // mIds[i] is item of mRows[i]
+        struct Items
+        {
+            std::vector<comp::Id_t> mIds;
+            std::vector<FullRow> mRows;
+        };
+
+        std::unordered_map<PatternSet, Items> mPatterns;
+        // item id to slot index in it's current pattern
+        std::unordered_map<comp::Id_t, std::size_t> mSlots;
+    };
+
+
+    //-------------------------------------------------------------------------------------------------
+    // Archetype storage, owns components of items by value. Items of each pattern live in fixed size chunks,
+    // where chunk has array of item id's followed by a contiguous column per component type of that pattern.
+    // Changing item pattern moves it's components to chunk of the new pattern, and removed item
+    // is replaced by last item of it's pattern (swap remove), so iteration order is not sorted by id.
+    template <typename FullRow, typename PatternSet>
+    class ChunkStorage : public Noncopyable<ChunkStorage<FullRow, PatternSet>>
+    {
+        static_assert(row_relocatable<FullRow>::value, "ChunkStorage moves components between chunks, each component must be nothrow move constructible.");
+
+        template <std::size_t I>
+        using Component = std::remove_pointer_t<std::tuple_element_t<I, FullRow>>;
+
+    public:
+        // target size of one chunk in bytes, which is rounded up to fit at least one item
+        static constexpr std::size_t ChunkSize = 16 * 1024;
+        static constexpr std::size_t Alignment = row_alignment<FullRow>::value;
+        static constexpr std::size_t NumComponents = std::tuple_size_v<FullRow>;
+
+        ChunkStorage() = default;
+
+        ~ChunkStorage()
+        {
+            for (auto& [pattern, archetype] : mArchetypes)
+            {
+                for (std::size_t index = 0; index < archetype.mNumItems; ++index)
+                {
+                    DestroyComponents(archetype, index, archetype.mPattern);
+                }
+
+                FreeChunks(archetype, 0);
+            }
+        }
+
+        // Move item id from oldPattern to newPattern, where empty oldPattern adds new item and empty newPattern removes it.
+        // Components in both patterns are moved, components only in oldPattern are destroyed and ones only in newPattern
+        // are created with construct(std::type_identity<T>, void* memory) which returns T*. If construct throws,
+        // item is left unchanged.
+        // Item moved into old place of id is reported with relocated(comp::Id_t movedId, const FullRow& movedRow).
+        // Return new row of id.
+        template <typename C, typename M>
+        FullRow Move(comp::Id_t id, const PatternSet& oldPattern, const PatternSet& newPattern, C&& construct, M&& relocated)
+        {
+            Slot oldSlot{};
+            if (oldPattern.any())
+            {
+                auto it = mSlots.find(id);
+                YAGET_ASSERT(it != mSlots.end(), "Item id: '%d' does not exist in chunk storage.", id);
+                oldSlot = it->second;
+            }
+
+            FullRow newRow{};
+            if (newPattern.any())
+            {
+                Archetype& archetype = GetArchetype(newPattern);
+                const std::size_t index = AddSlot(archetype);
+
+                // create new components first, so nothing is changed yet if any of them throws
+                try
+                {
+                    meta::for_loop<FullRow>([&]<std::size_t T0>()
+                    {
+                        if (newPattern.test(T0) && !oldPattern.test(T0))
+                        {
+                            std::get<T0>(newRow) = construct(std::type_identity<Component<T0>>{}, GetComponent<T0>(archetype, index));
+                        }
+                    });
+                }
+                catch (...)
+                {
+                    meta::for_loop<FullRow>([&newRow]<std::size_t T0>()
+                    {
+                        if (std::get<T0>(newRow))
+                        {
+                            std::destroy_at(std::get<T0>(newRow));
+                        }
+                    });
+
+                    --archetype.mNumItems;
+                    throw;
+                }
+
+                if (oldPattern.any())
+                {
+                    meta::for_loop<FullRow>([&]<std::size_t T0>()
+                    {
+                        if (newPattern.test(T0) && oldPattern.test(T0))
+                        {
+                            std::get<T0>(newRow) = MoveComponent<T0>(*oldSlot.mArchetype, oldSlot.mIndex, archetype, index);
+                        }
+                    });
+                }
+
+                GetIds(archetype, index)[0] = id;
+                mSlots[id] = { &archetype, index };
+            }
+
+            if (oldPattern.any())
+            {
+                DestroyComponents(*oldSlot.mArchetype, oldSlot.mIndex, oldPattern & ~newPattern);
+                if (newPattern.none())
+                {
+                    mSlots.erase(id);
+                }
+
+                RemoveSlot(*oldSlot.mArchetype, oldSlot.mIndex, relocated);
+            }
+
+            return newRow;
+        }
+
+        // callback(comp::Id_t id) for each item which contains all requestBits
+        template <typename C>
+        void ForEachId(const PatternSet& requestBits, C&& callback) const
+        {
+            for (const auto& [pattern, archetype] : mArchetypes)
+            {
+                if ((pattern & requestBits) == requestBits)
+                {
+                    for (std::size_t begin = 0; begin < archetype.mNumItems; begin += archetype.mCapacity)
+                    {
+                        const comp::Id_t* ids = GetIds(archetype, begin);
+                        const std::size_t numRows = std::min(archetype.mCapacity, archetype.mNumItems - begin);
+                        for (std::size_t i = 0; i < numRows; ++i)
+                        {
+                            callback(ids[i]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Iterate over rows (R::Row) which contains all requestBits, reading components directly
+        // from chunk columns. callback(comp::Id_t id, const R::Row& row) return false to stop iteration.
+        // Return number of items passed to callback.
+        template <typename R, typename C>
+        std::size_t ForEachRow(const PatternSet& requestBits, C&& callback) const
+        {
+            using Row = typename R::Row;
+
+            std::size_t numItems = 0;
+            for (const auto& [pattern, archetype] : mArchetypes)
+            {
+                if ((pattern & requestBits) != requestBits)
+                {
+                    continue;
+                }
+
+                for (std::size_t begin = 0; begin < archetype.mNumItems; begin += archetype.mCapacity)
+                {
+                    const comp::Id_t* ids = GetIds(archetype, begin);
+                    const Row columns = make_row<Row>([this, &archetype, begin]<typename T>(std::type_identity<T>)
+                    {
+                        return GetComponent<meta::Index<T, FullRow>::value>(archetype, begin);
+                    });
+
+                    const std::size_t numRows = std::min(archetype.mCapacity, archetype.mNumItems - begin);
+                    for (std::size_t i = 0; i < numRows; ++i)
+                    {
+                        const Row row = make_row<Row>([&columns, i]<typename T>(std::type_identity<T>) { return std::get<T>(columns) + i; });
+
+                        ++numItems;
+                        if (!callback(ids[i], row))
+                        {
+                            return numItems;
+                        }
+                    }
+                }
+            }
+
+            return numItems;
+        }
+
+        // Iterate over chunks of items which contains all requestBits.
+        // callback(std::span<const comp::Id_t> ids, const R::Row& columns) where each element of columns points
+        // to first component of it's column in chunk, and index i in every column belongs to ids[i].
+        // Return number of items in all visited chunks.
+        template <typename R, typename C>
+        std::size_t ForEachChunk(const PatternSet& requestBits, C&& callback) const
+        {
+            using Row = typename R::Row;
+
+            std::size_t numItems = 0;
+            for (const auto& [pattern, archetype] : mArchetypes)
+            {
+                if ((pattern & requestBits) != requestBits)
+                {
+                    continue;
+                }
+
+                for (std::size_t begin = 0; begin < archetype.mNumItems; begin += archetype.mCapacity)
+                {
+                    const std::size_t numRows = std::min(archetype.mCapacity, archetype.mNumItems - begin);
+                    const Row columns = make_row<Row>([this, &archetype, begin]<typename T>(std::type_identity<T>)
+                    {
+                        return GetComponent<meta::Index<T, FullRow>::value>(archetype, begin);
+                    });
+
+                    callback(std::span<const comp::Id_t>(GetIds(archetype, begin), numRows), columns);
+                    numItems += numRows;
+                }
+            }
+
+            return numItems;
+        }
+
+        // Free chunks left empty after items were removed, keeping enough of them for keepFreeSlots items per pattern.
+        // Return number of released chunks.
+        std::size_t ReleaseMemory(std::size_t keepFreeSlots)
+        {
+            std::size_t numReleased = 0;
+            for (auto& [pattern, archetype] : mArchetypes)
+            {
+                const std::size_t numNeeded = (archetype.mNumItems + keepFreeSlots + archetype.mCapacity - 1) / archetype.mCapacity;
+                numReleased += FreeChunks(archetype, numNeeded);
+            }
+
+            return numReleased;
+        }
+
+    private:
+        // we keep empty archetypes around, items tend to cycle trough the same patterns
+        struct Archetype
+        {
+            PatternSet mPattern;
+            // number of items per chunk
+            std::size_t mCapacity = 0;
+            std::size_t mChunkBytes = 0;
+            std::size_t mNumItems = 0;
+            // offset of each component column from start of chunk, item id's are at 0
+            std::array<std::size_t, NumComponents> mOffsets{};
+            std::vector<std::byte*> mChunks;
+        };
+
+        // item location in it's current Archetype
+        struct Slot
+        {
+            Archetype* mArchetype = nullptr;
+            std::size_t mIndex = 0;
+        };
+
+        Archetype& GetArchetype(const PatternSet& pattern)
+        {
+            auto [it, inserted] = mArchetypes.try_emplace(pattern);
+            Archetype& archetype = it->second;
+            if (inserted)
+            {
+                std::size_t rowBytes = sizeof(comp::Id_t);
+                meta::for_loop<FullRow>([&pattern, &rowBytes]<std::size_t T0>()
+                {
+                    if (pattern.test(T0))
+                    {
+                        rowBytes += sizeof(Component<T0>);
+                    }
+                });
+
+                archetype.mPattern = pattern;
+                archetype.mCapacity = std::max<std::size_t>(ChunkSize / rowBytes, 1);
+
+                std::size_t offset = sizeof(comp::Id_t) * archetype.mCapacity;
+                meta::for_loop<FullRow>([&pattern, &archetype, &offset]<std::size_t T0>()
+                {
+                    if (pattern.test(T0))
+                    {
+                        constexpr std::size_t alignment = alignof(Component<T0>);
+                        offset = (offset + alignment - 1) / alignment * alignment;
+                        archetype.mOffsets[T0] = offset;
+                        offset += sizeof(Component<T0>) * archetype.mCapacity;
+                    }
+                });
+
+                archetype.mChunkBytes = offset;
+            }
+
+            return archetype;
+        }
+
+        comp::Id_t* GetIds(const Archetype& archetype, std::size_t index) const
+        {
+            std::byte* chunk = archetype.mChunks[index / archetype.mCapacity];
+            return reinterpret_cast<comp::Id_t*>(chunk) + index % archetype.mCapacity;
+        }
+
+        template <std::size_t I>
+        Component<I>* GetComponent(const Archetype& archetype, std::size_t index) const
+        {
+            std::byte* chunk = archetype.mChunks[index / archetype.mCapacity];
+            return reinterpret_cast<Component<I>*>(chunk + archetype.mOffsets[I]) + index % archetype.mCapacity;
+        }
+
+        template <std::size_t I>
+        Component<I>* MoveComponent(const Archetype& from, std::size_t fromIndex, const Archetype& to, std::size_t toIndex)
+        {
+            Component<I>* source = GetComponent<I>(from, fromIndex);
+            Component<I>* target = new(GetComponent<I>(to, toIndex)) Component<I>(std::move(*source));
+            std::destroy_at(source);
+            return target;
+        }
+
+        void DestroyComponents(const Archetype& archetype, std::size_t index, const PatternSet& pattern)
+        {
+            meta::for_loop<FullRow>([this, &archetype, index, &pattern]<std::size_t T0>()
+            {
+                if (pattern.test(T0))
+                {
+                    std::destroy_at(GetComponent<T0>(archetype, index));
+                }
+            });
+        }
+
+        // reserve slot at the end of archetype, adding new chunk if needed
+        std::size_t AddSlot(Archetype& archetype)
+        {
+            const std::size_t index = archetype.mNumItems;
+            if (index / archetype.mCapacity == archetype.mChunks.size())
+            {
+                archetype.mChunks.push_back(static_cast<std::byte*>(::operator new(archetype.mChunkBytes, std::align_val_t{ Alignment })));
+            }
+
+            ++archetype.mNumItems;
+            return index;
+        }
+
+        // components at index are already moved or destroyed, fill it in with last item
+        template <typename M>
+        void RemoveSlot(Archetype& archetype, std::size_t index, M&& relocated)
+        {
+            const std::size_t lastIndex = archetype.mNumItems - 1;
+            if (index == lastIndex)
+            {
+                --archetype.mNumItems;
+                return;
+            }
+
+            FullRow movedRow{};
+            meta::for_loop<FullRow>([&]<std::size_t T0>()
+            {
+                if (archetype.mPattern.test(T0))
+                {
+                    std::get<T0>(movedRow) = MoveComponent<T0>(archetype, lastIndex, archetype, index);
+                }
+            });
+
+            const comp::Id_t movedId = GetIds(archetype, lastIndex)[0];
+            GetIds(archetype, index)[0] = movedId;
+            mSlots[movedId].mIndex = index;
+            --archetype.mNumItems;
+
+            relocated(movedId, movedRow);
+        }
+
+        // free chunks above numChunks, return number of freed chunks
+        std::size_t FreeChunks(Archetype& archetype, std::size_t numChunks)
+        {
+            std::size_t numFreed = 0;
+            while (archetype.mChunks.size() > numChunks)
+            {
+                ::operator delete(archetype.mChunks.back(), std::align_val_t{ Alignment });
+                archetype.mChunks.pop_back();
+                ++numFreed;
+            }
+
+            return numFreed;
+        }
+
+        std::unordered_map<PatternSet, Archetype> mArchetypes;
+        // item id to it's location
+        std::unordered_map<comp::Id_t, Slot> mSlots;
+    };
+
+} // namespace yaget::comp::internal
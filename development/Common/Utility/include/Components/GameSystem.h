@@ -9,6 +9,8 @@
 //      Class to iterate over set of components per item/entity level
 //      Provides callback methods with specific component type parameters,
 //      including const and non-cont qualifiers.
+//      GameSystem calls update trough std::function, StaticGameSystem (CRTP)
+//      calls derived class directly, per row or per packed columns of chunked storage.
 //
 //
 //  #include "Components/GameSystem.h"
@@ -20,7 +22,10 @@
 #include "Components/ComponentTypes.h"
 #include "Components/Coordinator.h"
 #include "Metrics/Concurrency.h"
+#include "ThreadModel/Parallel.h"
 #include <functional>
+#include <span>
+#include <vector>
 
 namespace yaget
 {
@@ -34,6 +39,111 @@ namespace yaget::comp::gs
     struct NoEndMarker {};
     struct GenerateEndMarker {};
 
+    // Opt-in parallel update, used in place of end marker parameter E (which it wraps).
+    // Matched rows are split into chunks of Grain rows and processed on job pool passed to Tick,
+    // with calling thread processing chunks as well. Tick returns only after all chunks are done.
+    // Order of rows is not guaranteed, update functor must only touch components of it's own item.
+    // End marker (if requested) is always called last, after all rows, on calling thread.
+    // Example:
+    //  class SquadronSystem : public GameSystem<GameCoordinatorSet, Parallel<GenerateEndMarker>, Messaging, SquadronComponent*>
+    template <typename E = NoEndMarker, std::size_t Grain = 64>
+    struct Parallel
+    {
+        static_assert(Grain > 0, "Parallel Grain must be at least 1");
+
+        using EndMarker = E;
+        static constexpr std::size_t GrainSize = Grain;
+    };
+
+    namespace internal
+    {
+        // unwrap end marker and execution (serial or parallel) from E parameter of GameSystem
+        template <typename E>
+        struct execution_policy
+        {
+            using EndMarker = E;
+            static constexpr bool IsParallel = false;
+            static constexpr std::size_t GrainSize = 0;
+        };
+
+        template <typename E, std::size_t Grain>
+        struct execution_policy<Parallel<E, Grain>>
+        {
+            using EndMarker = E;
+            static constexpr bool IsParallel = true;
+            static constexpr std::size_t GrainSize = Grain;
+        };
+
+
+        // Derived system of StaticGameSystem provides per row update, called directly (inlinable).
+        template <typename D, typename... Comps>
+        concept has_row_update = requires(D& system, comp::Id_t id, const time::GameClock& gameClock, metrics::Channel& channel, Comps... components)
+        {
+            system.OnUpdate(id, gameClock, channel, components...);
+        };
+
+        // Derived system of StaticGameSystem provides batched update, receiving one column (span of components) per component,
+        // const Position* becomes std::span<const Position>
+        template <typename D, typename... Comps>
+        concept has_batch_update = requires(D& system, std::span<const comp::Id_t> ids, const time::GameClock& gameClock, metrics::Channel& channel, std::span<std::remove_pointer_t<Comps>>... columns)
+        {
+            system.OnUpdateBatch(ids, gameClock, channel, columns...);
+        };
+
+    } // namespace internal
+
+    // Common part of all game systems, finds matching rows in CoordinatorSet and processes them
+    // serially or in parallel (see Parallel). Self (final system type) provides:
+    //      static constexpr bool UsesChunks();     // true to iterate over packed columns (UpdateChunk) instead of cached rows (UpdateRows)
+    //      void UpdateRows(const Entries& entries, std::size_t begin, std::size_t end, const time::GameClock& gameClock, metrics::Channel& channel);
+    //      void UpdateChunk(std::span<const comp::Id_t> ids, const Row& columns, const time::GameClock& gameClock, metrics::Channel& channel);
+    //      void UpdateEndMarker(const time::GameClock& gameClock, metrics::Channel& channel);
+    template <typename Self, typename CS, typename E, typename M, typename... Comps>
+    class GameSystemBase : public Noncopyable<GameSystemBase<Self, CS, E, M, Comps...>>
+    {
+    public:
+        using ExecutionPolicy = internal::execution_policy<E>;
+        using EndMarker = typename ExecutionPolicy::EndMarker;
+        static constexpr bool IsParallel = ExecutionPolicy::IsParallel;
+        using Messaging = M;
+        // components as declared by system, including const qualifiers (read only access)
+        using Components = std::tuple<Comps...>;
+        using RowPolicy = comp::RowPolicy<std::remove_cv_t<meta::strip_qualifiers_t<Comps>>*...>;
+        using Row = typename RowPolicy::Row;
+        using CoordinatorSet = CS;
+        using Entries = typename CS::template QueryEntries<Row>;
+
+        // framework calls this on same cadence (every tick...)
+        // In default case that is SystemsCoordinator class
+        // jobPool is only used by Parallel systems, if nullptr rows are processed on calling thread.
+        void Tick(const time::GameClock& gameClock, metrics::Channel& channel, mt::JobPool* jobPool = nullptr);
+
+        const char* NiceName() const { return mNiceName; }
+        // interned "System Tick <NiceName>", so tracing system tick does not format it every time
+        metrics::TraceNameId TickTraceName() const { return mTickTraceName; }
+
+    protected:
+        GameSystemBase(const char* niceName, Messaging& messaging, CS& coordinatorSet);
+        ~GameSystemBase() = default;
+
+        // Record add/remove of components here while updating, those are applied after all systems ticked
+        typename CS::CommandBuffer& Commands() { return mCoordinatorSet.Commands(); }
+
+        Messaging& mMessaging;
+
+    private:
+        void TickParallel(const time::GameClock& gameClock, metrics::Channel& channel, mt::JobPool& jobPool);
+        void TickChunks(const time::GameClock& gameClock, metrics::Channel& channel, mt::JobPool* jobPool);
+        Self& AsSelf() { return static_cast<Self&>(*this); }
+
+        const char* mNiceName = nullptr;
+        const metrics::TraceNameId mTraceName;
+        const metrics::TraceNameId mTickTraceName;
+        CoordinatorSet& mCoordinatorSet;
+        // chunks split into batches of GrainSize rows for parallel update, reused between ticks
+        std::vector<std::pair<std::span<const comp::Id_t>, Row>> mChunkBatches;
+    };
+
     // TODO add timers support for entities
     // https://github.com/eglowacki/zloty/issues/44#issue-1174664933
     // Example:
@@ -48,37 +158,81 @@ namespace yaget::comp::gs
     //      void OnUpdate(yaget::comp::Id_t id, const yaget::time::GameClock& gameClock, yaget::metrics::Channel& channel, ScoreComponent* boardComponent);
     //};
     //
+    // Components declared as const pointers (const ScoreComponent*) are read only, which SystemsCoordinator
+    // uses to find out which systems can run at the same time. System also needs to opt in
+    // for concurrent execution with other systems by declaring:
+    //      using ConcurrentSafe = bool;    // does not add/remove components or touch shared state in OnUpdate
+    //
+    // Every row is dispatched trough std::function, see StaticGameSystem for direct calls.
     template <typename CS, typename E, typename M, typename... Comps>
-    class GameSystem : public Noncopyable<GameSystem<CS, E, M, Comps...>>
+    class GameSystem : public GameSystemBase<GameSystem<CS, E, M, Comps...>, CS, E, M, Comps...>
     {
-    public:
-        using EndMarker = E;
-        using Messaging = M;
-        using RowPolicy = comp::RowPolicy<Comps...>;
-        using Row = typename RowPolicy::Row;
-        using CoordinatorSet = CS;
-
-        using UpdateFunctor = std::function<void(yaget::comp::Id_t id, const time::GameClock& gameClock, metrics::Channel& channel, Comps&... args)>;
+        using Base = GameSystemBase<GameSystem<CS, E, M, Comps...>, CS, E, M, Comps...>;
+        friend Base;
 
-        // framework calls this on same cadence (every tick...)
-        // In default case that is SystemsCoordinator class
-        void Tick(const time::GameClock& gameClock, metrics::Channel& channel);
+    public:
+        using typename Base::Messaging;
+        using typename Base::Row;
+        using typename Base::Entries;
 
-        const char* NiceName() const { return mNiceName; }
+        using UpdateFunctor = std::function<void(yaget::comp::Id_t id, const time::GameClock& gameClock, metrics::Channel& channel, Comps... args)>;
 
         ~GameSystem() = default;
 
     protected:
         GameSystem(const char* niceName, Messaging& messaging, Application& app, UpdateFunctor updateFunctor, CS& coordinatorSet);
 
-        Messaging& mMessaging;
-
     private:
+        static constexpr bool UsesChunks() { return false; }
         void Update(yaget::comp::Id_t id, const time::GameClock& gameClock, metrics::Channel& channel, const Row& row);
+        void UpdateRows(const Entries& entries, std::size_t begin, std::size_t end, const time::GameClock& gameClock, metrics::Channel& channel);
+        void UpdateEndMarker(const time::GameClock& gameClock, metrics::Channel& channel);
 
-        const char* mNiceName = nullptr;
         UpdateFunctor mUpdateFunctor;
-        CoordinatorSet& mCoordinatorSet;
+    };
+
+    // Same as GameSystem, but Derived's update is called directly, without std::function and
+    // intermediate tuples, so it can be inlined into iteration loop. Derived provides (public) one or both of:
+    //      void OnUpdate(comp::Id_t id, const time::GameClock& gameClock, metrics::Channel& channel, Comps... components);
+    //      void OnUpdateBatch(std::span<const comp::Id_t> ids, const time::GameClock& gameClock, metrics::Channel& channel, std::span<Components>... columns);
+    // When OnUpdateBatch exists it is preferred. All of Comps must then live in one chunked coordinator
+    // (ChunkedRowPolicy) and each column is a span over components stored in one chunk (or GrainSize part of it
+    // for Parallel), where index i in every column belongs to ids[i]. Chunks are visited in storage order.
+    // Loops over columns read contiguous memory and have no calls in them, which gives compiler a chance to vectorize.
+    // End marker is passed to OnUpdate if it exists, otherwise as batch with one END_ID_MARKER id and empty columns.
+    // Example:
+    //  class MoveSystem : public yaget::comp::gs::StaticGameSystem<MoveSystem, GameCoordinatorSet, NoEndMarker, Messaging, Position*, const Velocity*>
+    //  {
+    //  public:
+    //      MoveSystem(Messaging& messaging, Application& app, GameCoordinatorSet& coordinatorSet)
+    //          : StaticGameSystem("MoveSystem", messaging, app, coordinatorSet)
+    //      {}
+    //
+    //      void OnUpdateBatch(std::span<const Id_t> ids, const GameClock& gameClock, Channel& channel, std::span<Position> positions, std::span<const Velocity> velocities);
+    //  };
+    template <typename Derived, typename CS, typename E, typename M, typename... Comps>
+    class StaticGameSystem : public GameSystemBase<StaticGameSystem<Derived, CS, E, M, Comps...>, CS, E, M, Comps...>
+    {
+        using Base = GameSystemBase<StaticGameSystem<Derived, CS, E, M, Comps...>, CS, E, M, Comps...>;
+        friend Base;
+
+    public:
+        using typename Base::Messaging;
+        using typename Base::Row;
+        using typename Base::Entries;
+
+        ~StaticGameSystem() = default;
+
+    protected:
+        StaticGameSystem(const char* niceName, Messaging& messaging, Application& app, CS& coordinatorSet);
+
+    private:
+        static constexpr bool UsesChunks() { return internal::has_batch_update<Derived, Comps...>; }
+        void UpdateRows(const Entries& entries, std::size_t begin, std::size_t end, const time::GameClock& gameClock, metrics::Channel& channel);
+        void UpdateChunk(std::span<const comp::Id_t> ids, const Row& columns, const time::GameClock& gameClock, metrics::Channel& channel);
+        void UpdateEndMarker(const time::GameClock& gameClock, metrics::Channel& channel);
+
+        Derived& AsDerived() { return static_cast<Derived&>(*this); }
     };
 
 } // namespace yaget::comp::gs
@@ -24,37 +24,206 @@
 namespace yaget::comp::gs
 {
     //---------------------------------------------------------------------------------------------------------
-    template <typename CS, typename E, typename M, typename... Comps>
-    void GameSystem<CS, E, M, Comps...>::Tick(const time::GameClock& gameClock, metrics::Channel& channel)
+    template <typename Self, typename CS, typename E, typename M, typename... Comps>
+    void GameSystemBase<Self, CS, E, M, Comps...>::Tick(const time::GameClock& gameClock, metrics::Channel& channel, mt::JobPool* jobPool)
     {
-        mCoordinatorSet.template ForEach<Row>([this, &gameClock, &channel](Id_t id, const auto& row)
+        if constexpr (Self::UsesChunks())
         {
-            Update(id, gameClock, channel, row);
-            return true;
-        });
+            TickChunks(gameClock, channel, jobPool);
+        }
+        else
+        {
+            bool processed = false;
+            if constexpr (IsParallel)
+            {
+                if (jobPool)
+                {
+                    TickParallel(gameClock, channel, *jobPool);
+                    processed = true;
+                }
+            }
+
+            if (!processed)
+            {
+                mCoordinatorSet.template VisitRows<Row>([this, &gameClock, &channel](const Entries& entries)
+                {
+                    AsSelf().UpdateRows(entries, 0, entries.size(), gameClock, channel);
+                    return entries.size();
+                });
+            }
+        }
 
         if constexpr (std::is_same_v<EndMarker, GenerateEndMarker>)
         {
-            Update(END_ID_MARKER, gameClock, channel, {});
+            AsSelf().UpdateEndMarker(gameClock, channel);
         }
     }
 
     //---------------------------------------------------------------------------------------------------------
-    template <typename CS, typename E, typename M, typename... Comps>
-    GameSystem<CS, E, M, Comps...>::GameSystem(const char* niceName, Messaging& messaging, Application& /*app*/, UpdateFunctor updateFunctor, CS& coordinatorSet)
+    template <typename Self, typename CS, typename E, typename M, typename... Comps>
+    void GameSystemBase<Self, CS, E, M, Comps...>::TickParallel(const time::GameClock& gameClock, metrics::Channel& channel, mt::JobPool& jobPool)
+    {
+        constexpr std::size_t GrainSize = ExecutionPolicy::GrainSize;
+
+        mCoordinatorSet.template VisitRows<Row>([this, &gameClock, &channel, &jobPool](const Entries& entries)
+        {
+            // all rows are updated before next system ticks, calling thread takes chunks too
+            const auto callingThread = std::this_thread::get_id();
+            mt::parallel_for(jobPool, 0, entries.size(), GrainSize, [this, &gameClock, &channel, &entries, callingThread](std::size_t beginRow, std::size_t endRow)
+            {
+                if (std::this_thread::get_id() == callingThread)
+                {
+                    AsSelf().UpdateRows(entries, beginRow, endRow, gameClock, channel);
+                }
+                else
+                {
+                    metrics::Channel chunkChannel(mTraceName);
+                    AsSelf().UpdateRows(entries, beginRow, endRow, gameClock, chunkChannel);
+                }
+            });
+
+            return entries.size();
+        });
+    }
+
+    //---------------------------------------------------------------------------------------------------------
+    template <typename Self, typename CS, typename E, typename M, typename... Comps>
+    void GameSystemBase<Self, CS, E, M, Comps...>::TickChunks(const time::GameClock& gameClock, metrics::Channel& channel, mt::JobPool* jobPool)
+    {
+        if constexpr (IsParallel)
+        {
+            if (jobPool)
+            {
+                // split chunks into batches of up to GrainSize rows, so they can be spread over job pool
+                mChunkBatches.clear();
+                mCoordinatorSet.template ForEachChunk<Row>([this](std::span<const comp::Id_t> ids, const Row& columns)
+                {
+                    for (std::size_t begin = 0; begin < ids.size(); begin += ExecutionPolicy::GrainSize)
+                    {
+                        const Row batchColumns = std::apply([begin](auto... column) { return Row(column + begin...); }, columns);
+                        mChunkBatches.emplace_back(ids.subspan(begin, std::min(ExecutionPolicy::GrainSize, ids.size() - begin)), batchColumns);
+                    }
+                });
+
+                const auto callingThread = std::this_thread::get_id();
+                mt::parallel_for(*jobPool, 0, mChunkBatches.size(), 1, [this, &gameClock, &channel, callingThread](std::size_t beginBatch, std::size_t endBatch)
+                {
+                    for (std::size_t i = beginBatch; i < endBatch; ++i)
+                    {
+                        const auto& [ids, columns] = mChunkBatches[i];
+                        if (std::this_thread::get_id() == callingThread)
+                        {
+                            AsSelf().UpdateChunk(ids, columns, gameClock, channel);
+                        }
+                        else
+                        {
+                            metrics::Channel chunkChannel(mTraceName);
+                            AsSelf().UpdateChunk(ids, columns, gameClock, chunkChannel);
+                        }
+                    }
+                });
+
+                return;
+            }
+        }
+
+        mCoordinatorSet.template ForEachChunk<Row>([this, &gameClock, &channel](std::span<const comp::Id_t> ids, const Row& columns)
+        {
+            AsSelf().UpdateChunk(ids, columns, gameClock, channel);
+        });
+    }
+
+    //---------------------------------------------------------------------------------------------------------
+    template <typename Self, typename CS, typename E, typename M, typename... Comps>
+    GameSystemBase<Self, CS, E, M, Comps...>::GameSystemBase(const char* niceName, Messaging& messaging, CS& coordinatorSet)
         : mMessaging(messaging)
         , mNiceName(niceName)
-        , mUpdateFunctor(updateFunctor)
+        , mTraceName(metrics::InternTraceName(niceName))
+        , mTickTraceName(metrics::InternTraceName(fmt::format("System Tick {}", niceName)))
         , mCoordinatorSet(coordinatorSet)
     {}
 
+    //---------------------------------------------------------------------------------------------------------
+    template <typename CS, typename E, typename M, typename... Comps>
+    GameSystem<CS, E, M, Comps...>::GameSystem(const char* niceName, Messaging& messaging, Application& /*app*/, UpdateFunctor updateFunctor, CS& coordinatorSet)
+        : Base(niceName, messaging, coordinatorSet)
+        , mUpdateFunctor(updateFunctor)
+    {}
+
     //---------------------------------------------------------------------------------------------------------
     template <typename CS, typename E, typename M, typename... Comps>
     void GameSystem<CS, E, M, Comps...>::Update(Id_t id, const time::GameClock& gameClock, metrics::Channel& channel, const Row& row)
     {
-        // NOTE how can we convert row to new row with some of them being const modified?
+        // row components are converted to const when system declared them as such
         auto newRow = std::tuple_cat(std::tie(id, gameClock, channel), row);
         std::apply(mUpdateFunctor, newRow);
     }
 
+    //---------------------------------------------------------------------------------------------------------
+    template <typename CS, typename E, typename M, typename... Comps>
+    void GameSystem<CS, E, M, Comps...>::UpdateRows(const Entries& entries, std::size_t begin, std::size_t end, const time::GameClock& gameClock, metrics::Channel& channel)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Update(entries[i].mId, gameClock, channel, entries[i].mRow);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------------------
+    template <typename CS, typename E, typename M, typename... Comps>
+    void GameSystem<CS, E, M, Comps...>::UpdateEndMarker(const time::GameClock& gameClock, metrics::Channel& channel)
+    {
+        Update(END_ID_MARKER, gameClock, channel, {});
+    }
+
+    //---------------------------------------------------------------------------------------------------------
+    template <typename Derived, typename CS, typename E, typename M, typename... Comps>
+    StaticGameSystem<Derived, CS, E, M, Comps...>::StaticGameSystem(const char* niceName, Messaging& messaging, Application& /*app*/, CS& coordinatorSet)
+        : Base(niceName, messaging, coordinatorSet)
+    {}
+
+    //---------------------------------------------------------------------------------------------------------
+    template <typename Derived, typename CS, typename E, typename M, typename... Comps>
+    void StaticGameSystem<Derived, CS, E, M, Comps...>::UpdateRows(const Entries& entries, std::size_t begin, std::size_t end, const time::GameClock& gameClock, metrics::Channel& channel)
+    {
+        static_assert(internal::has_row_update<Derived, Comps...>,
+            "StaticGameSystem Derived class must provide public OnUpdate or OnUpdateBatch method matching system components.");
+
+        Derived& derived = AsDerived();
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const auto& entry = entries[i];
+            std::apply([&derived, &entry, &gameClock, &channel](auto... components)
+            {
+                derived.OnUpdate(entry.mId, gameClock, channel, components...);
+            }, entry.mRow);
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------------------
+    template <typename Derived, typename CS, typename E, typename M, typename... Comps>
+    void StaticGameSystem<Derived, CS, E, M, Comps...>::UpdateChunk(std::span<const comp::Id_t> ids, const Row& columns, const time::GameClock& gameClock, metrics::Channel& channel)
+    {
+        // columns point straight into chunk storage, component at index i belongs to ids[i]
+        std::apply([this, ids, &gameClock, &channel](auto... column)
+        {
+            AsDerived().OnUpdateBatch(ids, gameClock, channel, std::span<std::remove_pointer_t<Comps>>(column, ids.size())...);
+        }, columns);
+    }
+
+    //---------------------------------------------------------------------------------------------------------
+    template <typename Derived, typename CS, typename E, typename M, typename... Comps>
+    void StaticGameSystem<Derived, CS, E, M, Comps...>::UpdateEndMarker(const time::GameClock& gameClock, metrics::Channel& channel)
+    {
+        if constexpr (internal::has_row_update<Derived, Comps...>)
+        {
+            AsDerived().OnUpdate(END_ID_MARKER, gameClock, channel, Comps{}...);
+        }
+        else
+        {
+            const comp::Id_t endMarker = END_ID_MARKER;
+            AsDerived().OnUpdateBatch(std::span<const comp::Id_t>(&endMarker, 1), gameClock, channel, std::span<std::remove_pointer_t<Comps>>()...);
+        }
+    }
+
 } // namespace yaget::comp::gs
@@ -7,6 +7,12 @@
 //
 //  NOTES:
 //      Replaces functionality of GameCoordinator, but serves similar purpose
+//      Systems which opt in (ConcurrentSafe) are scheduled on a job pool,
+//      where two systems run at the same time only if they do not share
+//      any component with at least one of them writing to it (non const).
+//      Order of conflicting systems follows declaration order.
+//      Commands recorded by systems (CoordinatorSet::Commands) are applied
+//      once, after all systems ticked.
 //
 //
 //  #include "Components/SystemsCoordinator.h"
@@ -17,7 +23,13 @@
 
 #include "Components/CoordinatorSet.h"
 #include "App/Application.h"
+#include "Debugging/DevConfiguration.h"
 #include "Meta/CompilerAlgo.h"
+#include "ThreadModel/JobPool.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
 
 
 namespace yaget::metrics { class Channel; }
@@ -46,12 +58,108 @@ namespace yaget::comp::gs
 
             return result;
         }
+
+        // system can run at the same time as other systems, if there is no component access conflict
+        template <typename T>
+        concept concurrent_system = requires { typename T::ConcurrentSafe; };
+
+        // component declared as non const pointer means system may modify it
+        template <typename C>
+        constexpr bool is_write_access_v = !std::is_const_v<std::remove_pointer_t<std::remove_reference_t<C>>>;
+
+        // Return true if system A and B can not run at the same time
+        template <typename A, typename B>
+        constexpr bool systems_conflict()
+        {
+            if constexpr (!concurrent_system<A> || !concurrent_system<B>)
+            {
+                return true;
+            }
+            else
+            {
+                bool conflict = false;
+                meta::for_loop<typename A::Components>([&conflict]<std::size_t IA>()
+                {
+                    using ComponentA = std::tuple_element_t<IA, typename A::Components>;
+
+                    meta::for_loop<typename B::Components>([&conflict]<std::size_t IB>()
+                    {
+                        using ComponentB = std::tuple_element_t<IB, typename B::Components>;
+
+                        if constexpr (std::is_same_v<std::remove_cv_t<meta::strip_qualifiers_t<ComponentA>>, std::remove_cv_t<meta::strip_qualifiers_t<ComponentB>>>)
+                        {
+                            conflict = conflict || is_write_access_v<ComponentA> || is_write_access_v<ComponentB>;
+                        }
+                    });
+                });
+
+                return conflict;
+            }
+        }
+
+        //-------------------------------------------------------------------------------------------------
+        // Compile time dependency graph of systems. System J depends on all earlier (declared before)
+        // systems I which conflict with it, so conflicting systems keep declaration order.
+        template <typename S, std::size_t N = std::tuple_size_v<S>>
+        struct SystemsGraph
+        {
+            using Matrix = std::array<std::array<bool, N>, N>;
+
+            static constexpr Matrix MakeDependencies()
+            {
+                Matrix dependencies{};
+                meta::for_loop<N>([&dependencies]<std::size_t J>()
+                {
+                    meta::for_loop<N>([&dependencies]<std::size_t I>()
+                    {
+                        if constexpr (I < J)
+                        {
+                            dependencies[J][I] = systems_conflict<std::tuple_element_t<I, S>, std::tuple_element_t<J, S>>();
+                        }
+                    });
+                });
+
+                return dependencies;
+            }
+
+            static constexpr std::array<int, N> MakeNumDependencies()
+            {
+                std::array<int, N> numDependencies{};
+                for (std::size_t j = 0; j < N; ++j)
+                {
+                    for (std::size_t i = 0; i < N; ++i)
+                    {
+                        numDependencies[j] += Dependencies[j][i] ? 1 : 0;
+                    }
+                }
+
+                return numDependencies;
+            }
+
+            static constexpr std::array<bool, N> MakeConcurrent()
+            {
+                std::array<bool, N> concurrent{};
+                meta::for_loop<N>([&concurrent]<std::size_t I>()
+                {
+                    concurrent[I] = concurrent_system<std::tuple_element_t<I, S>>;
+                });
+
+                return concurrent;
+            }
+
+            // [J][I] is true when system J must wait for system I to finish
+            static constexpr Matrix Dependencies = MakeDependencies();
+            static constexpr std::array<int, N> NumDependencies = MakeNumDependencies();
+            static constexpr std::array<bool, N> Concurrent = MakeConcurrent();
+            static constexpr bool AnyConcurrent = std::ranges::any_of(Concurrent, [](bool value) { return value; });
+        };
     }
 
     //-------------------------------------------------------------------------------------------------
     // Create coordinator for system and call each for update
     // T is GameCoordinatorSet and ...S are Systems (classes that follow yaget::comp::gs::GameSystem)
     // M is Messaging and A represents Application
+    // Systems using Parallel policy share one job pool owned by this class.
     template <typename T, typename M, typename A, typename... S>
     class SystemsCoordinator
     {
@@ -66,6 +174,8 @@ namespace yaget::comp::gs
 
         SystemsCoordinator(M& messaging, A& app);
 
+        // Tick all systems. First exception thrown by any system is rethrown here once all systems are finished,
+        // in which case systems not started yet are skipped and recorded commands stay queued.
         void Tick(const time::GameClock& gameClock, metrics::Channel& channel);
 
         template <typename C, typename... Args>
@@ -86,16 +196,41 @@ namespace yaget::comp::gs
         template <typename TT = typename CoordinatorSet::FullRow>
         TT LoadItem(comp::Id_t id);
 
+        // Deferred changes for calling thread, applied at the end of Tick
+        typename CoordinatorSet::CommandBuffer& Commands() { return mCoordinatorSet.Commands(); }
+
         items::Director& Director() { return mApp.Director(); }
         const items::Director& Director() const { return mApp.Director(); }
 
+        template <typename P>
+        comp::Coordinator<P>& GetCoordinator() { return mCoordinatorSet.template GetCoordinator<P>(); }
+
+        template <typename P>
+        const comp::Coordinator<P>& GetCoordinator() const { return mCoordinatorSet.template GetCoordinator<P>(); }
+
+        template <typename G>
+        G& GetSystem() { return *std::get<std::shared_ptr<G>>(mSystems); }
+
+        template <typename G>
+        const G& GetSystem() const { return *std::get<std::shared_ptr<G>>(mSystems); }
+
     private:
         using ManagedSystems = std::tuple<std::shared_ptr<S>...>;
+        using Graph = internal::SystemsGraph<Systems>;
+
+        static constexpr bool UsesJobPool = (S::IsParallel || ...) || Graph::AnyConcurrent;
+
+        struct TickState;
+
+        void TickSystem(std::size_t index, const time::GameClock& gameClock);
+        void RunSystem(std::size_t index, const time::GameClock& gameClock, const std::shared_ptr<TickState>& tickState);
+        void TickConcurrent(const time::GameClock& gameClock);
 
         Messaging& mMessaging;
         A& mApp;
         CoordinatorSet mCoordinatorSet;
         ManagedSystems mSystems;
+        std::unique_ptr<mt::JobPool> mJobPool;
     };
 
     namespace internal
@@ -144,6 +279,11 @@ yaget::comp::gs::SystemsCoordinator<T, M, A, S...>::SystemsCoordinator(M& messag
     , mApp(app)
     , mCoordinatorSet(&app.Director())
 {
+    if constexpr (UsesJobPool)
+    {
+        mJobPool = std::make_unique<mt::JobPool>("Systems", dev::CurrentConfiguration().mDebug.mThreads.Systems, mt::JobPool::Behaviour::StartAsRun, mt::JobPool::ConfiguredThreadOptions("Systems"));
+    }
+
     auto This = this;
 
     meta::for_loop<ManagedSystems>([This, this]<std::size_t T0>()
@@ -159,19 +299,207 @@ yaget::comp::gs::SystemsCoordinator<T, M, A, S...>::SystemsCoordinator(M& messag
 
 //-------------------------------------------------------------------------------------------------
 template <typename T, typename M, typename A, typename... S>
-void yaget::comp::gs::SystemsCoordinator<T, M, A, S...>::Tick(const time::GameClock& gameClock, metrics::Channel& channel)
+void yaget::comp::gs::SystemsCoordinator<T, M, A, S...>::Tick(const time::GameClock& gameClock, metrics::Channel& /*channel*/)
 {
-    // possibly run each system on own thread, taking Policy (usage) into account
-    meta::for_each(mSystems, [this, &gameClock, &channel](auto& gameSystem)
+    if constexpr (Graph::AnyConcurrent)
+    {
+        TickConcurrent(gameClock);
+    }
+    else
     {
-        const auto& message = fmt::format("System Tick {}", gameSystem->NiceName());
-        metrics::Channel systemChannel(message);
+        for (std::size_t i = 0; i < NumSystems; ++i)
+        {
+            TickSystem(i, gameClock);
+        }
+    }
+
+    // all systems are done, no one iterates, safe to add/remove recorded components
+    mCoordinatorSet.PlaybackCommands();
+}
 
-        gameSystem->Tick(gameClock, channel);
+
+//-------------------------------------------------------------------------------------------------
+// Tick one system with it's own channel, so trace shows start/end of each system on the thread it run on
+template <typename T, typename M, typename A, typename... S>
+void yaget::comp::gs::SystemsCoordinator<T, M, A, S...>::TickSystem(std::size_t index, const time::GameClock& gameClock)
+{
+    meta::for_loop<NumSystems>([this, index, &gameClock]<std::size_t T0>()
+    {
+        if (T0 == index)
+        {
+            auto& gameSystem = std::get<T0>(mSystems);
+
+            metrics::Channel systemChannel(gameSystem->TickTraceName());
+
+            gameSystem->Tick(gameClock, systemChannel, mJobPool.get());
+        }
     });
 }
 
 
+//-------------------------------------------------------------------------------------------------
+template <typename T, typename M, typename A, typename... S>
+struct yaget::comp::gs::SystemsCoordinator<T, M, A, S...>::TickState
+{
+    std::array<std::atomic<int>, NumSystems> mNumDependencies;
+    std::atomic<std::size_t> mNumDone{ 0 };
+
+    // systems which are not ConcurrentSafe, executed by calling thread
+    std::mutex mCallerMutex;
+    std::vector<std::size_t> mCallerSystems;
+    std::atomic<uint32_t> mCallerSignal{ 0 };
+
+    // first exception thrown by any system (guarded by mCallerMutex), rethrown by calling thread once all systems are done
+    std::exception_ptr mException;
+    std::atomic<bool> mFailed{ false };
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Tick system and release any systems waiting on it. First concurrent system that became ready
+// is run by this thread, rest are added to job pool or passed to calling thread.
+// Once any system throws, remaining systems are not ticked but still counted as done.
+template <typename T, typename M, typename A, typename... S>
+void yaget::comp::gs::SystemsCoordinator<T, M, A, S...>::RunSystem(std::size_t index, const time::GameClock& gameClock, const std::shared_ptr<TickState>& tickState)
+{
+    for (std::size_t current = index; current != NumSystems;)
+    {
+        if (!tickState->mFailed)
+        {
+            try
+            {
+                TickSystem(current, gameClock);
+            }
+            catch (...)
+            {
+                std::unique_lock<std::mutex> locker(tickState->mCallerMutex);
+                if (!tickState->mException)
+                {
+                    tickState->mException = std::current_exception();
+                }
+                tickState->mFailed = true;
+            }
+        }
+
+        std::size_t next = NumSystems;
+        bool signalCaller = false;
+        for (std::size_t j = current + 1; j < NumSystems; ++j)
+        {
+            if (Graph::Dependencies[j][current] && --tickState->mNumDependencies[j] == 0)
+            {
+                if (!Graph::Concurrent[j])
+                {
+                    std::unique_lock<std::mutex> locker(tickState->mCallerMutex);
+                    tickState->mCallerSystems.push_back(j);
+                    signalCaller = true;
+                }
+                else if (next == NumSystems)
+                {
+                    next = j;
+                }
+                else
+                {
+                    mJobPool->AddTask([this, j, &gameClock, tickState]()
+                    {
+                        RunSystem(j, gameClock, tickState);
+                    });
+                }
+            }
+        }
+
+        // calling thread waits on this signal, once all systems are done it's free to return.
+        // tickState is shared with tasks, since this thread may still touch it after calling thread left
+        const bool allDone = ++tickState->mNumDone == NumSystems;
+        if (signalCaller || allDone)
+        {
+            ++tickState->mCallerSignal;
+            tickState->mCallerSignal.notify_all();
+        }
+
+        current = next;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <typename T, typename M, typename A, typename... S>
+void yaget::comp::gs::SystemsCoordinator<T, M, A, S...>::TickConcurrent(const time::GameClock& gameClock)
+{
+    auto tickState = std::make_shared<TickState>();
+    for (std::size_t i = 0; i < NumSystems; ++i)
+    {
+        tickState->mNumDependencies[i] = Graph::NumDependencies[i];
+    }
+
+    // kick off all systems without dependencies, calling thread takes first one of them
+    std::size_t first = NumSystems;
+    for (std::size_t i = 0; i < NumSystems; ++i)
+    {
+        if (Graph::NumDependencies[i] == 0)
+        {
+            if (!Graph::Concurrent[i])
+            {
+                tickState->mCallerSystems.push_back(i);
+            }
+            else if (first == NumSystems)
+            {
+                first = i;
+            }
+            else
+            {
+                mJobPool->AddTask([this, i, &gameClock, tickState]()
+                {
+                    RunSystem(i, gameClock, tickState);
+                });
+            }
+        }
+    }
+
+    if (first != NumSystems)
+    {
+        RunSystem(first, gameClock, tickState);
+    }
+
+    // run systems which are not concurrent on calling thread and wait for the rest
+    while (true)
+    {
+        const uint32_t signal = tickState->mCallerSignal;
+
+        std::vector<std::size_t> callerSystems;
+        {
+            std::unique_lock<std::mutex> locker(tickState->mCallerMutex);
+            std::swap(callerSystems, tickState->mCallerSystems);
+        }
+
+        for (const auto& index : callerSystems)
+        {
+            RunSystem(index, gameClock, tickState);
+        }
+
+        if (tickState->mNumDone == NumSystems)
+        {
+            break;
+        }
+
+        if (callerSystems.empty())
+        {
+            tickState->mCallerSignal.wait(signal);
+        }
+    }
+
+    if (tickState->mFailed)
+    {
+        std::exception_ptr exception;
+        {
+            std::unique_lock<std::mutex> locker(tickState->mCallerMutex);
+            exception = tickState->mException;
+        }
+
+        std::rethrow_exception(exception);
+    }
+}
+
+
 //-------------------------------------------------------------------------------------------------
 template <typename T, typename M, typename A, typename ... S>
 template <typename C, typename... Args>
@@ -72,6 +72,16 @@ namespace yaget
                     uint32_t VTS = 0;
                     uint32_t Blob = 0;
                     uint32_t App = 0;
+                    uint32_t Systems = 0;       // shared by game systems for parallel updates, 0 - use all cores
+
+                    //! OS scheduling of pool threads, keyed by App, Blob, VTS, Systems or FileLoader (IO completion thread)
+                    //!  "Pools": { "App": { "Priority": "High" }, "Blob": { "Priority": "Low", "Cores": [ 2, 3 ] } }
+                    struct PoolOptions
+                    {
+                        std::string Priority = "Normal";    // Lowest, Low, Normal, High, Highest
+                        std::vector<uint32_t> Cores;        // pin pool threads to these cores, empty - not pinned
+                    };
+                    std::map<std::string, PoolOptions> Pools;
                 };
                 Threads mThreads;
 
@@ -82,6 +92,8 @@ namespace yaget
                     int SocketConnectionTimeout = 100;
                     std::string TraceFileName = "$(Temp)/$(AppName)_trace.json";
                     bool TraceOn = true;
+                    // Json or Binary (compact, convert with TraceConverter), see Metrics/TraceFormat.h
+                    std::string TraceFormat = "Json";
                 };
                 Metrics mMetrics;
 
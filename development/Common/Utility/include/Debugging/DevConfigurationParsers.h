@@ -109,12 +109,20 @@ namespace yaget::dev
             lhs.Outputs == rhs.Outputs;
     }
 
+    inline bool operator==(const Configuration::Debug::Threads::PoolOptions& lhs, const Configuration::Debug::Threads::PoolOptions& rhs)
+    {
+        return lhs.Priority == rhs.Priority &&
+            lhs.Cores == rhs.Cores;
+    }
+
     inline bool operator==(const Configuration::Debug::Threads& lhs, const Configuration::Debug::Threads& rhs)
     {
         return lhs.VTSSections == rhs.VTSSections &&
             lhs.VTS == rhs.VTS &&
             lhs.Blob == rhs.Blob &&
-            lhs.App == rhs.App;
+            lhs.App == rhs.App &&
+            lhs.Systems == rhs.Systems &&
+            lhs.Pools == rhs.Pools;
     }
 
     inline bool operator==(const Configuration::Debug::Metrics& lhs, const Configuration::Debug::Metrics& rhs)
@@ -123,7 +131,8 @@ namespace yaget::dev
                lhs.AllowFallbackToFile == rhs.AllowFallbackToFile &&
                lhs.SocketConnectionTimeout == rhs.SocketConnectionTimeout &&
                lhs.TraceFileName == rhs.TraceFileName &&
-               lhs.TraceOn == rhs.TraceOn;
+               lhs.TraceOn == rhs.TraceOn &&
+               lhs.TraceFormat == rhs.TraceFormat;
     }
 
     inline bool operator==(const Configuration::Debug& lhs, const Configuration::Debug& rhs)
@@ -290,6 +299,20 @@ namespace yaget::dev
     }
 
 
+    //-------------------------------------------------------------------------------------------------------------------------------
+    inline void to_json(nlohmann::json& j, const dev::Configuration::Debug::Threads::PoolOptions& poolOptions)
+    {
+        j["Priority"] = poolOptions.Priority;
+        j["Cores"] = poolOptions.Cores;
+    }
+
+    //-------------------------------------------------------------------------------------------------------------------------------
+    inline void from_json(const nlohmann::json& j, dev::Configuration::Debug::Threads::PoolOptions& poolOptions)
+    {
+        poolOptions.Priority = json::GetValue(j, "Priority", poolOptions.Priority);
+        poolOptions.Cores = json::GetValue(j, "Cores", poolOptions.Cores);
+    }
+
     //-------------------------------------------------------------------------------------------------------------------------------
     inline void to_json(nlohmann::json& j, const dev::Configuration::Debug::Threads& threads)
     {
@@ -297,6 +320,8 @@ namespace yaget::dev
         j["VTS"] = threads.VTS;
         j["Blob"] = threads.Blob;
         j["App"] = threads.App;
+        j["Systems"] = threads.Systems;
+        j["Pools"] = threads.Pools;
     }
 
     //-------------------------------------------------------------------------------------------------------------------------------
@@ -306,6 +331,8 @@ namespace yaget::dev
         threads.VTS = json::GetValue(j, "VTS", threads.VTS);
         threads.Blob = json::GetValue(j, "Blob", threads.Blob);
         threads.App = json::GetValue(j, "App", threads.App);
+        threads.Systems = json::GetValue(j, "Systems", threads.Systems);
+        threads.Pools = json::GetValue(j, "Pools", threads.Pools);
     }
 
 
@@ -318,6 +345,7 @@ namespace yaget::dev
         j["SocketConnectionTimeout"] = metrics.SocketConnectionTimeout;
         j["TraceFileName"] = metrics.TraceFileName;
         j["TraceOn"] = metrics.TraceOn;
+        j["TraceFormat"] = metrics.TraceFormat;
     }
 
     //-------------------------------------------------------------------------------------------------------------------------------
@@ -328,6 +356,7 @@ namespace yaget::dev
         metrics.SocketConnectionTimeout = json::GetValue(j, "SocketConnectionTimeout", metrics.SocketConnectionTimeout);
         metrics.TraceFileName = json::GetValue(j, "TraceFileName", metrics.TraceFileName);
         metrics.TraceOn = json::GetValue(j, "TraceOn", metrics.TraceOn);
+        metrics.TraceFormat = json::GetValue(j, "TraceFormat", metrics.TraceFormat);
     }
 
 
@@ -0,0 +1,348 @@
+///////////////////////////////////////////////////////////////////////
+// ConcurrentPoolAllocator.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Thread safe version of PoolAllocator, where Allocate and Free
+//      can be called from any thread (job pool workers).
+//      Each thread allocates from it's own cache of free slots without
+//      locking, only refilling cache from shared lines (under lock)
+//      in batches. Freeing slot which belongs to other thread cache
+//      pushes it on that cache remote stack (lock free), which owner
+//      takes back next time it's local cache runs dry.
+//      When thread exits it's caches are retired, free slots go back
+//      to shared list and cache is reused by next new thread.
+//
+//
+//  #include "MemoryManager/ConcurrentPoolAllocator.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "MemoryManager/PoolAllocator.h"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+
+namespace yaget::memory
+{
+    namespace internal
+    {
+        // unique id per allocator instance, used as a key into thread local caches,
+        // so new allocator created at the same address does not pick up stale cache
+        inline std::uint64_t NextConcurrentPoolId()
+        {
+            static std::atomic<std::uint64_t> poolId{ 0 };
+            return ++poolId;
+        }
+
+    } // namespace internal
+
+    //! Same as PoolAllocator, memory is allocated in lines of E slots which are never released
+    //! until allocator itself is destroyed, but it's safe to Allocate and Free from any thread.
+    //! Memory slots are moved in batches of BatchSize between shared free list and per thread caches.
+    //! Only threads which allocate get a cache, freeing from any other thread pushes slot back to it's owner cache.
+    //! Iteration over allocated elements is not supported.
+    template <typename T, int E = internal::GetCapacity<T>()>
+    class ConcurrentPoolAllocator : public Noncopyable<ConcurrentPoolAllocator<T, E>>
+    {
+    public:
+        static constexpr int Size = E;
+        static constexpr std::size_t BatchSize = 32;
+        using Type = T;
+
+        ConcurrentPoolAllocator() = default;
+        ~ConcurrentPoolAllocator()
+        {
+            YAGET_ASSERT(NumAllocated() == 0, "ConcurrentPoolAllocator for '%s' still has outstanding '%d' allocation(s).", typeid(T).name(), NumAllocated());
+        }
+
+        template<typename... Args>
+        T* Allocate(Args&&... args)
+        {
+            Cache& cache = GetCache();
+            if (cache.mFreeBlocks.empty())
+            {
+                RefillCache(cache);
+            }
+
+            Block* block = cache.mFreeBlocks.back();
+            cache.mFreeBlocks.pop_back();
+
+            try
+            {
+                T* instance = nullptr;
+                if constexpr (std::is_constructible_v<T, Args...>)
+                {
+                    instance = new(block->mStorage) T(std::forward<Args>(args)...);
+                }
+                else
+                {
+                    using Dummies = std::tuple<Args...>;
+                    [[maybe_unused]] Dummies dummy(args...);
+                    instance = new(block->mStorage) T{};
+                }
+
+                mNumAllocated.fetch_add(1, std::memory_order_relaxed);
+                return instance;
+            }
+            catch (const ex::bad_init& e)
+            {
+                cache.mFreeBlocks.push_back(block);
+                YAGET_ASSERT(false, "Examine this bad_init excpetion: '%s'.", e.what());
+                throw;
+            }
+        }
+
+        void Free(T* allocatedMemory)
+        {
+            YAGET_ASSERT(allocatedMemory, "Param allocatedMemory of type '%s' is nullptr.", typeid(T).name());
+
+            Block* block = GetBlock(allocatedMemory);
+            allocatedMemory->~T();
+            mNumAllocated.fetch_sub(1, std::memory_order_relaxed);
+
+            // thread which never allocated from this pool does not need a cache, block goes to it's owner
+            Cache* cache = FindCache();
+            if (block->mOwner == cache)
+            {
+                cache->mFreeBlocks.push_back(block);
+                if (cache->mFreeBlocks.size() > BatchSize * 2)
+                {
+                    ReleaseToShared(*cache, BatchSize);
+                }
+            }
+            else
+            {
+                PushRemote(*block->mOwner, block);
+            }
+        }
+
+        // Number of currently allocated elements, approximate if called while other threads allocate/free
+        std::size_t NumAllocated() const { return mNumAllocated.load(std::memory_order_relaxed); }
+
+        // Number of elements all memory lines can hold
+        std::size_t Capacity() const
+        {
+            std::unique_lock<std::mutex> locker(mShared->mMutex);
+            return mShared->mLines.size() * Size;
+        }
+
+    private:
+        struct Cache;
+
+        // one slot, header is followed by memory for T which is returned to user
+        struct Block
+        {
+            // cache this block was handed to, free blocks go back to it
+            Cache* mOwner = nullptr;
+            // link in remote free stack
+            Block* mNext = nullptr;
+            alignas(T) std::byte mStorage[sizeof(T)];
+        };
+
+        struct Cache
+        {
+            // only touched by owning thread (or under shared lock when it exits)
+            std::vector<Block*> mFreeBlocks;
+            // blocks freed by other threads, Treiber stack where consumer takes all at once,
+            // owner or shared list (under lock) once owner exited
+            std::atomic<Block*> mRemoteFreeBlocks{ nullptr };
+        };
+
+        static Block* GetBlock(T* instance)
+        {
+            return reinterpret_cast<Block*>(reinterpret_cast<std::byte*>(instance) - offsetof(Block, mStorage));
+        }
+
+        static void PushRemote(Cache& cache, Block* block)
+        {
+            Block* head = cache.mRemoteFreeBlocks.load(std::memory_order_relaxed);
+            do
+            {
+                block->mNext = head;
+            } while (!cache.mRemoteFreeBlocks.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // Memory lines and caches, shared with thread local cache entries, so thread exiting
+        // after allocator was destroyed does not touch it
+        struct Shared
+        {
+            // Called when owning thread exits, free blocks go back to shared list and cache waits for next new thread.
+            // Blocks still allocated keep pointing to it, so cache itself is never deleted before allocator.
+            void Retire(Cache& cache)
+            {
+                std::unique_lock<std::mutex> locker(mMutex);
+                mFreeBlocks.insert(mFreeBlocks.end(), cache.mFreeBlocks.begin(), cache.mFreeBlocks.end());
+                cache.mFreeBlocks.clear();
+                DrainRemote(cache);
+
+                mRetiredCaches.push_back(&cache);
+            }
+
+            // called with mMutex held
+            void DrainRemote(Cache& cache)
+            {
+                for (Block* block = cache.mRemoteFreeBlocks.exchange(nullptr, std::memory_order_acquire); block; block = block->mNext)
+                {
+                    mFreeBlocks.push_back(block);
+                }
+            }
+
+            std::mutex mMutex;
+            std::vector<std::unique_ptr<Block[]>> mLines;
+            std::vector<Block*> mFreeBlocks;
+            std::vector<std::unique_ptr<Cache>> mCaches;
+            // caches of exited threads, reused by new threads, until then blocks freed into them are drained in RefillCache
+            std::vector<Cache*> mRetiredCaches;
+        };
+
+        // caches of calling thread, one per allocator instance it allocated from
+        struct ThreadCache
+        {
+            std::uint64_t mPoolId = 0;
+            std::weak_ptr<Shared> mShared;
+            Cache* mCache = nullptr;
+        };
+
+        struct ThreadCaches
+        {
+            ~ThreadCaches()
+            {
+                for (const auto& threadCache : mCaches)
+                {
+                    if (auto shared = threadCache.mShared.lock())
+                    {
+                        shared->Retire(*threadCache.mCache);
+                    }
+                }
+            }
+
+            std::vector<ThreadCache> mCaches;
+        };
+
+        static ThreadCaches& GetThreadCaches()
+        {
+            thread_local ThreadCaches threadCaches;
+            return threadCaches;
+        }
+
+        // Return cache of calling thread or nullptr if this thread did not allocate from this pool yet
+        Cache* FindCache() const
+        {
+            // key on allocator instance id, one thread can use many allocators
+            for (const auto& threadCache : GetThreadCaches().mCaches)
+            {
+                if (threadCache.mPoolId == mPoolId)
+                {
+                    return threadCache.mCache;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Return cache for calling thread, creating (or reusing retired) one on first use
+        Cache& GetCache()
+        {
+            if (Cache* cache = FindCache())
+            {
+                return *cache;
+            }
+
+            ThreadCaches& threadCaches = GetThreadCaches();
+            // forget caches of destroyed allocators
+            std::erase_if(threadCaches.mCaches, [](const ThreadCache& threadCache) { return threadCache.mShared.expired(); });
+
+            Cache* cache = nullptr;
+            {
+                std::unique_lock<std::mutex> locker(mShared->mMutex);
+                if (mShared->mRetiredCaches.empty())
+                {
+                    cache = mShared->mCaches.emplace_back(std::make_unique<Cache>()).get();
+                }
+                else
+                {
+                    cache = mShared->mRetiredCaches.back();
+                    mShared->mRetiredCaches.pop_back();
+                }
+            }
+
+            threadCaches.mCaches.push_back({ mPoolId, mShared, cache });
+            return *cache;
+        }
+
+        // Take back blocks freed by other threads, otherwise up to BatchSize from shared free list
+        void RefillCache(Cache& cache)
+        {
+            if (Block* block = cache.mRemoteFreeBlocks.exchange(nullptr, std::memory_order_acquire))
+            {
+                for (; block; block = block->mNext)
+                {
+                    cache.mFreeBlocks.push_back(block);
+                }
+
+                return;
+            }
+
+            std::unique_lock<std::mutex> locker(mShared->mMutex);
+            if (mShared->mFreeBlocks.empty())
+            {
+                // blocks freed into caches of exited threads
+                for (Cache* retiredCache : mShared->mRetiredCaches)
+                {
+                    mShared->DrainRemote(*retiredCache);
+                }
+
+                if (mShared->mFreeBlocks.empty())
+                {
+                    AddLine();
+                }
+            }
+
+            const std::size_t numBlocks = std::min(BatchSize, mShared->mFreeBlocks.size());
+            for (std::size_t i = 0; i < numBlocks; ++i)
+            {
+                Block* block = mShared->mFreeBlocks.back();
+                mShared->mFreeBlocks.pop_back();
+
+                block->mOwner = &cache;
+                cache.mFreeBlocks.push_back(block);
+            }
+        }
+
+        // Move numBlocks from cache back to shared free list, so one thread freeing a lot does not hoard memory
+        void ReleaseToShared(Cache& cache, std::size_t numBlocks)
+        {
+            std::unique_lock<std::mutex> locker(mShared->mMutex);
+            for (std::size_t i = 0; i < numBlocks; ++i)
+            {
+                mShared->mFreeBlocks.push_back(cache.mFreeBlocks.back());
+                cache.mFreeBlocks.pop_back();
+            }
+        }
+
+        // called with shared lock held
+        void AddLine()
+        {
+            auto& line = mShared->mLines.emplace_back(std::make_unique<Block[]>(Size));
+            for (int i = Size - 1; i >= 0; --i)
+            {
+                mShared->mFreeBlocks.push_back(&line[i]);
+            }
+        }
+
+        const std::uint64_t mPoolId = internal::NextConcurrentPoolId();
+        std::atomic<std::size_t> mNumAllocated{ 0 };
+        const std::shared_ptr<Shared> mShared = std::make_shared<Shared>();
+    };
+
+} // namespace yaget::memory
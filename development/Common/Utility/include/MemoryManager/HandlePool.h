@@ -0,0 +1,393 @@
+///////////////////////////////////////////////////////////////////////
+// HandlePool.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Pool of objects referenced by generation checked handles
+//      instead of pointers, which allows to move live objects
+//      into fewer lines (compaction) and give empty lines back.
+//      Pointers returned by Get are only valid until next
+//      Compact/MaybeCompact call.
+//
+//
+//  #include "MemoryManager/HandlePool.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "MemoryManager/PoolAllocator.h"
+#include "Core/ErrorHandlers.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+namespace yaget::memory
+{
+    //! Handle to object in HandlePool. U (std::uint32_t or std::uint64_t) is split into
+    //! index into handle table (low bits) and generation (high bits), which is bumped every time
+    //! that index is freed, so stale handles do not resolve to new objects.
+    template <typename U>
+    struct PoolHandle
+    {
+        static_assert(std::is_same_v<U, std::uint32_t> || std::is_same_v<U, std::uint64_t>, "PoolHandle supports only 32 or 64 bit handles.");
+
+        using Value = U;
+        static constexpr int kIndexBits = sizeof(U) == sizeof(std::uint32_t) ? 20 : 32;
+        static constexpr int kGenerationBits = std::numeric_limits<U>::digits - kIndexBits;
+        static constexpr U kIndexMask = (U{ 1 } << kIndexBits) - 1;
+        static constexpr U kGenerationMask = (U{ 1 } << kGenerationBits) - 1;
+        static constexpr U kInvalid = std::numeric_limits<U>::max();
+
+        PoolHandle() = default;
+        PoolHandle(U index, U generation) : mValue((index & kIndexMask) | ((generation & kGenerationMask) << kIndexBits)) {}
+
+        U Index() const { return mValue & kIndexMask; }
+        U Generation() const { return mValue >> kIndexBits; }
+        bool IsValid() const { return mValue != kInvalid; }
+
+        bool operator==(const PoolHandle& other) const = default;
+
+        U mValue = kInvalid;
+    };
+
+    //! When HandlePool::MaybeCompact does any work. Compaction runs when occupancy of all lines drops below
+    //! mMinOccupancy and it would free at least mMinFreeLines lines.
+    struct CompactionPolicy
+    {
+        float mMinOccupancy = 0.5f;
+        std::size_t mMinFreeLines = 2;
+    };
+
+    //! Memory pool with E slots per line (see PoolAllocator), where objects are accessed trough handles.
+    //! Free does not release memory, call MaybeCompact (or Compact) at point where no one holds
+    //! pointers returned by Get, like end of a frame. T must be move constructible to be compacted.
+    template <typename T, int E = internal::GetCapacity<T>(), typename U = std::uint32_t>
+    class HandlePool : public Noncopyable<HandlePool<T, E, U>>
+    {
+        static_assert(E > 0, "Number of Slots for HandlePool line must be bigger then 0.");
+
+    public:
+        static constexpr int Size = E;
+        using Type = T;
+        using Handle = PoolHandle<U>;
+
+        explicit HandlePool(const CompactionPolicy& policy = {}) : mPolicy(policy)
+        {}
+
+        ~HandlePool()
+        {
+            YAGET_ASSERT(mNumAllocated == 0, "HandlePool for '%s' still has outstanding '%d' allocation(s).", typeid(T).name(), mNumAllocated);
+        }
+
+        template<typename... Args>
+        Handle Allocate(Args&&... args)
+        {
+            // claim handle entry first, so we do not need to undo slot allocation if we run out of handles
+            const U index = ClaimEntry();
+            const U lineIndex = GetFreeLine();
+            Line& line = *mLines[lineIndex];
+
+            T* instance = nullptr;
+            try
+            {
+                // line gives slot back if constructor fails
+                instance = line.mObjects.Allocate(std::forward<Args>(args)...);
+            }
+            catch (const ex::bad_init&)
+            {
+                mFreeEntries.push_back(index);
+                throw;
+            }
+
+            if (line.mObjects.IsFull())
+            {
+                mFreeLines.pop_back();
+            }
+
+            line.mEntries[line.mObjects.GetSlotIndex(instance)] = index;
+
+            Entry& entry = mEntries[index];
+            entry.mObject = instance;
+            entry.mLine = lineIndex;
+
+            ++mNumAllocated;
+            mHighWaterMark = std::max(mHighWaterMark, mNumAllocated);
+            return Handle(index, entry.mGeneration);
+        }
+
+        void Free(Handle handle)
+        {
+            Entry* entry = FindEntry(handle);
+            YAGET_ASSERT(entry, "Invalid handle '%d' for '%s' (double-delete?).", handle.mValue, typeid(T).name());
+
+            FreeObject(entry->mLine, entry->mObject);
+
+            entry->mObject = nullptr;
+            entry->mGeneration = (entry->mGeneration + 1) & Handle::kGenerationMask;
+            mFreeEntries.push_back(handle.Index());
+            --mNumAllocated;
+        }
+
+        // Return object for handle or nullptr if handle is stale or invalid.
+        // Pointer is only valid until next compaction.
+        T* Get(Handle handle) const
+        {
+            const Entry* entry = FindEntry(handle);
+            return entry ? entry->mObject : nullptr;
+        }
+
+        bool IsValid(Handle handle) const { return FindEntry(handle) != nullptr; }
+
+        // Call callback(Handle handle, T& element) for each allocated element in memory order.
+        template <typename C>
+        void ForEachAllocated(C&& callback)
+        {
+            for (auto& line : mLines)
+            {
+                if (line)
+                {
+                    line->mObjects.ForEachUsed([this, &line, &callback](T& element)
+                    {
+                        const U index = line->mEntries[line->mObjects.GetSlotIndex(&element)];
+                        callback(Handle(index, mEntries[index].mGeneration), element);
+                    });
+                }
+            }
+        }
+
+        // Move live objects into fewest lines possible, keeping the fullest lines in place,
+        // and release all lines which end up empty. Return number of moved objects.
+        std::size_t Compact()
+        {
+            static_assert(std::is_move_constructible_v<T>, "HandlePool can only compact move constructible types.");
+
+            std::vector<U> lineIndexes;
+            for (U i = 0; i < mLines.size(); ++i)
+            {
+                if (mLines[i])
+                {
+                    lineIndexes.push_back(i);
+                }
+            }
+
+            // fullest lines first, those are the ones we keep
+            std::sort(lineIndexes.begin(), lineIndexes.end(), [this](U lhs, U rhs)
+            {
+                const int lhsUsed = mLines[lhs]->mObjects.NumUsed();
+                const int rhsUsed = mLines[rhs]->mObjects.NumUsed();
+                return lhsUsed > rhsUsed || (lhsUsed == rhsUsed && lhs < rhs);
+            });
+
+            const std::size_t numKeepLines = (mNumAllocated + Size - 1) / Size;
+            std::size_t numMoved = 0;
+            std::size_t destination = 0;
+
+            for (std::size_t source = numKeepLines; source < lineIndexes.size(); ++source)
+            {
+                Line& sourceLine = *mLines[lineIndexes[source]];
+                sourceLine.mObjects.ForEachUsed([&](T& element)
+                {
+                    while (mLines[lineIndexes[destination]]->mObjects.IsFull())
+                    {
+                        ++destination;
+                    }
+
+                    const U destinationLineIndex = lineIndexes[destination];
+                    Line& destinationLine = *mLines[destinationLineIndex];
+
+                    const U index = sourceLine.mEntries[sourceLine.mObjects.GetSlotIndex(&element)];
+                    T* instance = destinationLine.mObjects.Allocate(std::move(element));
+                    sourceLine.mObjects.Free(&element);
+
+                    destinationLine.mEntries[destinationLine.mObjects.GetSlotIndex(instance)] = index;
+                    Entry& entry = mEntries[index];
+                    entry.mObject = instance;
+                    entry.mLine = destinationLineIndex;
+                    ++numMoved;
+                });
+            }
+
+            if (!ReleaseEmptyLines())
+            {
+                // some destination lines may be full now
+                RebuildFreeLines();
+            }
+            ++mNumCompactions;
+            return numMoved;
+        }
+
+        // Compact if policy says so, return number of moved objects
+        std::size_t MaybeCompact()
+        {
+            return ShouldCompact() ? Compact() : 0;
+        }
+
+        bool ShouldCompact() const
+        {
+            const PoolStats stats = GetStats();
+            const std::size_t numNeededLines = (stats.mNumAllocated + Size - 1) / Size;
+            return stats.mNumLines >= numNeededLines + mPolicy.mMinFreeLines && stats.Occupancy() < mPolicy.mMinOccupancy;
+        }
+
+        // Release empty lines without moving any objects, return number of released lines
+        std::size_t ReleaseEmptyLines()
+        {
+            std::size_t numReleased = 0;
+            for (U i = 0; i < mLines.size(); ++i)
+            {
+                if (mLines[i] && mLines[i]->mObjects.IsEmpty())
+                {
+                    mLines[i].reset();
+                    mReleasedLines.push_back(i);
+                    ++numReleased;
+                }
+            }
+
+            if (numReleased)
+            {
+                RebuildFreeLines();
+            }
+
+            mNumReleasedLines += numReleased;
+            return numReleased;
+        }
+
+        const CompactionPolicy& GetPolicy() const { return mPolicy; }
+        void SetPolicy(const CompactionPolicy& policy) { mPolicy = policy; }
+
+        std::size_t NumAllocated() const { return mNumAllocated; }
+        std::size_t NumLines() const { return mLines.size() - mReleasedLines.size(); }
+        std::size_t Capacity() const { return NumLines() * Size; }
+        std::size_t NumCompactions() const { return mNumCompactions; }
+
+        PoolStats GetStats() const
+        {
+            return { NumLines(), mNumAllocated, Capacity(), mHighWaterMark, mNumReleasedLines };
+        }
+
+    private:
+        struct Entry
+        {
+            T* mObject = nullptr;
+            U mLine = 0;
+            U mGeneration = 0;
+        };
+
+        // pool line (see PoolAllocator) with index into mEntries for each slot, so compaction can fix up handle table
+        struct Line
+        {
+            internal::PoolAllocatorLine<T, E> mObjects;
+            std::array<U, E> mEntries{};
+        };
+
+        const Entry* FindEntry(Handle handle) const
+        {
+            if (!handle.IsValid() || handle.Index() >= mEntries.size())
+            {
+                return nullptr;
+            }
+
+            const Entry& entry = mEntries[handle.Index()];
+            return entry.mObject && entry.mGeneration == handle.Generation() ? &entry : nullptr;
+        }
+
+        Entry* FindEntry(Handle handle)
+        {
+            return const_cast<Entry*>(std::as_const(*this).FindEntry(handle));
+        }
+
+        U ClaimEntry()
+        {
+            if (!mFreeEntries.empty())
+            {
+                const U index = mFreeEntries.back();
+                mFreeEntries.pop_back();
+                return index;
+            }
+
+            error_handlers::ThrowOnCheck(mEntries.size() < Handle::kIndexMask, fmt::format("HandlePool for '{}' run out of handles, max: '{}'.", typeid(T).name(), Handle::kIndexMask));
+            mEntries.emplace_back();
+            return static_cast<U>(mEntries.size() - 1);
+        }
+
+        // Return index of line with free slot, which is on top of mFreeLines
+        U GetFreeLine()
+        {
+            if (mFreeLines.empty())
+            {
+                AddLine();
+            }
+
+            return mFreeLines.back();
+        }
+
+        // destroy object and make line available for allocations if it was full
+        void FreeObject(U lineIndex, T* object)
+        {
+            Line& line = *mLines[lineIndex];
+            if (line.mObjects.IsFull())
+            {
+                mFreeLines.push_back(lineIndex);
+            }
+
+            line.mObjects.Free(object);
+        }
+
+        // collect all lines which are not full, lowest index on top
+        void RebuildFreeLines()
+        {
+            mFreeLines.clear();
+            for (U i = static_cast<U>(mLines.size()); i-- > 0;)
+            {
+                if (mLines[i] && !mLines[i]->mObjects.IsFull())
+                {
+                    mFreeLines.push_back(i);
+                }
+            }
+        }
+
+        void AddLine()
+        {
+            U lineIndex = 0;
+            if (!mReleasedLines.empty())
+            {
+                lineIndex = mReleasedLines.back();
+                mReleasedLines.pop_back();
+                mLines[lineIndex] = std::make_unique<Line>();
+            }
+            else
+            {
+                lineIndex = static_cast<U>(mLines.size());
+                mLines.emplace_back(std::make_unique<Line>());
+            }
+
+            mFreeLines.push_back(lineIndex);
+        }
+
+        CompactionPolicy mPolicy;
+
+        // handle table, indexed by Handle::Index()
+        std::vector<Entry> mEntries;
+        std::vector<U> mFreeEntries;
+
+        std::vector<std::unique_ptr<Line>> mLines;
+        // lines which are not full, top one is used for allocations
+        std::vector<U> mFreeLines;
+        // indexes of lines which memory was released (nullptr in mLines)
+        std::vector<U> mReleasedLines;
+
+        std::size_t mNumAllocated = 0;
+        std::size_t mHighWaterMark = 0;
+        std::size_t mNumReleasedLines = 0;
+        std::size_t mNumCompactions = 0;
+    };
+
+} // namespace yaget::memory
@@ -7,12 +7,13 @@
 //
 //  NOTES:
 //      Memory pool allocator with compile time memory size
-//      Needed header if using memory::New(...)
+//      Needed header if using memory::New(...), NewShared(...) or NewUnique(...)
 //      #include <functional>
 //      
 //      Possible extra include needed
 //          #include "Exception/Exception.h"
 //      
+//      Live objects of each T (over all pools) are traced as Pool.<type> counter track.
 //
 //
 //  #include "MemoryManager/PoolAllocator.h"
@@ -24,12 +25,22 @@
 
 #include "HashUtilities.h"
 #include "YagetCore.h"
+#include "Metrics/Concurrency.h"
 #include "Metrics/Gather.h"
+#include "Meta/CompilerAlgo.h"
 #include "Debugging/Assert.h"
 #include "Exception/Exception.h"
+#include <algorithm>
+#include <bit>
 #include <bitset>
+#include <cstdint>
 #include <array>
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 
 
 namespace yaget
@@ -39,8 +50,12 @@ namespace yaget
         namespace internal
         {
             //! Represents one line of memory block. It keeps track which slots
-            //! are occupied, by using bitset. T represent object type to manage and E specifies number of slots.
+            //! are occupied, by using 64 bit words (bit set means slot is used). T represent object type to manage and E specifies number of slots.
             //! Typical value for that is 32 or 64.
+            //! Free slot is found with countr_zero on summary mask of words which still have free slots, and then on the word itself,
+            //! so claiming a slot does not depend on E (up to 4096 slots, one summary word).
+            //! Objects are stored contiguously without any per slot header, aligned to alignof(T),
+            //! slot of an object is it's index in that memory.
             //! This class is used by PoolAllocator class and not design for external use
             template <typename T, int E>
             class PoolAllocatorLine : public Noncopyable<PoolAllocatorLine<T, E>>
@@ -50,36 +65,38 @@ namespace yaget
             public:
                 static constexpr int INVALID_SLOT = -1;
 
-                struct BlockHeader
-                {
-                    int mSlotIndex;
-                    int mLineIndex;
-                };
-
                 PoolAllocatorLine(PoolAllocatorLine<T, E>&& other) noexcept
-                    : mFlags(std::move(other.mFlags))
-                    , mMemory(std::move(other.mMemory))
+                    : mMemory(std::move(other.mMemory))
+                    , mUsedWords(std::move(other.mUsedWords))
+                    , mFreeWords(std::move(other.mFreeWords))
+                    , mNumUsed(std::exchange(other.mNumUsed, 0))
                 {}
 
                 PoolAllocatorLine& operator=(PoolAllocatorLine<T, E>&& other) noexcept
                 {
                     if (this != &other)
                     {
-                        if (!IsEmpty())
-                        {
-                            
-                        }
-                        mFlags = std::move(other.mFlags);
                         mMemory = std::move(other.mMemory);
+                        mUsedWords = std::move(other.mUsedWords);
+                        mFreeWords = std::move(other.mFreeWords);
+                        mNumUsed = std::exchange(other.mNumUsed, 0);
                     }
 
                     return *this;
                 }
 
-                PoolAllocatorLine() = default;
+                PoolAllocatorLine()
+                {
+                    // every word has free slots
+                    for (std::size_t i = 0; i < kNumWords; ++i)
+                    {
+                        mFreeWords[i / kWordBits] |= kOne << (i % kWordBits);
+                    }
+                }
+
                 ~PoolAllocatorLine()
                 {
-                    YAGET_ASSERT(mFlags.none(), "PoolAllocatorLine for '%s' still has outstanding '%d' allocation(s).", typeid(T).name(), mFlags.count());
+                    YAGET_ASSERT(IsEmpty(), "PoolAllocatorLine for '%s' still has outstanding '%d' allocation(s).", typeid(T).name(), mNumUsed);
                 }
 
                 //! Caller must assure that there is free slot, otherwise this method will assert.
@@ -93,15 +110,10 @@ namespace yaget
                         YM_GATHER(ClaimFreeSlot);
                         freeSlot = ClaimFreeSlot();
                     }
-                    // get the memory where this slot starts
-                    char* memoryBlock = &mMemory[freeSlot * kStrideSize];
 
-                    // initialize BlockHeader
-                    (void)new(memoryBlock) BlockHeader({ freeSlot, PoolAllocatorLine::INVALID_SLOT });
-                    // advance memory passed BlockHeader and use placement new T
                     try
                     {
-                        char* objectMemory = memoryBlock + kHeaderSize;
+                        void* objectMemory = &mMemory[freeSlot];
 
                         T* instance = nullptr;
                         if constexpr (std::is_constructible_v<T, Args...>)
@@ -121,7 +133,7 @@ namespace yaget
                     }
                     catch (const ex::bad_init& e)
                     {
-                        ResetSlot(freeSlot);
+                        ReleaseSlot(freeSlot);
                         YAGET_ASSERT(false, "Examine this bad_init excpetion: '%s'.", e.what());
                         throw;
                     }
@@ -129,95 +141,129 @@ namespace yaget
 
                 void Free(T* allocatedMemory)
                 {
-                    BlockHeader* blockHeader = GetBlockHeader(allocatedMemory);
-                    YAGET_ASSERT(blockHeader->mSlotIndex != INVALID_SLOT, "Memory slot for '%s' is not marked as allocated.", typeid(T).name());
+                    const int slotId = GetSlotIndex(allocatedMemory);
+                    YAGET_ASSERT(IsUsed(slotId), "Memory slot '%d' for '%s' is not marked as allocated.", slotId, typeid(T).name());
 
                     allocatedMemory->~T();
-                    mFlags[blockHeader->mSlotIndex] = false;
-                    blockHeader->mSlotIndex = INVALID_SLOT;
+                    ReleaseSlot(slotId);
                 }
 
-                bool IsFull() const { return mFlags.all(); }
-                bool IsEmpty() const { return mFlags.none(); }
+                bool IsFull() const { return mNumUsed == E; }
+                bool IsEmpty() const { return mNumUsed == 0; }
+                int NumUsed() const { return mNumUsed; }
+
+                bool IsUsed(int slotId) const
+                {
+                    return (mUsedWords[slotId / kWordBits] >> (slotId % kWordBits)) & kOne;
+                }
 
                 using HashResult = size_t;
                 HashResult ToHash() const
                 {
-                    if constexpr (std::numeric_limits<HashResult>::digits >= E)
+                    HashResult currentHash{};
+                    for (const auto& word : mUsedWords)
                     {
-                        const std::hash<HashResult> hasher;
-                        return hasher(mFlags.to_ullong());
+                        conv::hash_combine(currentHash, word);
                     }
-                    else
+
+                    return currentHash;
+                }
+
+                // Return first used slot starting at slotId (inclusive), or INVALID_SLOT if there is none.
+                // Scans whole occupancy words, not bits.
+                int GetNextUsedSlot(int slotId) const
+                {
+                    if (slotId == INVALID_SLOT || slotId >= E || IsEmpty())
+                    {
+                        return INVALID_SLOT;
+                    }
+
+                    if (IsFull())
+                    {
+                        return slotId;
+                    }
+
+                    std::size_t wordIndex = slotId / kWordBits;
+                    // ignore slots before slotId in first word
+                    Word word = mUsedWords[wordIndex] & (~Word{ 0 } << (slotId % kWordBits));
+                    while (!word && ++wordIndex < kNumWords)
                     {
-                        const std::hash<std::string> hasher;
-                        return hasher(mFlags.to_string());
+                        word = mUsedWords[wordIndex];
                     }
+
+                    return word ? static_cast<int>(wordIndex) * kWordBits + std::countr_zero(word) : INVALID_SLOT;
                 }
 
-                int GetNextUsedSlot(int slotId) const
+                // Call callback(T& element) for each allocated element in slot order.
+                // Callback can free element passed to it, but not any other element of this line.
+                template <typename C>
+                void ForEachUsed(C&& callback)
                 {
-                    if (slotId != INVALID_SLOT)
+                    for (std::size_t wordIndex = 0; wordIndex < kNumWords; ++wordIndex)
                     {
-                        if (IsFull())
+                        for (Word word = mUsedWords[wordIndex]; word; word &= word - 1)
                         {
-                            return slotId;
-                        }
-                        else
-                        {
-                            for (size_t i = slotId; i < mFlags.size(); ++i)
-                            {
-                                if (mFlags.test(i))
-                                {
-                                    return static_cast<int>(i);
-                                }
-                            }
+                            const std::size_t slotId = wordIndex * kWordBits + std::countr_zero(word);
+                            callback(*std::launder(reinterpret_cast<T*>(&mMemory[slotId])));
                         }
                     }
-
-                    return INVALID_SLOT;
                 }
 
                 T* GetElement(int slotId)
                 {
                     YAGET_ASSERT(slotId != INVALID_SLOT && slotId < E, "Memory slot parameter '%d' for '%s' is invalid.", slotId, typeid(T).name());
+                    YAGET_ASSERT(IsUsed(slotId), "Memory slot index '%d' for '%s' is not marked as allocated.", slotId, typeid(T).name());
 
-                    char* memoryBlock = &mMemory[slotId * kStrideSize] + kHeaderSize;
-                    T* element = reinterpret_cast<T*>(memoryBlock);
-
-                    YAGET_ASSERT(GetBlockHeader(element)->mSlotIndex != INVALID_SLOT, "Memory slot index '%d' for '%s' is not marked as allocated.", slotId, typeid(T).name());
-
-                    return element;
+                    return std::launder(reinterpret_cast<T*>(&mMemory[slotId]));
                 }
 
-                static BlockHeader* GetBlockHeader(T* instance)
+                // Slot index of instance, which must be allocated from this line
+                int GetSlotIndex(const T* instance) const
                 {
-                    YAGET_ASSERT(instance, "Param instance of type '%s' is nullptr.", typeid(T).name());
-                    char* objectMemory = reinterpret_cast<char*>(instance);
-                    char* memoryBlock = objectMemory - kHeaderSize;
-                    BlockHeader* blockHeader = reinterpret_cast<BlockHeader*>(memoryBlock);
-                    return blockHeader;
+                    YAGET_ASSERT(Contains(instance), "Param instance of type '%s' does not belong to this line.", typeid(T).name());
+                    return static_cast<int>(reinterpret_cast<const Storage*>(instance) - mMemory.data());
                 }
 
-            private:
-                void ResetSlot(int slotId)
+                bool Contains(const T* instance) const
                 {
-                    char* memoryBlock = &mMemory[slotId * kStrideSize];
-                    BlockHeader* blockHeader = reinterpret_cast<BlockHeader*>(memoryBlock);
-                    blockHeader->mSlotIndex = INVALID_SLOT;
-                    mFlags[slotId] = false;
+                    const auto* storage = reinterpret_cast<const Storage*>(instance);
+                    return storage >= mMemory.data() && storage < mMemory.data() + E;
                 }
 
+                // start of memory for all slots, used to find line which owns an instance
+                std::uintptr_t GetMemoryAddress() const { return reinterpret_cast<std::uintptr_t>(mMemory.data()); }
+                static constexpr std::size_t kMemorySize = sizeof(T) * E;
+
+            private:
+                using Word = std::uint64_t;
+                static constexpr int kWordBits = std::numeric_limits<Word>::digits;
+                static constexpr Word kOne = 1;
+                static constexpr std::size_t kNumWords = (E + kWordBits - 1) / kWordBits;
+                static constexpr std::size_t kNumSummaryWords = (kNumWords + kWordBits - 1) / kWordBits;
+
                 int ClaimFreeSlot()
                 {
                     YAGET_ASSERT(!IsFull(), "PoolAllocatorLine is out of memory for '%s'", typeid(T).name());
 
-                    for (size_t i = 0; i < mFlags.size(); ++i)
+                    for (std::size_t summaryIndex = 0; summaryIndex < kNumSummaryWords; ++summaryIndex)
                     {
-                        if (!mFlags[i])
+                        if (const Word freeWords = mFreeWords[summaryIndex])
                         {
-                            mFlags[i] = true;
-                            return static_cast<int>(i);
+                            const std::size_t wordIndex = summaryIndex * kWordBits + std::countr_zero(freeWords);
+                            Word& usedWord = mUsedWords[wordIndex];
+
+                            const int bitIndex = std::countr_zero(static_cast<Word>(~usedWord));
+                            const int slotId = static_cast<int>(wordIndex) * kWordBits + bitIndex;
+                            YAGET_ASSERT(slotId < E, "Claimed slot '%d' is out of range for '%s'", slotId, typeid(T).name());
+
+                            usedWord |= kOne << bitIndex;
+                            if (usedWord == FullWordMask(wordIndex))
+                            {
+                                mFreeWords[summaryIndex] &= ~(kOne << (wordIndex % kWordBits));
+                            }
+
+                            ++mNumUsed;
+                            return slotId;
                         }
                     }
 
@@ -225,12 +271,34 @@ namespace yaget
                     return INVALID_SLOT;
                 }
 
+                void ReleaseSlot(int slotId)
+                {
+                    const std::size_t wordIndex = slotId / kWordBits;
+                    YAGET_ASSERT(IsUsed(slotId), "Memory slot '%d' for '%s' is not marked as allocated.", slotId, typeid(T).name());
+
+                    mUsedWords[wordIndex] &= ~(kOne << (slotId % kWordBits));
+                    mFreeWords[wordIndex / kWordBits] |= kOne << (wordIndex % kWordBits);
+                    --mNumUsed;
+                }
+
+                // all bits which represent valid slots in word, last word may be partially used
+                static constexpr Word FullWordMask(std::size_t wordIndex)
+                {
+                    constexpr int kTailBits = E % kWordBits;
+                    if (kTailBits && wordIndex == kNumWords - 1)
+                    {
+                        return (kOne << kTailBits) - 1;
+                    }
+
+                    return ~Word{ 0 };
+                }
+
                 // run dtor's on all allocated objects
                 void ClearLine()
                 {
-                    for (size_t i = 0; i < mFlags.size(); ++i)
+                    for (int i = 0; i < E; ++i)
                     {
-                        if (mFlags[i])
+                        if (IsUsed(i))
                         {
                             T* element = GetElement(i);
                             Free(element);
@@ -238,17 +306,20 @@ namespace yaget
                     }
                 }
 
-                static constexpr size_t kElementSize = sizeof(T);
-                static constexpr size_t kHeaderSize = sizeof(BlockHeader);
-                static constexpr size_t kStrideSize = kElementSize + kHeaderSize;
-                static constexpr size_t kOverheadSize = E * kHeaderSize;
+                // raw memory for one T, keeps T's alignment, so sizeof(Storage) == sizeof(T)
+                struct alignas(T) Storage
+                {
+                    std::byte mBytes[sizeof(T)];
+                };
 
-                // we keep track which slots are allocated and which one are free
-                std::bitset<E> mFlags{};
-                // memory block representing T's
-                // memory layout: BlockHeader|T|BlockHeader|T|...
+                // memory block representing T's, layout: T|T|T|...
                 // memory returned to user points to T in that slot
-                std::array<char, kStrideSize * E> mMemory{};
+                std::array<Storage, E> mMemory;
+                // we keep track which slots are allocated (bit set) and which one are free
+                std::array<Word, kNumWords> mUsedWords{};
+                // bit per word in mUsedWords, set when that word still has free slot
+                std::array<Word, kNumSummaryWords> mFreeWords{};
+                int mNumUsed = 0;
             };
 
             template<typename T>
@@ -269,16 +340,38 @@ namespace yaget
                 }
             }
 
+            // Live objects of T shared by all pools of T (any E). Never destroyed, so pools with static
+            // storage duration can still free elements during shutdown.
+            template<typename T>
+            metrics::Gauge& PoolLiveObjects()
+            {
+                static metrics::Gauge& liveObjects = *new metrics::Gauge(metrics::MakeTraceName("Pool.", meta::type_name<T>()));
+                return liveObjects;
+            }
+
         } // namespace internal
 
+        //! Memory usage snapshot of pool allocator
+        struct PoolStats
+        {
+            std::size_t mNumLines = 0;          // number of memory lines currently held
+            std::size_t mNumAllocated = 0;      // number of live elements
+            std::size_t mCapacity = 0;          // number of elements all lines can hold
+            std::size_t mHighWaterMark = 0;     // the most live elements at any one time
+            std::size_t mNumReleasedLines = 0;  // total number of lines given back to OS
+
+            // fraction of capacity in use, 0 when there are no lines
+            float Occupancy() const { return mCapacity ? static_cast<float>(mNumAllocated) / static_cast<float>(mCapacity) : 0.0f; }
+        };
+
         //! Provides memory management. It uses memory lines with the same number of slots
         //! and will add new line if all the lines are full.
         //! It does not provide GC and it's up to user to call Free.
         //! T can provide static capacity member:
         //!         static constexpr int Capacity = <number_of_slots_per_line_in_memory_pool>;
         //! If Capacity does not exist, default what 1, unless user provided E value.
-        //! TODO: Do we want to add some kind of compaction? This would mean that pointers would need
-        //! to be changed,
+        //! Elements never move, so there is no compaction, but lines which become empty can be given
+        //! back with ReleaseEmptyLines. See HandlePool for compacting pool with stable handles.
         template <typename T, int E = internal::GetCapacity<T>()>
         class PoolAllocator : public Noncopyable<PoolAllocator<T, E>>
         {
@@ -293,16 +386,27 @@ namespace yaget
 
             PoolAllocator(PoolAllocator<T, E>&& other) noexcept
                 : mMemoryLines(std::move(other.mMemoryLines))
+                , mFreeLines(std::move(other.mFreeLines))
+                , mReleasedLines(std::move(other.mReleasedLines))
+                , mLinePages(std::move(other.mLinePages))
                 , mLastLineIndex(std::move(other.mLastLineIndex))
-            {
-            }
+                , mNumAllocated(std::exchange(other.mNumAllocated, 0))
+                , mHighWaterMark(std::exchange(other.mHighWaterMark, 0))
+                , mNumReleasedLines(std::exchange(other.mNumReleasedLines, 0))
+            {}
 
             PoolAllocator& operator=(PoolAllocator<T, E>&& other) noexcept
             {
                 if (this != &other)
                 {
                     mMemoryLines = std::move(other.mMemoryLines);
+                    mFreeLines = std::move(other.mFreeLines);
+                    mReleasedLines = std::move(other.mReleasedLines);
+                    mLinePages = std::move(other.mLinePages);
                     mLastLineIndex = std::move(other.mLastLineIndex);
+                    mNumAllocated = std::exchange(other.mNumAllocated, 0);
+                    mHighWaterMark = std::exchange(other.mHighWaterMark, 0);
+                    mNumReleasedLines = std::exchange(other.mNumReleasedLines, 0);
                 }
 
                 return *this;
@@ -319,25 +423,15 @@ namespace yaget
 
                     if (mLastLineIndex == PoolLine::INVALID_SLOT)
                     {
-                        int lineIndex = PoolLine::INVALID_SLOT;
-
-                        // find first available line which is not full yet
-                        auto it = std::find_if(mMemoryLines.begin(), mMemoryLines.end(), [](const PoolLinePtr& line) { return !line->IsFull(); });
-                        if (it == mMemoryLines.end())
+                        // take any line which is not full yet, or add a new one
+                        if (mFreeLines.empty())
                         {
-                            mMemoryLines.emplace_back(std::make_unique<PoolLine>());
-
-                            lineIndex = static_cast<int>(mMemoryLines.size() - 1);
-                            currentLine = mMemoryLines.back().get();
-
-                        }
-                        else
-                        {
-                            lineIndex = static_cast<int>(std::distance(mMemoryLines.begin(), it));
-                            currentLine = it->get();
+                            AddLine();
                         }
 
-                        mLastLineIndex = lineIndex;
+                        mLastLineIndex = mFreeLines.back();
+                        mFreeLines.pop_back();
+                        currentLine = mMemoryLines[mLastLineIndex].get();
                     }
                     else
                     {
@@ -349,24 +443,103 @@ namespace yaget
                 // pass this line if exception throw
                 T* instance = currentLine->Allocate(std::forward<Args>(args)...);
 
-                YM_GATHER_PARENT(AllocateLine);
-                auto* blockHeader = PoolLine::GetBlockHeader(instance);
-                blockHeader->mLineIndex = mLastLineIndex;
-
                 // check if current line still has any slots left
                 mLastLineIndex = currentLine->IsFull() ? PoolLine::INVALID_SLOT : mLastLineIndex;
+                ++mNumAllocated;
+                mHighWaterMark = std::max(mHighWaterMark, mNumAllocated);
+                internal::PoolLiveObjects<T>().Add(1);
                 return instance;
             }
 
+            // Make sure there is enough free slots for numElements more allocations,
+            // so bulk allocations do not add lines one at the time.
+            void Reserve(std::size_t numElements)
+            {
+                const std::size_t numFree = Capacity() - mNumAllocated;
+                if (numElements > numFree)
+                {
+                    const std::size_t numNewLines = (numElements - numFree + Size - 1) / Size;
+                    mMemoryLines.reserve(mMemoryLines.size() + numNewLines - std::min(numNewLines, mReleasedLines.size()));
+                    mLinePages.reserve(NumLines() + numNewLines);
+                    for (std::size_t i = 0; i < numNewLines; ++i)
+                    {
+                        AddLine();
+                    }
+                }
+            }
+
+            // Number of currently allocated elements
+            std::size_t NumAllocated() const { return mNumAllocated; }
+
+            // Number of elements all memory lines can hold
+            std::size_t Capacity() const { return NumLines() * Size; }
+
+            // Number of memory lines currently held
+            std::size_t NumLines() const { return mMemoryLines.size() - mReleasedLines.size(); }
+
+            // Give memory of empty lines back, keeping at least keepFreeSlots free slots around
+            // to avoid adding lines right back. Allocated elements are not moved.
+            // Return number of released lines.
+            std::size_t ReleaseEmptyLines(std::size_t keepFreeSlots = 0)
+            {
+                std::size_t numFree = Capacity() - mNumAllocated;
+                std::size_t numReleased = 0;
+
+                auto releaseLine = [this, &numFree, &numReleased, keepFreeSlots](int lineIndex)
+                {
+                    if (mMemoryLines[lineIndex]->IsEmpty() && numFree >= keepFreeSlots + Size)
+                    {
+                        ReleaseLine(lineIndex);
+                        numFree -= Size;
+                        ++numReleased;
+                        return true;
+                    }
+
+                    return false;
+                };
+
+                // release from the back, so lines at the front are the ones we keep allocating from
+                std::sort(mFreeLines.begin(), mFreeLines.end());
+                for (auto it = mFreeLines.rbegin(); it != mFreeLines.rend(); ++it)
+                {
+                    if (releaseLine(*it))
+                    {
+                        *it = PoolLine::INVALID_SLOT;
+                    }
+                }
+                std::erase(mFreeLines, PoolLine::INVALID_SLOT);
+
+                if (mLastLineIndex != PoolLine::INVALID_SLOT && releaseLine(mLastLineIndex))
+                {
+                    mLastLineIndex = PoolLine::INVALID_SLOT;
+                }
+
+                mNumReleasedLines += numReleased;
+                return numReleased;
+            }
+
+            PoolStats GetStats() const
+            {
+                return { NumLines(), mNumAllocated, Capacity(), mHighWaterMark, mNumReleasedLines };
+            }
+
             void Free(T* allocatedMemory)
             {
                 // Potential place to lock (if MT)
-                auto* blockHeader = PoolLine::GetBlockHeader(allocatedMemory);
-                YAGET_ASSERT(blockHeader->mLineIndex != PoolLine::INVALID_SLOT, "Invalid Component '%s' deletion (double-delete?).", typeid(T).name());
-                mMemoryLines[blockHeader->mLineIndex]->Free(allocatedMemory);
-                blockHeader->mLineIndex = PoolLine::INVALID_SLOT;
+                const int lineIndex = FindLineIndex(allocatedMemory);
+                YAGET_ASSERT(lineIndex != PoolLine::INVALID_SLOT, "Invalid Component '%s' deletion, it does not belong to this pool.", typeid(T).name());
+
+                PoolLine& line = *mMemoryLines[lineIndex];
 
-                // TODO: If we want to handle removing empty lines, we will also need to adjust mLineIndex in BlockHeader
+                // full lines are not tracked anywhere, after this free it's available again
+                const bool wasFull = line.IsFull();
+                line.Free(allocatedMemory);
+                if (wasFull)
+                {
+                    mFreeLines.push_back(lineIndex);
+                }
+                --mNumAllocated;
+                internal::PoolLiveObjects<T>().Add(-1);
             }
 
             size_t ToHash() const
@@ -376,6 +549,11 @@ namespace yaget
 
                 for (const auto& line : mMemoryLines)
                 {
+                    if (!line)
+                    {
+                        continue;
+                    }
+
             		size_t lineHashValue = lineHasher(*line.get());
                     conv::hash_combine(currentHash, lineHashValue);
                 }
@@ -480,10 +658,34 @@ namespace yaget
                 return Iterator();
             }
 
-        private:
+            // Call callback(T& element) for each allocated element, in the same order as Iterator,
+            // skipping empty lines and free slots a word at the time. Callback can Free element passed to it.
+            template <typename C>
+            void ForEachAllocated(C&& callback)
+            {
+                for (auto& line : mMemoryLines)
+                {
+                    if (line && !line->IsEmpty())
+                    {
+                        line->ForEachUsed(callback);
+                    }
+                }
+            }
+
             // first  - line index
             // second - element/slot index
             using PoolLineSlot = std::pair<int, int>;
+
+            // Return line and slot index of allocated element
+            PoolLineSlot Locate(const T* allocatedMemory) const
+            {
+                const int lineIndex = FindLineIndex(allocatedMemory);
+                YAGET_ASSERT(lineIndex != PoolLine::INVALID_SLOT, "Element '%s' does not belong to this pool.", typeid(T).name());
+
+                return { lineIndex, mMemoryLines[lineIndex]->GetSlotIndex(allocatedMemory) };
+            }
+
+        private:
             PoolLineSlot GetNextUsedSlot(int poolLineId, int slotId) const
             {
                 if (slotId >= Size)
@@ -492,21 +694,20 @@ namespace yaget
                     ++poolLineId;
                 }
 
-                if (poolLineId != PoolLine::INVALID_SLOT && poolLineId < mMemoryLines.size())
+                if (poolLineId != PoolLine::INVALID_SLOT)
                 {
-                    if (mMemoryLines[poolLineId]->IsFull())
-                    {
-                        return { poolLineId, slotId };
-                    }
-                    else
+                    // only first line starts at slotId, rest are scanned from the beginning
+                    for (std::size_t i = poolLineId; i < mMemoryLines.size(); ++i, slotId = 0)
                     {
-                        for (size_t i = poolLineId; i < mMemoryLines.size(); ++i)
+                        if (!mMemoryLines[i])
                         {
-                            slotId = mMemoryLines[i]->GetNextUsedSlot(slotId);
-                            if (slotId != PoolLine::INVALID_SLOT)
-                            {
-                                return { static_cast<int>(i), slotId };
-                            }
+                            continue;
+                        }
+
+                        const int usedSlot = mMemoryLines[i]->GetNextUsedSlot(slotId);
+                        if (usedSlot != PoolLine::INVALID_SLOT)
+                        {
+                            return { static_cast<int>(i), usedSlot };
                         }
                     }
                 }
@@ -526,9 +727,166 @@ namespace yaget
                 return mMemoryLines[poolLineId]->GetElement(slotId);
             }
 
+            // Index of line which memory contains element, or INVALID_SLOT.
+            // Line memory is kMemorySize long and page is not bigger, so there is at most one line start per page
+            // and line of an element starts in element's page or in one of two pages before it.
+            int FindLineIndex(const T* element) const
+            {
+                const std::uintptr_t page = reinterpret_cast<std::uintptr_t>(element) / kLinePageSize;
+                for (std::uintptr_t i = 0; i < 3 && i <= page; ++i)
+                {
+                    auto it = mLinePages.find(page - i);
+                    if (it != mLinePages.end() && mMemoryLines[it->second]->Contains(element))
+                    {
+                        return it->second;
+                    }
+                }
+
+                return PoolLine::INVALID_SLOT;
+            }
+
+            static std::uintptr_t GetLinePage(const PoolLine& line)
+            {
+                return line.GetMemoryAddress() / kLinePageSize;
+            }
+
+            // reuse index of released line, so line indexes of live elements stay valid
+            void AddLine()
+            {
+                int lineIndex = 0;
+                if (!mReleasedLines.empty())
+                {
+                    lineIndex = mReleasedLines.back();
+                    mReleasedLines.pop_back();
+                    mMemoryLines[lineIndex] = std::make_unique<PoolLine>();
+                }
+                else
+                {
+                    lineIndex = static_cast<int>(mMemoryLines.size());
+                    mMemoryLines.emplace_back(std::make_unique<PoolLine>());
+                }
+
+                mLinePages.emplace(GetLinePage(*mMemoryLines[lineIndex]), lineIndex);
+                mFreeLines.push_back(lineIndex);
+            }
+
+            void ReleaseLine(int lineIndex)
+            {
+                mLinePages.erase(GetLinePage(*mMemoryLines[lineIndex]));
+                mMemoryLines[lineIndex].reset();
+                mReleasedLines.push_back(lineIndex);
+            }
+
+            // address space is split into pages of this size to find line of an element
+            static constexpr std::size_t kLinePageSize = std::bit_floor(PoolLine::kMemorySize);
+
             using PoolLinePtr = std::unique_ptr<PoolLine>;
+
             std::vector<PoolLinePtr> mMemoryLines{};
+            // indexes of lines with free slots, except mLastLineIndex which is current line to allocate from.
+            // Each non full line is in exactly one of those.
+            std::vector<int> mFreeLines{};
+            // indexes of lines which memory was released (nullptr in mMemoryLines)
+            std::vector<int> mReleasedLines{};
+            // page where memory of each live line starts, to it's index in mMemoryLines
+            std::unordered_map<std::uintptr_t, int> mLinePages{};
             int mLastLineIndex = PoolLine::INVALID_SLOT;
+            std::size_t mNumAllocated = 0;
+            std::size_t mHighWaterMark = 0;
+            std::size_t mNumReleasedLines = 0;
+        };
+
+        //! Deleter which returns object back to pool P (PoolAllocator, ConcurrentPoolAllocator)
+        template <typename P>
+        struct PoolDeleter
+        {
+            void operator()(typename P::Type* object) const
+            {
+                mPool->Free(object);
+            }
+
+            P* mPool = nullptr;
+        };
+
+        //! Stateless deleter for pool with static storage duration, unique_ptr using it is the size of raw pointer
+        template <auto& Pool>
+        struct StaticPoolDeleter
+        {
+            using PoolType = std::remove_cvref_t<decltype(Pool)>;
+
+            void operator()(typename PoolType::Type* object) const
+            {
+                Pool.Free(object);
+            }
+        };
+
+        //! Pool for std::shared_ptr control blocks, each one up to S bytes, see NewShared and AllocateShared.
+        //! Same threading rules as PoolAllocator, last shared_ptr reference frees control block here.
+        template <std::size_t S = 64, int E = 256>
+        class ControlBlockPool : public Noncopyable<ControlBlockPool<S, E>>
+        {
+        public:
+            static constexpr std::size_t BlockSize = S;
+
+            template <typename U>
+            U* Allocate()
+            {
+                static_assert(sizeof(U) <= S && alignof(U) <= alignof(std::max_align_t), "Control block does not fit in ControlBlockPool, increase S.");
+                return reinterpret_cast<U*>(mBlocks.Allocate()->mBytes);
+            }
+
+            template <typename U>
+            void Free(U* controlBlock)
+            {
+                mBlocks.Free(std::launder(reinterpret_cast<Block*>(controlBlock)));
+            }
+
+            std::size_t NumAllocated() const { return mBlocks.NumAllocated(); }
+
+        private:
+            struct alignas(std::max_align_t) Block
+            {
+                // leave memory uninitialized, std::shared_ptr constructs control block in it
+                Block() {}
+                std::byte mBytes[S];
+            };
+
+            PoolAllocator<Block, E> mBlocks;
+        };
+
+        //! std allocator interface over ControlBlockPool, used by std::shared_ptr to allocate it's control block
+        template <typename U, typename CBP>
+        class ControlBlockAllocator
+        {
+        public:
+            using value_type = U;
+
+            explicit ControlBlockAllocator(CBP& controlBlockPool) : mControlBlockPool(&controlBlockPool)
+            {}
+
+            template <typename O>
+            ControlBlockAllocator(const ControlBlockAllocator<O, CBP>& other) : mControlBlockPool(other.mControlBlockPool)
+            {}
+
+            U* allocate(std::size_t n)
+            {
+                YAGET_ASSERT(n == 1, "ControlBlockAllocator only allocates single control block, requested: '%d'.", n);
+                return mControlBlockPool->template Allocate<U>();
+            }
+
+            void deallocate(U* controlBlock, std::size_t /*n*/)
+            {
+                mControlBlockPool->Free(controlBlock);
+            }
+
+            template <typename O>
+            bool operator==(const ControlBlockAllocator<O, CBP>& other) const { return mControlBlockPool == other.mControlBlockPool; }
+
+        private:
+            template <typename O, typename C>
+            friend class ControlBlockAllocator;
+
+            CBP* mControlBlockPool = nullptr;
         };
 
         // Helper to create shared pointer with custom deleter
@@ -536,13 +894,44 @@ namespace yaget
         std::shared_ptr<typename T::Type> New(T& poolAllocator, Args&&... args)
         {
             typename T::Type* newObject = poolAllocator.Allocate(std::forward<Args>(args)...);
-            auto objectHandle = std::shared_ptr<typename T::Type>(newObject, [&poolAllocator](typename T::Type* oldObject)
-            {
-                poolAllocator.Free(oldObject);
-            });
+            auto objectHandle = std::shared_ptr<typename T::Type>(newObject, PoolDeleter<T>{ &poolAllocator });
             return objectHandle;
         }
 
+        // Same as New, but shared pointer control block comes from controlBlockPool,
+        // so there are no heap allocations
+        template <typename T, typename CBP, typename... Args>
+        std::shared_ptr<typename T::Type> NewShared(T& poolAllocator, CBP& controlBlockPool, Args&&... args)
+        {
+            typename T::Type* newObject = poolAllocator.Allocate(std::forward<Args>(args)...);
+            return std::shared_ptr<typename T::Type>(newObject, PoolDeleter<T>{ &poolAllocator }, ControlBlockAllocator<typename T::Type, CBP>(controlBlockPool));
+        }
+
+        // Create object of type T together with it's shared pointer control block in one block of controlBlockPool
+        // (std::allocate_shared), single pool operation. Block size S must fit both.
+        template <typename T, typename CBP, typename... Args>
+        std::shared_ptr<T> AllocateShared(CBP& controlBlockPool, Args&&... args)
+        {
+            return std::allocate_shared<T>(ControlBlockAllocator<T, CBP>(controlBlockPool), std::forward<Args>(args)...);
+        }
+
+        // Helper to create unique pointer which frees object back to poolAllocator
+        template <typename T, typename... Args>
+        std::unique_ptr<typename T::Type, PoolDeleter<T>> NewUnique(T& poolAllocator, Args&&... args)
+        {
+            return std::unique_ptr<typename T::Type, PoolDeleter<T>>(poolAllocator.Allocate(std::forward<Args>(args)...), PoolDeleter<T>{ &poolAllocator });
+        }
+
+        // Helper to create unique pointer with stateless deleter, for Pool with static storage duration
+        //      static memory::PoolAllocator<Bullet> bulletPool;
+        //      auto bullet = memory::NewUnique<bulletPool>(position);
+        template <auto& Pool, typename... Args>
+        std::unique_ptr<typename StaticPoolDeleter<Pool>::PoolType::Type, StaticPoolDeleter<Pool>> NewUnique(Args&&... args)
+        {
+            using Pointer = std::unique_ptr<typename StaticPoolDeleter<Pool>::PoolType::Type, StaticPoolDeleter<Pool>>;
+            return Pointer(Pool.Allocate(std::forward<Args>(args)...));
+        }
+
     } // namespace memory
 
 } // namespace yaget
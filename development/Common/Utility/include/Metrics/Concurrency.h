@@ -20,6 +20,20 @@
 //      Currently we use chrome://tracing
 //      c:\Users\edgar\AppData\Local\Temp\Beyond Limits\YagetCore-Test
 //
+//      Recording a metric does not lock or allocate, names are copied (and truncated)
+//      into TraceName and pushed into per thread buffer, see TraceCollector.
+//      It's cheap enough to define YAGET_CONC_METRICS_ENABLED 1 in release builds.
+//      Names used every frame should be interned once, then records only carry it's id:
+//          metrics::Channel channel(YAGET_TRACE_NAME("Input.Tick"));
+//      Numeric tracks (counter events), Counter records each change, Gauge is sampled
+//      once per logic tick and by trace DataSaver (SampleGauges):
+//          metrics::Counter frameTime(YAGET_TRACE_NAME("Frame.LogicTime"));
+//          frameTime.Set(processTime);
+//          metrics::Gauge queuedTasks("JobPool.Queued");
+//          queuedTasks.Add(1);
+//      Value spread over threads can be summed only when sampled, instead of shared atomic:
+//          metrics::Gauge busyThreads(name, [this]() { return NumBusyThreads(); });
+//
 //  #include "Metrics/Concurrency.h"
 //
 //////////////////////////////////////////////////////////////////////
@@ -28,8 +42,14 @@
 
 #include "YagetCore.h"
 #include "Time/GameClock.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
 #include <functional>
+#include <limits>
 #include <source_location>
+#include <string_view>
 
 #if !defined(YAGET_CONC_METRICS_ENABLED)
     #if !defined(NDEBUG) // if we are in debug mode
@@ -41,6 +61,41 @@ namespace yaget::metrics
 {
     enum class MessageScope { Global, Process, Thread };
 
+    // Fixed size, null terminated metric name. Longer names are truncated.
+    using TraceName = std::array<char, 64>;
+
+    inline TraceName MakeTraceName(std::string_view prefix, std::string_view message)
+    {
+        TraceName name;
+        const std::size_t prefixSize = std::min(prefix.size(), name.size() - 1);
+        const std::size_t messageSize = std::min(message.size(), name.size() - 1 - prefixSize);
+        // default constructed string_view has null data, memcpy requires valid pointer even for 0 size
+        if (prefixSize)
+        {
+            std::memcpy(name.data(), prefix.data(), prefixSize);
+        }
+        if (messageSize)
+        {
+            std::memcpy(name.data() + prefixSize, message.data(), messageSize);
+        }
+        name[prefixSize + messageSize] = '\0';
+
+        return name;
+    }
+
+    inline TraceName MakeTraceName(std::string_view message)
+    {
+        return MakeTraceName({}, message);
+    }
+
+    inline std::string_view ToStringView(const TraceName& name)
+    {
+        return name.data();
+    }
+
+    // Id of a name registered with InternTraceName. Trace file resolves it back to name.
+    enum class TraceNameId : uint32_t { Invalid = 0 };
+
 #if YAGET_CONC_METRICS_ENABLED == 1
 
     namespace internal
@@ -51,9 +106,12 @@ namespace yaget::metrics
             virtual ~Metric() = default;
 
         protected:
-            Metric(const std::string& message, const std::source_location& location = std::source_location::current());
+            Metric(const TraceName& name, const std::source_location& location = std::source_location::current());
+            Metric(TraceNameId nameId, const std::source_location& location = std::source_location::current());
 
-            std::string mMessage;
+            // if valid, it's used instead of mName
+            TraceNameId mNameId = TraceNameId::Invalid;
+            TraceName mName;
             const std::source_location& mLocation;
             //const char* mFileName = nullptr;
             //uint32_t mLineNumber = 0;
@@ -67,10 +125,12 @@ namespace yaget::metrics
     {
     public:
 
-        Channel(const std::string& message, const std::source_location& location = std::source_location::current());
+        Channel(std::string_view message, const std::source_location& location = std::source_location::current());
+        Channel(const TraceName& name, const std::source_location& location = std::source_location::current());
+        Channel(TraceNameId nameId, const std::source_location& location = std::source_location::current());
         ~Channel() override;
 
-        void AddMessage(const std::string& message, MessageScope scope) const;
+        void AddMessage(std::string_view message, MessageScope scope) const;
     };
 
     //--------------------------------------------------------------------------------------------------------------
@@ -78,10 +138,10 @@ namespace yaget::metrics
     class TimeSpan : public internal::Metric
     {
     public:
-        TimeSpan(std::size_t id, const std::string& message, const std::source_location& location = std::source_location::current());
+        TimeSpan(std::size_t id, std::string_view message, const std::source_location& location = std::source_location::current());
         ~TimeSpan() override;
 
-        void AddMessage(const std::string& message) const;
+        void AddMessage(std::string_view message) const;
 
     private:
         size_t mId = 0;
@@ -90,7 +150,7 @@ namespace yaget::metrics
     class Lock : public internal::Metric
     {
     protected:
-        Lock(const std::string& message, const std::source_location& location = std::source_location::current());
+        Lock(const TraceName& name, const std::source_location& location = std::source_location::current());
         ~Lock() override = default;
 
     private:
@@ -101,17 +161,72 @@ namespace yaget::metrics
     class UniqueLock : public Lock
     {
     public:
-        UniqueLock(std::mutex& mutex, const std::string& message, const std::source_location& location = std::source_location::current());
+        UniqueLock(std::mutex& mutex, std::string_view message, const std::source_location& location = std::source_location::current());
         ~UniqueLock() override = default;
 
     private:
         std::unique_lock<std::mutex> mlocker;
     };
 
+    //--------------------------------------------------------------------------------------------------------------
+    // Numeric track in trace timeline, saved as counter event. Set records sample right away,
+    // but only when value changed. Meant for values set once per frame (frame time).
+    class Counter : public yaget::Noncopyable<Counter>
+    {
+    public:
+        Counter(std::string_view name);
+        Counter(TraceNameId nameId);
+
+        void Set(int64_t value);
+
+    private:
+        TraceNameId mNameId = TraceNameId::Invalid;
+        TraceName mName;
+        // first Set always records
+        std::atomic<int64_t> mValue{ std::numeric_limits<int64_t>::min() };
+    };
+
+    //--------------------------------------------------------------------------------------------------------------
+    // Counter for values which change too often to record each change (queue depth, live objects).
+    // Set and Add only update value, all gauges are recorded by SampleGauges.
+    // Gauge with sampler gets it's value from it in SampleGauges (under gauge registry lock,
+    // so sampler is not called once gauge is destroyed), Set and Add are not used.
+    // Name is not interned, so gauge can be created before (or by) TraceCollector itself.
+    class Gauge : public yaget::Noncopyable<Gauge>
+    {
+    public:
+        using Sampler = std::function<int64_t()>;
+
+        Gauge(std::string_view name);
+        Gauge(const TraceName& name);
+        Gauge(const TraceName& name, Sampler sampler);
+        ~Gauge();
+
+        void Set(int64_t value) { mValue.store(value, std::memory_order_relaxed); }
+        void Add(int64_t delta) { mValue.fetch_add(delta, std::memory_order_relaxed); }
+
+    private:
+        friend void SampleGauges();
+
+        TraceName mName;
+        std::atomic<int64_t> mValue{ 0 };
+        const Sampler mSampler;
+        // guarded by gauge registry lock
+        int64_t mSampledValue = 0;
+    };
+
     //--------------------------------------------------------------------------------------------------------------
     inline void Initialize(const args::Options&) {}
 
-    void MarkAddMessage(const std::string& message, MessageScope scope, size_t id);
+    void MarkAddMessage(std::string_view message, MessageScope scope, size_t id);
+
+    // Record value of each gauge which changed since last sample.
+    // Called once per logic tick by Application and on each save by TraceCollector.
+    void SampleGauges();
+
+    // Thread safe, returns the same id for the same name. It locks and allocates on first
+    // registration of a name, call it once and keep id (see YAGET_TRACE_NAME).
+    TraceNameId InternTraceName(std::string_view name);
 
     void MarkStartThread(std::thread& thread, const char* name);
     void MarkStartThread(uint32_t threadId, const char* name);
@@ -125,8 +240,10 @@ namespace yaget::metrics
     class Channel
     {
     public:
-        Channel(const std::string&, const std::source_location& location = std::source_location::current()) {}
-        void AddMessage(const std::string&, MessageScope) const {}
+        Channel(std::string_view, const std::source_location& location = std::source_location::current()) {}
+        Channel(const TraceName&, const std::source_location& location = std::source_location::current()) {}
+        Channel(TraceNameId, const std::source_location& location = std::source_location::current()) {}
+        void AddMessage(std::string_view, MessageScope) const {}
     };
 
     //--------------------------------------------------------------------------------------------------------------
@@ -134,15 +251,15 @@ namespace yaget::metrics
     class TimeSpan
     {
     public:
-        TimeSpan(std::size_t, const std::string&, const std::source_location& location = std::source_location::current()) {}
-        void AddMessage(const std::string&) const {}
+        TimeSpan(std::size_t, std::string_view, const std::source_location& location = std::source_location::current()) {}
+        void AddMessage(std::string_view) const {}
     };
 
     //--------------------------------------------------------------------------------------------------------------
     class UniqueLock
     {
     public:
-        UniqueLock(std::mutex& mutex, const std::string&, const std::source_location& location = std::source_location::current())
+        UniqueLock(std::mutex& mutex, std::string_view, const std::source_location& location = std::source_location::current())
             : mlocker(mutex)
         {}
 
@@ -150,10 +267,37 @@ namespace yaget::metrics
         std::unique_lock<std::mutex> mlocker;
     };
 
+    //--------------------------------------------------------------------------------------------------------------
+    class Counter
+    {
+    public:
+        Counter(std::string_view) {}
+        Counter(TraceNameId) {}
+        void Set(int64_t) {}
+    };
+
+    //--------------------------------------------------------------------------------------------------------------
+    class Gauge
+    {
+    public:
+        using Sampler = std::function<int64_t()>;
+
+        Gauge(std::string_view) {}
+        Gauge(const TraceName&) {}
+        Gauge(const TraceName&, Sampler) {}
+        void Set(int64_t) {}
+        void Add(int64_t) {}
+    };
+
     //--------------------------------------------------------------------------------------------------------------
     inline void Initialize(const args::Options&) {}
 
-    inline void MarkAddMessage(const std::string&, MessageScope, size_t) {}
+    inline void MarkAddMessage(std::string_view, MessageScope, size_t) {}
+
+    inline void SampleGauges() {}
+
+    // names are not registered when metrics are compiled out
+    inline TraceNameId InternTraceName(std::string_view) { return TraceNameId::Invalid; }
 
     // putting back intel concurrency functionality
     void MarkStartThread(std::thread& thread, const char* name);
@@ -168,4 +312,9 @@ namespace yaget::metrics
 } // namespace yaget::metrics
 
 
+// Intern literal name once per call site and return it's id
+//  metrics::Channel channel(YAGET_TRACE_NAME("Input.Tick"));
+#define YAGET_TRACE_NAME(name) ([]() { static const yaget::metrics::TraceNameId traceNameId = yaget::metrics::InternTraceName(name); return traceNameId; }())
+
+
 //#define YAGET_METRICS_CHANNEL_FILE_LINE __FILE__, __LINE__
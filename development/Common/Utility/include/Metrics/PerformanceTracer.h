@@ -6,6 +6,13 @@
 // NOTES:
 //      Collects chrome://tracing samples
 //      c:\Users\edgar\AppData\Local\Temp\Beyond Limits\YagetCore-Test
+//      Each thread records into it's own ring buffer (no lock, no allocation),
+//      DataSaver job drains all buffers into trace file every 200ms, or sooner
+//      when one of them gets half full. Records are dropped (and counted) if buffer is full.
+//      Interned names (InternTraceName) are kept in collector name table and records
+//      only carry their id, which is resolved to name when saved.
+//      Debug.Metrics.TraceFormat selects file format, Json (default) or Binary,
+//      see Metrics/TraceFormat.h. Binary file stores each name once, records only by id.
 //
 // #include "Metrics/PerformanceTracer.h"
 //
@@ -18,6 +25,8 @@
 #include "YagetCore.h"
 #include "Time/GameClock.h"
 #include "ThreadModel/JobPool.h"
+#include "ThreadModel/SpscRingBuffer.h"
+#include <deque>
 #include <fstream>
 #include <unordered_map>
 
@@ -25,51 +34,101 @@
 
 namespace yaget::metrics
 {
+    namespace trace { class BinaryWriter; }
+
     struct TraceRecord
     {
-        enum class Event { Begin, End, Complete, Instant, AsyncBegin, AsyncEnd, AsyncPoint, Lock, FlowBegin, FlowEnd, FlowPoint };
+        enum class Event { Begin, End, Complete, Instant, AsyncBegin, AsyncEnd, AsyncPoint, Lock, FlowBegin, FlowEnd, FlowPoint, Counter };
 
-        std::string mName;
+        // interned name, mName is used when this is Invalid
+        TraceNameId mNameId = TraceNameId::Invalid;
+        TraceName mName{};
         yaget::time::TimeUnits_t mStart = 0;
         yaget::time::TimeUnits_t mEnd = 0;
         std::size_t mThreadID = 0;
         Event mEvent = Event::Complete;
         std::size_t mId = 0;
-        std::string mCategory;
+        TraceNameId mCategory = TraceNameId::Invalid;
         MessageScope mMessageScope = MessageScope::Thread;
+        // sample of Counter event
+        int64_t mValue = 0;
     };
 
     using ThreadNames = std::map<std::size_t, std::string>;
 
-    class TraceCollector
+    class TraceCollector : public Noncopyable<TraceCollector>
     {
     public:
         TraceCollector();
         ~TraceCollector();
 
-        void AddProfileStamp(TraceRecord&& result);
+        // Can be called from any thread. It does not lock or allocate, except for the first record from a new thread.
+        void AddProfileStamp(const TraceRecord& record);
+
+        // Total number of records dropped because thread buffer was full
+        std::size_t NumDroppedRecords() const { return mNumDroppedRecords; }
+
+        // Name table, see metrics::InternTraceName
+        TraceNameId InternName(std::string_view name);
+        // empty for Invalid or unknown id
+        std::string_view GetName(TraceNameId nameId) const;
 
     private:
+        static constexpr std::size_t BufferCapacity = 8192;
+
+        struct ThreadBuffer
+        {
+            mt::SpscRingBuffer<TraceRecord, BufferCapacity> mRecords;
+            // written by recording thread, reset by DataSaver
+            std::atomic<std::size_t> mNumDropped{ 0 };
+            // set when thread exits, buffer can be reused by a new thread once drained
+            std::atomic_bool mRetired{ false };
+        };
+
+        using ThreadBuffers = std::vector<std::shared_ptr<ThreadBuffer>>;
+
+        // buffer for calling thread, created or reused on first call from that thread
+        ThreadBuffer& GetThreadBuffer();
+        std::shared_ptr<ThreadBuffer> AcquireThreadBuffer();
+
         void DataSaver();
 
         void SaveCurrentProfileStamps();
+        void SaveBinaryRecords(const ThreadBuffers& threadBuffers);
+        void CheckDroppedRecords(ThreadBuffer& threadBuffer);
+        std::string_view GetRecordName(const TraceRecord& record) const;
+        // adds names interned since last call to mBinaryWriter
+        void WriteNewNames();
+        // writes names of threads named or renamed since last call, so capture cut short still has them
+        void WriteNewThreadNames();
+
+        // name table, names are never removed, so views to them stay valid
+        mutable std::mutex mNamesMutex;
+        std::deque<std::string> mNames;
+        std::unordered_map<std::string_view, TraceNameId> mNameIds;
+        const TraceNameId mFileWriteCategory = InternName("FileWrite");
+        const TraceNameId mFileWriteName = InternName("TraceFileWrite");
+        std::size_t mNumWrittenNames = 0;
 
-        std::mutex mmProfileStampMutex;
         std::mutex mmThreadNameMutex;
-        using ProfileStamps = std::vector<TraceRecord>;
-        ProfileStamps mProfileStamps;
+        std::mutex mThreadBuffersMutex;
+        ThreadBuffers mThreadBuffers;
+        std::atomic<std::size_t> mNumDroppedRecords{ 0 };
         const std::string mFilePathName;
 
+        // thread names already written to trace
         ThreadNames mThreadNames;
 
         // 
         enum class TraceState {Off, StartSaver, On};
-        TraceState mTraceState = TraceState::Off;
+        std::atomic<TraceState> mTraceState = TraceState::Off;
 
         mt::JobPool mDataSaver = mt::JobPool("TraceDataSaver", 1);
         std::atomic_bool mQuit{ false };
         mt::Condition mTracingCondition;
         std::ofstream mOutputStream;
+        // valid when TraceFormat is Binary
+        std::unique_ptr<trace::BinaryWriter> mBinaryWriter;
     };
 
 }
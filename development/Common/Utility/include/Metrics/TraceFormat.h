@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////
+// TraceFormat.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Trace file formats written by TraceCollector (Debug.Metrics.TraceFormat).
+//      Json - chrome://tracing text, loads directly into chrome and Perfetto UI.
+//      Binary - compact stream for long captures, convert it to Json with Tools/TraceConverter.
+//
+//      Binary layout, all integers are LEB128 varints unless noted:
+//          header:  "YTRC", version (byte), application name, date
+//          blocks:  type (byte), payload size, payload
+//          Names:       count, {name id, length, chars}...      written once per new name
+//          Events:      thread id, count, {event}...            one block per thread per save
+//          ThreadNames: count, {thread id, length, chars}...     written when thread is first seen or renamed
+//          event:   event type | scope << 4 (byte), name id, category id, zigzag start delta,
+//                   zigzag duration (Complete, Lock), zigzag value (Counter) or id (Begin, End, Async*, Flow*)
+//      Start time is delta from previous event start on the same thread (over all blocks).
+//
+//      std::ofstream file(fileName, std::ios::binary);
+//      metrics::trace::BinaryWriter writer(file, appName, date);
+//      writer.AddName(nameId, "Input.Tick");
+//      writer.AddRecord(record);
+//      writer.Flush();
+//
+//      metrics::trace::ConvertToJson(binaryFile, jsonFile);
+//
+//
+//  #include "Metrics/TraceFormat.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "YagetCore.h"
+#include "Metrics/Concurrency.h"
+#include <map>
+#include <ostream>
+#include <istream>
+#include <string_view>
+#include <tuple>
+
+
+namespace yaget::metrics
+{
+    struct TraceRecord;
+}
+
+namespace yaget::metrics::trace
+{
+    constexpr char kMagic[] = { 'Y', 'T', 'R', 'C' };
+    constexpr uint8_t kVersion = 1;
+    // largest block payload reader accepts, writer flushes long before that
+    constexpr uint64_t kMaxBlockSize = 64 * 1024 * 1024;
+
+    enum class Block : uint8_t { Names = 1, Events = 2, ThreadNames = 3 };
+
+    //--------------------------------------------------------------------------------------------------
+    inline void WriteVarint(std::string& buffer, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    // Consumes varint from front of data, return false if data ends before varint does
+    inline bool ReadVarint(std::string_view& data, uint64_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64 && !data.empty(); shift += 7)
+        {
+            const auto byte = static_cast<uint8_t>(data.front());
+            data.remove_prefix(1);
+
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // signed values with small magnitude (time deltas) map to small varints
+    inline uint64_t ZigZag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+    inline int64_t UnZigZag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+    //--------------------------------------------------------------------------------------------------
+    // Writes binary trace. Records are encoded into per thread streams in memory,
+    // Flush writes all pending blocks to output in one write.
+    class BinaryWriter : public Noncopyable<BinaryWriter>
+    {
+    public:
+        BinaryWriter(std::ostream& output, std::string_view appName, std::string_view date);
+
+        // Name must be added before (or in the same Flush as) first record that uses it
+        void AddName(TraceNameId nameId, std::string_view name);
+        // record.mNameId must be valid, inline record.mName is not written
+        void AddRecord(const TraceRecord& record);
+        void AddThreadName(std::size_t threadId, std::string_view name);
+
+        void Flush();
+
+        // bytes written to output so far
+        std::size_t NumBytesWritten() const { return mNumBytesWritten; }
+
+    private:
+        struct ThreadStream
+        {
+            std::string mEvents;
+            std::size_t mNumEvents = 0;
+            time::TimeUnits_t mLastStart = 0;
+        };
+
+        void AddBlock(Block block, const std::string& payload);
+
+        std::ostream& mOutput;
+        std::string mNames;
+        std::size_t mNumNames = 0;
+        std::string mThreadNames;
+        std::size_t mNumThreadNames = 0;
+        std::map<std::size_t, ThreadStream> mThreadStreams;
+        // all blocks for next Flush
+        std::string mPending;
+        std::size_t mNumBytesWritten = 0;
+    };
+
+    //--------------------------------------------------------------------------------------------------
+    // chrome://tracing json, used by TraceCollector Json format and ConvertToJson
+    void WriteJsonHeader(std::ostream& output, std::string_view appName, std::string_view date);
+    void WriteJsonRecord(std::ostream& output, const TraceRecord& record, std::string_view name, std::string_view category);
+    void WriteJsonThreadName(std::ostream& output, std::size_t threadId, std::string_view name);
+    void WriteJsonFooter(std::ostream& output);
+
+    // Reads binary trace from input and writes it as chrome://tracing json.
+    // Return false with error message if input is not a binary trace or it is corrupted,
+    // everything decoded up to that point is still written and json is closed.
+    using ConvertResult = std::tuple<bool, std::string>;
+    ConvertResult ConvertToJson(std::istream& input, std::ostream& output);
+
+} // namespace yaget::metrics::trace
@@ -34,7 +34,14 @@ namespace yaget
         std::string GetCurrentThreadName();
 
         using ThreadNames = std::map<uint32_t, std::string>;
-        const ThreadNames& GetThreadNames();
+        // copy of all named threads, threads can be named while caller uses it
+        ThreadNames GetThreadNames();
+
+        // Scheduling of calling thread, return false if it was not changed (LastErrorMessage has details)
+        enum class ThreadPriority { Lowest, Low, Normal, High, Highest };
+        bool SetCurrentThreadPriority(ThreadPriority priority);
+        // affinityMask - bit per core this thread is allowed to run on
+        bool SetCurrentThreadAffinity(uint64_t affinityMask);
 
         // Various Sleep functions
         // Keep sleeping while predicate returns true
@@ -57,8 +57,9 @@ namespace yaget::io
         std::atomic_bool mQuitRequested{ false };
 
         using Tickets = std::vector<Ticket>;
-        mt::Variable<Tickets> mTickets;
-        mt::Variable<Strings> mWatchedFiles;    // used bu imgui to display which one are watched and provide user trigger
+        // new requests from Add/Remove, polled by Observe every millisecond
+        mt::SharedVariable<Tickets> mTickets;
+        mt::SharedVariable<Strings> mWatchedFiles;    // used bu imgui to display which one are watched and provide user trigger
         mt::JobPool mObserver;
     };
 
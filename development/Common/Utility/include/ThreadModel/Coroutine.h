@@ -0,0 +1,320 @@
+///////////////////////////////////////////////////////////////////////
+// Coroutine.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      C++20 coroutine task type and awaitables for JobPool and GameClock.
+//      Coroutine<T> is lazy, it starts when it is co_awaited, or by Start/Wait
+//      from regular code. Awaiting coroutine is resumed on whatever thread
+//      finished the awaited operation, use co_await mt::SwitchTo(pool)
+//      to continue on specific pool. No thread is blocked while coroutine waits.
+//
+//      mt::Coroutine<> LoadLevel(mt::JobPool& pool, mt::GameTimer& timer)
+//      {
+//          co_await mt::SwitchTo(pool);
+//          auto assets = co_await io::RequestBlobs<io::Asset>(vts, tags);
+//          co_await timer.Delay(time::kDeltaTime_60);
+//          ...
+//      }
+//      LoadLevel(pool, timer).Start();
+//
+//      VTS and BlobLoader awaitables are in "VTS/AsyncLoaders.h".
+//
+//
+//  #include "ThreadModel/Coroutine.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "ThreadModel/JobPool.h"
+#include "Time/GameClock.h"
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+
+namespace yaget::mt
+{
+    template <typename T>
+    class Coroutine;
+
+    namespace internal
+    {
+        // Signaled when coroutine started trough Coroutine::Wait is finished
+        struct CoroutineSignal
+        {
+            void Set()
+            {
+                std::lock_guard<std::mutex> locker(mMutex);
+                mDone = true;
+                mCondition.notify_all();
+            }
+
+            void Wait()
+            {
+                std::unique_lock<std::mutex> locker(mMutex);
+                mCondition.wait(locker, [this] { return mDone; });
+            }
+
+            std::mutex mMutex;
+            std::condition_variable mCondition;
+            bool mDone = false;
+        };
+
+        void LogDetachedCoroutineException(std::exception_ptr exception);
+
+        class CoroutinePromiseBase
+        {
+        public:
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template <typename P>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept
+                {
+                    CoroutinePromiseBase& promise = handle.promise();
+                    if (promise.mContinuation)
+                    {
+                        return promise.mContinuation;
+                    }
+
+                    if (promise.mSignal)
+                    {
+                        // frame can be destroyed by waiting thread as soon as signal is set
+                        promise.mSignal->Set();
+                    }
+                    else if (promise.mDetached)
+                    {
+                        if (promise.mException)
+                        {
+                            LogDetachedCoroutineException(promise.mException);
+                        }
+                        handle.destroy();
+                    }
+
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() { mException = std::current_exception(); }
+
+            // resumed when this coroutine finishes
+            std::coroutine_handle<> mContinuation;
+            CoroutineSignal* mSignal = nullptr;
+            bool mDetached = false;
+            std::exception_ptr mException;
+        };
+
+        template <typename T>
+        class CoroutinePromise : public CoroutinePromiseBase
+        {
+        public:
+            Coroutine<T> get_return_object();
+
+            template <typename V>
+            void return_value(V&& value) { mValue.emplace(std::forward<V>(value)); }
+
+            T Result()
+            {
+                if (mException)
+                {
+                    std::rethrow_exception(mException);
+                }
+                return std::move(*mValue);
+            }
+
+        private:
+            std::optional<T> mValue;
+        };
+
+        template <>
+        class CoroutinePromise<void> : public CoroutinePromiseBase
+        {
+        public:
+            Coroutine<void> get_return_object();
+
+            void return_void() {}
+
+            void Result()
+            {
+                if (mException)
+                {
+                    std::rethrow_exception(mException);
+                }
+            }
+        };
+
+    } // namespace internal
+
+
+    //! Coroutine returning T. Move only, owns coroutine frame until started with Start().
+    template <typename T = void>
+    class [[nodiscard]] Coroutine
+    {
+    public:
+        using promise_type = internal::CoroutinePromise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Coroutine() = default;
+        Coroutine(Coroutine&& other) noexcept : mHandle(std::exchange(other.mHandle, {})) {}
+        Coroutine& operator=(Coroutine&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Destroy();
+                mHandle = std::exchange(other.mHandle, {});
+            }
+            return *this;
+        }
+
+        Coroutine(const Coroutine&) = delete;
+        Coroutine& operator=(const Coroutine&) = delete;
+
+        ~Coroutine() { Destroy(); }
+
+        bool IsValid() const { return mHandle != nullptr; }
+
+        // Run from regular code without waiting for it, coroutine frees itself once finished.
+        // Exception thrown from coroutine is logged.
+        void Start() &&
+        {
+            YAGET_ASSERT(mHandle, "Starting invalid coroutine.");
+            Handle handle = std::exchange(mHandle, {});
+            handle.promise().mDetached = true;
+            handle.resume();
+        }
+
+        // Run and block until finished, do not call from thread that coroutine needs to make progress
+        T Wait() &&
+        {
+            YAGET_ASSERT(mHandle, "Waiting on invalid coroutine.");
+            internal::CoroutineSignal signal;
+            mHandle.promise().mSignal = &signal;
+            mHandle.resume();
+            signal.Wait();
+
+            return mHandle.promise().Result();
+        }
+
+        // co_await from other coroutine, which is resumed when this one finishes
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    mHandle.promise().mContinuation = awaiting;
+                    return mHandle;
+                }
+
+                T await_resume() { return mHandle.promise().Result(); }
+
+                Handle mHandle;
+            };
+
+            YAGET_ASSERT(mHandle, "Awaiting on invalid coroutine.");
+            return Awaiter{ mHandle };
+        }
+
+    private:
+        friend promise_type;
+
+        explicit Coroutine(Handle handle) : mHandle(handle) {}
+
+        void Destroy()
+        {
+            if (mHandle)
+            {
+                mHandle.destroy();
+                mHandle = {};
+            }
+        }
+
+        Handle mHandle;
+    };
+
+
+    template <typename T>
+    Coroutine<T> internal::CoroutinePromise<T>::get_return_object()
+    {
+        return Coroutine<T>(Coroutine<T>::Handle::from_promise(*this));
+    }
+
+    inline Coroutine<void> internal::CoroutinePromise<void>::get_return_object()
+    {
+        return Coroutine<void>(Coroutine<void>::Handle::from_promise(*this));
+    }
+
+
+    //! co_await SwitchTo(pool) to continue coroutine on one of the pool threads
+    inline auto SwitchTo(JobPool& pool)
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { mPool.AddTask([handle]() { handle.resume(); }); }
+            void await_resume() const noexcept {}
+
+            JobPool& mPool;
+        };
+
+        return Awaiter{ pool };
+    }
+
+
+    //! Resumes coroutines waiting on game time. Owner calls Tick once per logic loop
+    //! and waiting coroutines are resumed from that call.
+    class GameTimer : public Noncopyable<GameTimer>
+    {
+    public:
+        ~GameTimer();
+
+        // Resume all coroutines which waited for logicTime or earlier
+        void Tick(time::Microsecond_t logicTime);
+        void Tick(const time::GameClock& gameClock) { Tick(gameClock.GetLogicTime()); }
+
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> handle) { return mTimer.AddWaiter(mLogicTime, handle); }
+            void await_resume() const noexcept {}
+
+            GameTimer& mTimer;
+            time::Microsecond_t mLogicTime;
+        };
+
+        // co_await timer.WaitUntil(logicTime)
+        Awaiter WaitUntil(time::Microsecond_t logicTime) { return Awaiter{ *this, logicTime }; }
+
+        // co_await timer.Delay(duration) to resume coroutine duration after last ticked logic time
+        Awaiter Delay(time::Microsecond_t duration) { return WaitUntil(LogicTime() + duration); }
+
+        time::Microsecond_t LogicTime() const;
+        std::size_t NumWaiting() const;
+
+    private:
+        // return false if logicTime already passed and coroutine should not suspend
+        bool AddWaiter(time::Microsecond_t logicTime, std::coroutine_handle<> handle);
+
+        mutable std::mutex mMutex;
+        time::Microsecond_t mLogicTime = 0;
+        std::multimap<time::Microsecond_t, std::coroutine_handle<>> mWaiters;
+    };
+
+} // namespace yaget::mt
@@ -6,7 +6,14 @@
 //  Maintained by: Edgar
 //
 //  NOTES:
-//     
+//      Work stealing scheduler. Each worker thread owns a deque (WorkStealingQueue),
+//      tasks added from a worker go to it's own deque, tasks added from any other
+//      thread go to shared injection queue. Idle workers take from injection queue
+//      and steal from other workers, then park until new task is added.
+//      Each task priority has it's own queues, higher priority is always searched first.
+//      Pool threads can run with OS priority and affinity from configuration
+//      (Debug.Threads.Pools block), see ConfiguredThreadOptions.
+//      Queued and busy task counts are traced as JobPool.<name>.Queued/Busy counter tracks.
 //
 //
 //  #include "ThreadModel/JobPool.h"
@@ -18,9 +25,14 @@
 
 #include "JobProcessor.h"
 #include "ThreadModel/Condition.h" 
+#include "Metrics/Concurrency.h"
+#include "Platform/Support.h"
+#include <array>
+#include <atomic>
 #include <functional>
-#include <deque>
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace yaget::mt
 {
@@ -28,6 +40,7 @@ namespace yaget::mt
     Create number of threads and put them into waiting state. By calling AddTask, threads will start
     processing them asap. Delete this object to stop all threads, 
     which will may not finish all tasks left in queue. 
+    Threads are created on demand, when there is no parked thread to wake up for new task.
     If numThreads is 0, then allocate number_of_hardware_threads - 1.
     If numThreads > 0, then allocate that many threads.
     There is no validation on upper limit and undefined behavior may occur at large values.
@@ -39,20 +52,54 @@ namespace yaget::mt
         using Threads_t = std::map<std::string, JobProcessor::Holder>;
 
         enum class Behaviour { StartAsRun, StartAsPause };
+
+        // OS settings applied to each pool thread when it starts
+        struct ThreadOptions
+        {
+            platform::ThreadPriority mPriority = platform::ThreadPriority::Normal;
+            // bit per core to pin pool threads to, 0 - not pinned
+            uint64_t mAffinityMask = 0;
+        };
+
+        // Thread options from Debug.Threads.Pools.<configName> configuration block, default ones if there is no such block
+        static ThreadOptions ConfiguredThreadOptions(const std::string& configName);
+
         JobPool(const char* poolName, uint32_t numThreads = 0, Behaviour behaviour = Behaviour::StartAsRun);
+        JobPool(const char* poolName, uint32_t numThreads, Behaviour behaviour, const ThreadOptions& threadOptions);
         ~JobPool();
 
+        // Higher priority tasks are always taken before lower ones.
+        // High - latency critical (logic, IO completion), Low - background (indexing, bulk loads)
+        enum class Priority { High, Normal, Low };
+        static constexpr std::size_t NumPriorities = 3;
+
         // Allows to specify on what thread to execute the task,
         // Default - execute this task in 'some' default way, can be Pool or Tasked
         // Pool - execute it from same thread that Pool started this task on.
         // Tasked - execute from the thread that this task was added from.
         enum class TaskExecutionThread { Default, Pool, Tasked };
         void AddTask(JobProcessor::Task_t task, TaskExecutionThread taskExecutionThread = TaskExecutionThread::Default);
+        void AddTask(JobProcessor::Task_t task, Priority priority, TaskExecutionThread taskExecutionThread = TaskExecutionThread::Default);
         void UnpauseAll();
+
+        // How long tasks waited in queues before they started running, since pool was created
+        struct QueueLatency
+        {
+            std::size_t mNumTasks = 0;
+            time::Microsecond_t mTotal = 0;
+            time::Microsecond_t mMax = 0;
+
+            time::Microsecond_t Average() const { return mNumTasks ? mTotal / static_cast<time::Microsecond_t>(mNumTasks) : 0; }
+        };
+        QueueLatency GetQueueLatency(Priority priority) const;
+
+        // Upper limit of threads this pool will create
+        uint32_t MaxNumThreads() const { return mMaxNumThreads; }
         
 
-        // Blocking call, it will process all tasks until none. 
+        // Blocking call, it will wait until all added tasks are finished. 
         // It is possible to add new task while Join() from other threads. 
+        // Do not call from task running on this pool.
         void Join();
         // Same as above Join but it will also delete and cleanup all threads.
         void JoinDestroy();
@@ -66,21 +113,48 @@ namespace yaget::mt
                 : mPool(pool), mMutexLock(pool.mPendingTasksMutex)
             {}
 
+            // wake up workers for all added tasks once lock is released
+            ~Locker()
+            {
+                mPool.mNumPendingTasks[Normal].store(mPool.mInjectedTasks[Normal].Size());
+                mMutexLock.unlock();
+
+                for (std::size_t i = 0; i < mNumAdded; ++i)
+                {
+                    if (!mPool.WakeWorker())
+                    {
+                        break;
+                    }
+                }
+            }
+
             void AddTask(JobProcessor::Task_t task)
             {
-                mPool.mTasks.push_back(task);
+                mPool.mNumOutstandingTasks.fetch_add(1);
+                mPool.mInjectedTasks[Normal].Push({ std::move(task), QueueTime() });
+                ++mNumAdded;
             }
 
+            // tasks are copied, T holds copyable callables
             template <typename T>
             void AddTasks(const T& tasks)
             {
-                std::copy(std::begin(tasks), std::end(tasks),
-                    std::inserter(mPool.mTasks, std::end(mPool.mTasks)));
+                const auto numTasks = static_cast<std::size_t>(std::distance(std::begin(tasks), std::end(tasks)));
+                mPool.mNumOutstandingTasks.fetch_add(numTasks);
+                const time::Raw_t queueTime = QueueTime();
+                for (const auto& task : tasks)
+                {
+                    mPool.mInjectedTasks[Normal].Push({ task, queueTime });
+                }
+                mNumAdded += numTasks;
             }
 
         private:
+            static constexpr std::size_t Normal = static_cast<std::size_t>(Priority::Normal);
+
             JobPool& mPool;
             std::unique_lock<std::mutex> mMutexLock;
+            std::size_t mNumAdded = 0;
         };
 
         Locker GetLocker()
@@ -89,26 +163,80 @@ namespace yaget::mt
         }
 
     private:
+        struct Worker;
+
+        // task with time it was added at, to measure queue latency
+        struct QueuedTask
+        {
+            JobProcessor::Task_t mTask;
+            time::Raw_t mQueueTime = 0;
+        };
+
+        // FIFO for tasks added from outside of worker threads, guarded by mPendingTasksMutex.
+        // It keeps it's capacity when drained, so adding tasks does not allocate once pool is warmed up
+        struct InjectedTasks
+        {
+            void Push(QueuedTask&& task) { mTasks.push_back(std::move(task)); }
+            bool Pop(QueuedTask& task);
+            std::size_t Size() const { return mTasks.size() - mHead; }
+            void Clear() { mTasks.clear(); mHead = 0; }
+
+            std::vector<QueuedTask> mTasks;
+            // pending tasks start here
+            std::size_t mHead = 0;
+        };
+
+        static time::Raw_t QueueTime();
+
         void Clear();
         void Destroy();
-        JobProcessor::Task_t PopNextTask();
-        void UpdateThreadPool(size_t numTasksLeft);
+
+        // Called by worker thread workerIndex, return next task or empty one if worker should park
+        JobProcessor::Task_t PopNextTask(std::size_t workerIndex);
+        bool PopLocalTask(std::size_t workerIndex, std::size_t priority, QueuedTask& task);
+        bool PopInjectedTask(std::size_t priority, QueuedTask& task);
+        bool StealTask(std::size_t workerIndex, std::size_t priority, QueuedTask& task);
+        bool HasTasks() const;
+        void OnTaskFinished();
+        // called once from each pool thread before it runs first task
+        void ApplyThreadOptions() const;
+
+        // Unpark one worker, or create new one if all are busy.
+        // Return false if there was no worker to wake up and no more can be created.
+        bool WakeWorker();
+        bool AddWorker();
 
         size_t GetNumTasksLeft() const;
+        // number of workers running a task, summed from each worker's flag when gauges are sampled
+        std::size_t GetNumBusyWorkers() const;
 
         Threads_t mThreads;
-        typedef std::deque<JobProcessor::Task_t> Tasks_t;
-        Tasks_t mTasks;
-        std::condition_variable mTaskWaitCondition;
-        std::mutex mTaskWaitMutex;
+        // one injection queue per priority
+        std::array<InjectedTasks, NumPriorities> mInjectedTasks;
+        // number of pending tasks in mInjectedTasks, so workers do not need to lock to check it
+        std::array<std::atomic<std::size_t>, NumPriorities> mNumPendingTasks{};
+        // added and not finished tasks, Join waits for this to drop to 0
+        std::atomic<std::size_t> mNumOutstandingTasks{ 0 };
         mutable std::mutex mPendingTasksMutex;
         std::mutex mThreadListMutext;
         std::string mName;
-        Behaviour mBehaviour = Behaviour::StartAsRun;
-        mt::Condition mEmptyCondition;
+        std::atomic<Behaviour> mBehaviour = Behaviour::StartAsRun;
         // if True then create threads only on demand
         const bool mDynamicThreads;
         uint32_t mMaxNumThreads;
+        const ThreadOptions mThreadOptions;
+
+        // all possible workers are allocated up front, only thread is created on demand
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+        std::atomic<uint32_t> mNumWorkers{ 0 };
+        // set by Destroy while threads are deleted, guarded by mThreadListMutext
+        bool mStopping = false;
+
+        // tasks waiting in queues and tasks being run, trace counter tracks.
+        // Both are computed by sampler from counts pool already keeps, so running a task does not touch them.
+        // Declared last, so they are gone (and not sampled) before anything they read.
+        metrics::Gauge mQueuedTasksGauge;
+        metrics::Gauge mBusyThreadsGauge;
     };
 
     std::string GenerateNextName(const std::string& name);
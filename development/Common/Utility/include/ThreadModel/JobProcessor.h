@@ -16,6 +16,7 @@
 #pragma once 
  
 #include "ThreadModel/Condition.h" 
+#include "ThreadModel/UniqueFunction.h"
 #include <functional> 
 #include <memory> 
 #include <atomic> 
@@ -27,7 +28,8 @@ namespace yaget::mt
     class JobProcessor : public Noncopyable<JobProcessor> 
     { 
     public: 
-        using Task_t = std::function<void()>; 
+        // move only, lambdas capturing up to 64 bytes do not allocate
+        using Task_t = UniqueFunction<void()>;
         using PopNextTask_t = std::function<Task_t()>; 
 
         struct Holder 
@@ -51,7 +53,7 @@ namespace yaget::mt
         void StartProcessing(); 
 
     private: 
-        bool mQuit = false; 
+        std::atomic_bool mQuit{ false }; 
         const std::string mThreadName; 
 
         std::thread mThread; 
@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////
+// Parallel.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Data parallel loops on JobPool. Range is split into chunks claimed
+//      by calling thread and up to MaxNumThreads helper tasks. Chunks start large
+//      and shrink down to grainSize as range runs out (guided scheduling),
+//      so there are few claims for large ranges and load is still balanced at the end.
+//      Calling thread always participates and returns only after whole range is processed,
+//      which also makes it safe to call from task running on the same pool.
+//      Exception thrown by fn is re-thrown on calling thread, once all chunks are done.
+//
+//      mt::parallel_for(pool, 0, items.size(), 1024, [&items](std::size_t begin, std::size_t end) { ... });
+//      float sum = mt::parallel_reduce(pool, 0, items.size(), 1024, 0.0f,
+//          [&items](std::size_t begin, std::size_t end) { return std::accumulate(&items[begin], &items[end], 0.0f); },
+//          std::plus<float>{});
+//
+//
+//  #include "ThreadModel/Parallel.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "ThreadModel/JobPool.h"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <ranges>
+
+
+namespace yaget::mt
+{
+    namespace internal
+    {
+        // State shared between calling thread and helper tasks. Helpers may start after all work is claimed,
+        // or even after caller returned, in which case they exit without touching body.
+        struct ParallelState
+        {
+            ParallelState(std::size_t begin, std::size_t end, std::size_t grainSize, std::size_t numParticipants)
+                : mEnd(end)
+                , mNumItems(end - begin)
+                , mGrainSize(grainSize)
+                , mNumParticipants(numParticipants)
+                , mNextIndex(begin)
+            {}
+
+            // body(participant, chunkBegin, chunkEnd), participant 0 is calling thread
+            template <typename B>
+            void Process(std::size_t participant, B& body)
+            {
+                while (true)
+                {
+                    const std::size_t next = mNextIndex.load(std::memory_order_relaxed);
+                    if (next >= mEnd)
+                    {
+                        return;
+                    }
+
+                    const std::size_t chunkSize = std::max(mGrainSize, (mEnd - next) / (2 * mNumParticipants));
+                    const std::size_t chunkBegin = mNextIndex.fetch_add(chunkSize);
+                    if (chunkBegin >= mEnd)
+                    {
+                        return;
+                    }
+
+                    const std::size_t chunkEnd = std::min(mEnd, chunkBegin + chunkSize);
+                    try
+                    {
+                        body(participant, chunkBegin, chunkEnd);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> locker(mExceptionMutex);
+                        if (!mException)
+                        {
+                            mException = std::current_exception();
+                        }
+                    }
+
+                    if (mNumDone.fetch_add(chunkEnd - chunkBegin) + (chunkEnd - chunkBegin) == mNumItems)
+                    {
+                        mNumDone.notify_all();
+                    }
+                }
+            }
+
+            void Wait()
+            {
+                for (std::size_t numDone = mNumDone.load(); numDone < mNumItems; numDone = mNumDone.load())
+                {
+                    mNumDone.wait(numDone);
+                }
+
+                if (mException)
+                {
+                    std::rethrow_exception(mException);
+                }
+            }
+
+            const std::size_t mEnd;
+            const std::size_t mNumItems;
+            const std::size_t mGrainSize;
+            const std::size_t mNumParticipants;
+            std::atomic<std::size_t> mNextIndex;
+            std::atomic<std::size_t> mNumDone{ 0 };
+            std::mutex mExceptionMutex;
+            std::exception_ptr mException;
+        };
+
+        inline std::size_t NumParallelHelpers(const JobPool& pool, std::size_t numItems, std::size_t grainSize)
+        {
+            const std::size_t numChunks = (numItems + grainSize - 1) / grainSize;
+            return numChunks > 1 ? std::min<std::size_t>(numChunks - 1, pool.MaxNumThreads()) : 0;
+        }
+
+        // body(participant, chunkBegin, chunkEnd) where participant is in [0, numHelpers]
+        template <typename B>
+        void ParallelRun(JobPool& pool, std::size_t begin, std::size_t end, std::size_t grainSize, std::size_t numHelpers, B& body)
+        {
+            auto state = std::make_shared<ParallelState>(begin, end, grainSize, numHelpers + 1);
+
+            for (std::size_t i = 1; i <= numHelpers; ++i)
+            {
+                pool.AddTask([state, &body, i]()
+                {
+                    state->Process(i, body);
+                });
+            }
+
+            state->Process(0, body);
+            state->Wait();
+        }
+
+    } // namespace internal
+
+
+    //! Call fn(chunkBegin, chunkEnd) for sub ranges of [begin, end), each at least grainSize long (except last one).
+    template <typename F>
+    void parallel_for(JobPool& pool, std::size_t begin, std::size_t end, std::size_t grainSize, F&& fn)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        grainSize = std::max<std::size_t>(grainSize, 1);
+        const std::size_t numHelpers = internal::NumParallelHelpers(pool, end - begin, grainSize);
+        if (numHelpers == 0)
+        {
+            fn(begin, end);
+            return;
+        }
+
+        auto body = [&fn](std::size_t /*participant*/, std::size_t chunkBegin, std::size_t chunkEnd)
+        {
+            fn(chunkBegin, chunkEnd);
+        };
+
+        internal::ParallelRun(pool, begin, end, grainSize, numHelpers, body);
+    }
+
+    //! Call fn(subrange) for sub ranges of random access range
+    template <std::ranges::random_access_range R, typename F>
+        requires std::ranges::sized_range<R>
+    void parallel_for(JobPool& pool, R&& range, std::size_t grainSize, F&& fn)
+    {
+        auto first = std::ranges::begin(range);
+        parallel_for(pool, 0, static_cast<std::size_t>(std::ranges::size(range)), grainSize, [first, &fn](std::size_t chunkBegin, std::size_t chunkEnd)
+        {
+            fn(std::ranges::subrange(first + chunkBegin, first + chunkEnd));
+        });
+    }
+
+    //! Return reduce(...reduce(identity, map(chunkBegin, chunkEnd))...) over all sub ranges of [begin, end).
+    //! Order in which chunk results are combined is not specified, reduce must be associative and commutative.
+    template <typename T, typename M, typename R>
+    T parallel_reduce(JobPool& pool, std::size_t begin, std::size_t end, std::size_t grainSize, T identity, M&& map, R&& reduce)
+    {
+        if (begin >= end)
+        {
+            return identity;
+        }
+
+        grainSize = std::max<std::size_t>(grainSize, 1);
+        const std::size_t numHelpers = internal::NumParallelHelpers(pool, end - begin, grainSize);
+        if (numHelpers == 0)
+        {
+            return reduce(std::move(identity), map(begin, end));
+        }
+
+        // one partial result per participant, so there is no sharing while running
+        struct alignas(64) Partial
+        {
+            std::optional<T> mValue;
+        };
+        std::vector<Partial> partials(numHelpers + 1);
+
+        auto body = [&partials, &map, &reduce](std::size_t participant, std::size_t chunkBegin, std::size_t chunkEnd)
+        {
+            std::optional<T>& partial = partials[participant].mValue;
+            if (partial)
+            {
+                partial = reduce(std::move(*partial), map(chunkBegin, chunkEnd));
+            }
+            else
+            {
+                partial.emplace(map(chunkBegin, chunkEnd));
+            }
+        };
+
+        internal::ParallelRun(pool, begin, end, grainSize, numHelpers, body);
+
+        T result = std::move(identity);
+        for (auto& partial : partials)
+        {
+            if (partial.mValue)
+            {
+                result = reduce(std::move(result), std::move(*partial.mValue));
+            }
+        }
+
+        return result;
+    }
+
+} // namespace yaget::mt
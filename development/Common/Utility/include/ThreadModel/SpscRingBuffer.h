@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////
+// SpscRingBuffer.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Bounded, lock free queue for one producer thread and one consumer thread.
+//      Items are copied into preallocated slots, so TryPush never allocates or locks,
+//      and fails when buffer is full. Consumer drains all available items at once.
+//      Used for per thread trace buffers in metrics::TraceCollector.
+//
+//      auto buffer = std::make_unique<mt::SpscRingBuffer<Record, 4096>>();
+//      // producer thread
+//      if (!buffer->TryPush(record)) { ++numDropped; }
+//      // consumer thread
+//      buffer->PopAll([](const Record& record) { Save(record); });
+//
+//
+//  #include "ThreadModel/SpscRingBuffer.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "YagetCore.h"
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+
+namespace yaget::mt
+{
+    template <typename T, std::size_t Capacity>
+    class SpscRingBuffer : public Noncopyable<SpscRingBuffer<T, Capacity>>
+    {
+        static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "SpscRingBuffer Capacity must be power of 2.");
+        static_assert(std::is_trivially_copyable_v<T>, "SpscRingBuffer requires trivially copyable type.");
+
+    public:
+        static constexpr std::size_t kCapacity = Capacity;
+
+        // Called only from producer thread, return false if buffer is full
+        bool TryPush(const T& item)
+        {
+            const std::size_t tail = mTail.load(std::memory_order_relaxed);
+            if (tail - mCachedHead == Capacity)
+            {
+                // refresh what consumer released only when buffer looks full
+                mCachedHead = mHead.load(std::memory_order_acquire);
+                if (tail - mCachedHead == Capacity)
+                {
+                    return false;
+                }
+            }
+
+            mItems[tail & Mask] = item;
+            mTail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Called only from consumer thread, consumer(const T&) is called for each item in FIFO order.
+        // Return number of items consumed.
+        template <typename F>
+        std::size_t PopAll(F&& consumer)
+        {
+            const std::size_t head = mHead.load(std::memory_order_relaxed);
+            const std::size_t tail = mTail.load(std::memory_order_acquire);
+            for (std::size_t i = head; i != tail; ++i)
+            {
+                consumer(mItems[i & Mask]);
+            }
+
+            mHead.store(tail, std::memory_order_release);
+            return tail - head;
+        }
+
+        // approximate when called while other thread is pushing or popping
+        std::size_t Size() const
+        {
+            const std::size_t head = mHead.load(std::memory_order_acquire);
+            const std::size_t tail = mTail.load(std::memory_order_acquire);
+            return tail - head;
+        }
+
+        bool Empty() const { return Size() == 0; }
+
+    private:
+        static constexpr std::size_t Mask = Capacity - 1;
+
+        // consumer and producer indexes are on separate cache lines
+        alignas(64) std::atomic<std::size_t> mHead{ 0 };
+        alignas(64) std::atomic<std::size_t> mTail{ 0 };
+        // producer copy of mHead
+        std::size_t mCachedHead = 0;
+        alignas(64) std::array<T, Capacity> mItems;
+    };
+
+} // namespace yaget::mt
@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////
+// TaskGraph.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Tasks with dependencies and continuations running on JobPool.
+//      Task is added to the pool only after all of it's dependencies finished,
+//      so no thread is ever blocked waiting on other task.
+//      If any dependency failed (exception) or was cancelled, task is cancelled
+//      without running, which propagates down the graph. The same happens
+//      to tasks which pool drops from it's queue without running them.
+//
+//      mt::JobPool pool("Assets", 4);
+//      mt::TaskGraph graph(pool);
+//      auto blob = graph.Add([]() { return LoadBlob(); });
+//      auto asset = blob.Then([](const Blob& blob) { return ResolveAsset(blob); });
+//      auto upload = asset.Then([](const Asset& asset) { UploadToComponent(asset); });
+//      auto done = graph.WhenAll({ upload, otherUpload });
+//
+//
+//  #include "ThreadModel/TaskGraph.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "ThreadModel/JobPool.h"
+#include "ThreadModel/UniqueFunction.h"
+#include <condition_variable>
+#include <exception>
+#include <optional>
+#include <type_traits>
+
+
+namespace yaget::mt
+{
+    // Pending - waiting on dependencies or in JobPool queue, can still be cancelled
+    // Done, Failed and Cancelled are final
+    enum class TaskState { Pending, Running, Done, Failed, Cancelled };
+
+    namespace internal
+    {
+        class TaskNode : public Noncopyable<TaskNode>, public std::enable_shared_from_this<TaskNode>
+        {
+        public:
+            using Dependencies = std::vector<std::shared_ptr<TaskNode>>;
+
+            explicit TaskNode(JobPool& pool, UniqueFunction<void()> work);
+            virtual ~TaskNode() = default;
+
+            // Hook up to dependencies, task is added to the pool once last one finished.
+            // Called once, right after creation.
+            void Schedule(const Dependencies& dependencies);
+
+            // Return true if task was stopped before it started running
+            bool Cancel();
+            void Wait();
+
+            TaskState State() const { return mState; }
+            std::exception_ptr Exception() const;
+            JobPool& Pool() const { return mPool; }
+
+        private:
+            void AddContinuation(std::shared_ptr<TaskNode> continuation);
+            void OnDependencyFinished(bool succeeded);
+            void Execute();
+            void Finish(TaskState state);
+
+            JobPool& mPool;
+            // cleared when task finishes, so it does not hold on to captured results of dependencies
+            UniqueFunction<void()> mWork;
+            // task without work finishes inline without going trough the pool (WhenAll)
+            const bool mHasWork;
+            std::atomic<TaskState> mState{ TaskState::Pending };
+            // dependencies not finished yet, plus one released at the end of Schedule
+            std::atomic<std::size_t> mNumPendingDependencies{ 1 };
+            std::atomic_bool mDependencyFailed{ false };
+
+            mutable std::mutex mMutex;
+            std::condition_variable mFinishedCondition;
+            bool mFinished = false;
+            std::exception_ptr mException;
+            Dependencies mContinuations;
+        };
+
+        template <typename T>
+        struct TaskResult
+        {
+            std::optional<T> mValue;
+        };
+
+        template <>
+        struct TaskResult<void>
+        {};
+
+        template <typename T, typename F>
+        auto CreateTask(JobPool& pool, F&& function, const TaskNode::Dependencies& dependencies);
+
+    } // namespace internal
+
+
+    //! Untyped handle to a task, it can be used as a dependency for any other task.
+    //! Copies refer to the same task, default constructed one is invalid.
+    class Task
+    {
+    public:
+        Task() = default;
+
+        bool IsValid() const { return mNode != nullptr; }
+        TaskState State() const { return mNode->State(); }
+        bool IsDone() const { return State() != TaskState::Pending && State() != TaskState::Running; }
+
+        // Stop task (and all of it's continuations) if it did not start running yet.
+        // Return false if task is already running or finished.
+        bool Cancel() const { return mNode->Cancel(); }
+
+        // Blocks until task is finished, do not call from task running on the same pool.
+        void Wait() const { mNode->Wait(); }
+
+        // Exception thrown by task when State() is Failed, nullptr otherwise
+        std::exception_ptr Exception() const { return mNode->Exception(); }
+
+    protected:
+        explicit Task(std::shared_ptr<internal::TaskNode> node)
+            : mNode(std::move(node))
+        {}
+
+        std::shared_ptr<internal::TaskNode> mNode;
+
+        friend class TaskGraph;
+    };
+
+
+    //! Handle to a task that returns T, which is passed to continuations added with Then.
+    template <typename T>
+    class TaskHandle : public Task
+    {
+    public:
+        TaskHandle() = default;
+
+        // Only valid when State() is Done
+        template <typename U = T> requires (!std::is_void_v<U>)
+        const U& Result() const
+        {
+            YAGET_ASSERT(State() == TaskState::Done, "Task result requested from task that is not done.");
+            return *mResult->mValue;
+        }
+
+        // Run continuation with result of this task once it's done.
+        // Continuation is cancelled if this task fails or is cancelled.
+        template <typename F>
+        auto Then(F&& continuation) const
+        {
+            YAGET_ASSERT(IsValid(), "Then called on invalid task handle.");
+
+            if constexpr (std::is_void_v<T>)
+            {
+                using Result_t = std::invoke_result_t<F>;
+                return internal::CreateTask<Result_t>(mNode->Pool(), std::forward<F>(continuation), { mNode });
+            }
+            else
+            {
+                // only result is captured, node of this task already holds on to continuation
+                using Result_t = std::invoke_result_t<F, const T&>;
+                return internal::CreateTask<Result_t>(mNode->Pool(), [result = mResult, continuation = std::forward<F>(continuation)]() mutable
+                {
+                    return continuation(*result->mValue);
+                }, { mNode });
+            }
+        }
+
+    private:
+        TaskHandle(std::shared_ptr<internal::TaskNode> node, std::shared_ptr<internal::TaskResult<T>> result)
+            : Task(std::move(node))
+            , mResult(std::move(result))
+        {}
+
+        // shared by this task work (while it runs), handles and continuations
+        std::shared_ptr<internal::TaskResult<T>> mResult;
+
+        template <typename R, typename F>
+        friend auto internal::CreateTask(JobPool& pool, F&& function, const internal::TaskNode::Dependencies& dependencies);
+        friend class TaskGraph;
+    };
+
+
+    //! Creates tasks on JobPool. Pool must outlive all tasks created here.
+    class TaskGraph : public Noncopyable<TaskGraph>
+    {
+    public:
+        explicit TaskGraph(JobPool& pool)
+            : mPool(pool)
+        {}
+
+        // Run task once all dependencies are done
+        template <typename F>
+        auto Add(F&& task, const std::vector<Task>& dependencies = {})
+        {
+            using Result_t = std::invoke_result_t<F>;
+            return internal::CreateTask<Result_t>(mPool, std::forward<F>(task), Nodes(dependencies));
+        }
+
+        // Task that is done when all tasks are done, or cancelled when any of them fails or is cancelled
+        TaskHandle<void> WhenAll(const std::vector<Task>& tasks);
+
+    private:
+        static internal::TaskNode::Dependencies Nodes(const std::vector<Task>& tasks);
+
+        JobPool& mPool;
+    };
+
+
+    template <typename T, typename F>
+    auto internal::CreateTask(JobPool& pool, F&& function, const TaskNode::Dependencies& dependencies)
+    {
+        auto result = std::make_shared<TaskResult<T>>();
+        UniqueFunction<void()> work;
+        if constexpr (std::is_void_v<T>)
+        {
+            work = [function = std::forward<F>(function)]() mutable { function(); };
+        }
+        else
+        {
+            work = [result, function = std::forward<F>(function)]() mutable { result->mValue.emplace(function()); };
+        }
+
+        auto node = std::make_shared<TaskNode>(pool, std::move(work));
+        node->Schedule(dependencies);
+        return TaskHandle<T>(std::move(node), std::move(result));
+    }
+
+} // namespace yaget::mt
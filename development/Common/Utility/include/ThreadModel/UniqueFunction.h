@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////
+// UniqueFunction.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Move only replacement for std::function with inline storage.
+//      Callables up to InlineSize bytes (which are nothrow movable) are stored
+//      inside the object itself, bigger ones are allocated on the heap.
+//      Since it's never copied, callable can own move only data (unique_ptr, io::Buffer, ...).
+//      Used as JobProcessor::Task_t, so adding task to JobPool does not allocate
+//      for typical lambda capturing few pointers.
+//
+//      mt::UniqueFunction<void()> task = [buffer = std::move(buffer)]() { Process(buffer); };
+//      task();
+//
+//
+//  #include "ThreadModel/UniqueFunction.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "YagetCore.h"
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace yaget::mt
+{
+    namespace internal
+    {
+        template <typename T>
+        struct IsStdFunction : std::false_type {};
+
+        template <typename S>
+        struct IsStdFunction<std::function<S>> : std::true_type {};
+
+    } // namespace internal
+
+    template <typename Signature, std::size_t InlineSize = 64>
+    class UniqueFunction;
+
+    template <typename R, typename... Args, std::size_t InlineSize>
+    class UniqueFunction<R(Args...), InlineSize>
+    {
+        template <typename F>
+        static constexpr bool kFitsInline = sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+    public:
+        UniqueFunction() noexcept = default;
+        UniqueFunction(std::nullptr_t) noexcept {}
+
+        template <typename F>
+            requires (!std::is_same_v<std::remove_cvref_t<F>, UniqueFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+        UniqueFunction(F&& function)
+        {
+            using Function_t = std::decay_t<F>;
+
+            if constexpr (std::is_pointer_v<Function_t> || std::is_member_pointer_v<Function_t> || internal::IsStdFunction<Function_t>::value)
+            {
+                // empty std::function or null function pointer stays empty
+                if (function == nullptr)
+                {
+                    return;
+                }
+            }
+
+            if constexpr (kFitsInline<Function_t>)
+            {
+                ::new (static_cast<void*>(mStorage)) Function_t(std::forward<F>(function));
+                mOperations = &InlineOperations<Function_t>;
+            }
+            else
+            {
+                *reinterpret_cast<Function_t**>(mStorage) = new Function_t(std::forward<F>(function));
+                mOperations = &HeapOperations<Function_t>;
+            }
+        }
+
+        UniqueFunction(UniqueFunction&& other) noexcept
+        {
+            MoveFrom(other);
+        }
+
+        UniqueFunction& operator=(UniqueFunction&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                MoveFrom(other);
+            }
+
+            return *this;
+        }
+
+        UniqueFunction& operator=(std::nullptr_t) noexcept
+        {
+            Reset();
+            return *this;
+        }
+
+        UniqueFunction(const UniqueFunction&) = delete;
+        UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+        ~UniqueFunction() { Reset(); }
+
+        explicit operator bool() const noexcept { return mOperations != nullptr; }
+
+        // true if callable is stored in this object, false if empty or allocated on the heap
+        bool IsInline() const noexcept { return mOperations && mOperations->mInline; }
+
+        R operator()(Args... args) const
+        {
+            YAGET_ASSERT(mOperations, "Calling empty UniqueFunction.");
+            return mOperations->mInvoke(mStorage, std::forward<Args>(args)...);
+        }
+
+    private:
+        struct Operations
+        {
+            R (*mInvoke)(void* storage, Args&&... args);
+            // move construct into uninitialized destination and destroy source
+            void (*mRelocate)(void* destination, void* source) noexcept;
+            void (*mDestroy)(void* storage) noexcept;
+            bool mInline;
+        };
+
+        template <typename F>
+        static constexpr Operations InlineOperations =
+        {
+            [](void* storage, Args&&... args) -> R { return std::invoke(*static_cast<F*>(storage), std::forward<Args>(args)...); },
+            [](void* destination, void* source) noexcept
+            {
+                F* function = static_cast<F*>(source);
+                ::new (destination) F(std::move(*function));
+                function->~F();
+            },
+            [](void* storage) noexcept { static_cast<F*>(storage)->~F(); },
+            true
+        };
+
+        template <typename F>
+        static constexpr Operations HeapOperations =
+        {
+            [](void* storage, Args&&... args) -> R { return std::invoke(**static_cast<F**>(storage), std::forward<Args>(args)...); },
+            [](void* destination, void* source) noexcept { *static_cast<F**>(destination) = *static_cast<F**>(source); },
+            [](void* storage) noexcept { delete *static_cast<F**>(storage); },
+            false
+        };
+
+        void MoveFrom(UniqueFunction& other) noexcept
+        {
+            if (other.mOperations)
+            {
+                other.mOperations->mRelocate(mStorage, other.mStorage);
+                mOperations = std::exchange(other.mOperations, nullptr);
+            }
+        }
+
+        void Reset() noexcept
+        {
+            if (mOperations)
+            {
+                std::exchange(mOperations, nullptr)->mDestroy(mStorage);
+            }
+        }
+
+        // callable is invoked trough const operator(), the same as std::function
+        alignas(std::max_align_t) mutable std::byte mStorage[InlineSize];
+        const Operations* mOperations = nullptr;
+    };
+
+} // namespace yaget::mt
@@ -5,6 +5,9 @@
 //
 // NOTES:
 //      Provides multi threaded support for reading and writing to data
+//      Variable - mutex around T, every read and write copies T
+//      SharedVariable - read mostly T, readers get shared immutable snapshot
+//      SeqLockVariable - read mostly small trivially copyable T, readers never lock
 //
 //
 // #include "ThreadModel/Variables.h"
@@ -14,7 +17,13 @@
 #pragma once
 
 #include "YagetCore.h"
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <type_traits>
 
 
 namespace yaget::mt
@@ -101,6 +110,176 @@ namespace yaget::mt
         mutable std::mutex mMutex;
     };
 
+
+    //--------------------------------------------------------------------------------------------------
+    //! Read mostly data (RCU style). Current value is kept as immutable snapshot, readers
+    //! take reference to it and never copy T or wait for writer that is building new value.
+    //! Writers copy current value, modify it and publish it as new snapshot, old snapshot
+    //! is released when last reader lets go of it. Writers are serialized, so updates are never lost.
+    //! Usage:
+    //!  SharedVariable<Strings> names;
+    //!  names.Update([](Strings& value) { value.push_back("foo"); });
+    //!  SharedVariable<Strings>::Snapshot current = names.Get();
+    //!  for (const auto& name : *current) {}
+    template<typename T>
+    class SharedVariable : public Noncopyable<SharedVariable<T>>
+    {
+    public:
+        using Type = T;
+        using Snapshot = std::shared_ptr<const T>;
+
+        template<typename... Args>
+        SharedVariable(Args&&... args) : mData(std::make_shared<const T>(std::forward<Args>(args)...))
+        {}
+
+        // current value, it does not change while snapshot is held
+        Snapshot Get() const
+        {
+            return mData.load(std::memory_order_acquire);
+        }
+
+        T GetValue() const
+        {
+            return *Get();
+        }
+
+        void operator =(T value)
+        {
+            Exchange(std::move(value));
+        }
+
+        // publish new value and return previous snapshot
+        Snapshot Exchange(T value)
+        {
+            Snapshot newData = std::make_shared<const T>(std::move(value));
+
+            std::unique_lock<std::mutex> mutexLock(mWriteMutex);
+            return mData.exchange(std::move(newData), std::memory_order_acq_rel);
+        }
+
+        // updater(T&) is called with copy of current value, which is published after updater returns
+        template<typename F>
+        void Update(F&& updater)
+        {
+            std::unique_lock<std::mutex> mutexLock(mWriteMutex);
+            auto newData = std::make_shared<T>(*mData.load(std::memory_order_relaxed));
+            updater(*newData);
+            mData.store(std::move(newData), std::memory_order_release);
+        }
+
+    private:
+        std::atomic<Snapshot> mData;
+        std::mutex mWriteMutex;
+    };
+
+
+    //--------------------------------------------------------------------------------------------------
+    //! Sequence lock for small, trivially copyable T (bounds, transforms, settings, ...).
+    //! Readers copy value without any lock and retry if writer changed it in a middle of a copy,
+    //! writers are serialized and never wait for readers. Value is stored as atomic words,
+    //! so concurrent copy is well defined.
+    //! Usage:
+    //!  SeqLockVariable<math::Box> bounds(0.0f);
+    //!  bounds = newBounds;
+    //!  math::Box current = bounds;
+    template<typename T>
+    class SeqLockVariable : public Noncopyable<SeqLockVariable<T>>
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>, "SeqLockVariable requires trivially copyable and default constructible type.");
+
+    public:
+        using Type = T;
+
+        template<typename... Args>
+        SeqLockVariable(Args&&... args)
+        {
+            Set(T(std::forward<Args>(args)...));
+        }
+
+        T operator =(const T& v)
+        {
+            Set(v);
+            return v;
+        }
+
+        operator T() const
+        {
+            return Get();
+        }
+
+        T Get() const
+        {
+            Words words;
+            while (true)
+            {
+                const uint64_t sequence = mSequence.load(std::memory_order_acquire);
+                // odd sequence means that writer is in a middle of update
+                if ((sequence & 1) == 0)
+                {
+                    for (std::size_t i = 0; i < NumWords; ++i)
+                    {
+                        words[i] = mWords[i].load(std::memory_order_relaxed);
+                    }
+
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (mSequence.load(std::memory_order_relaxed) == sequence)
+                    {
+                        break;
+                    }
+                }
+
+                std::this_thread::yield();
+            }
+
+            T value;
+            std::memcpy(&value, words.data(), sizeof(T));
+            return value;
+        }
+
+        void Set(const T& value)
+        {
+            std::unique_lock<std::mutex> mutexLock(mWriteMutex);
+            Store(value);
+        }
+
+        // updater(T&) is called with current value, which is published after updater returns
+        template<typename F>
+        void Update(F&& updater)
+        {
+            std::unique_lock<std::mutex> mutexLock(mWriteMutex);
+            T value = Get();
+            updater(value);
+            Store(value);
+        }
+
+    private:
+        using Word = std::size_t;
+        static constexpr std::size_t NumWords = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+        using Words = std::array<Word, NumWords>;
+
+        // caller holds mWriteMutex
+        void Store(const T& value)
+        {
+            Words words{};
+            std::memcpy(words.data(), &value, sizeof(T));
+
+            const uint64_t sequence = mSequence.load(std::memory_order_relaxed);
+            mSequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (std::size_t i = 0; i < NumWords; ++i)
+            {
+                mWords[i].store(words[i], std::memory_order_relaxed);
+            }
+
+            mSequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        std::array<std::atomic<Word>, NumWords> mWords{};
+        std::atomic<uint64_t> mSequence{ 0 };
+        std::mutex mWriteMutex;
+    };
+
     
     //--------------------------------------------------------------------------------------------------
     // Provides specialized mt read and write for shared_ptr<T>
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////
+// WorkStealingQueue.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki.
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Chase-Lev work stealing deque (Le, Pop, Cohen, Nardelli,
+//      "Correct and Efficient Work-Stealing for Weak Memory Models").
+//      Owner thread pushes and pops at the bottom (LIFO), any other
+//      thread can steal from the top (FIFO) without locking.
+//      Used by JobPool, one per worker thread.
+//
+//
+//  #include "ThreadModel/WorkStealingQueue.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "YagetCore.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace yaget::mt
+{
+    //! T must be a pointer, nullptr is returned when there is nothing to pop or steal.
+    //! Memory grows as needed, old buffers are kept until queue is destroyed since thieves may still read from them.
+    template <typename T>
+    class WorkStealingQueue : public Noncopyable<WorkStealingQueue<T>>
+    {
+        static_assert(std::is_pointer_v<T>, "WorkStealingQueue only holds pointers.");
+
+    public:
+        explicit WorkStealingQueue(std::int64_t capacity = 256)
+        {
+            YAGET_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0, "WorkStealingQueue capacity '%d' must be power of 2.", capacity);
+
+            mBuffers.emplace_back(std::make_unique<Buffer>(capacity));
+            mBuffer.store(mBuffers.back().get(), std::memory_order_relaxed);
+        }
+
+        // Owner only, add item at the bottom
+        void Push(T item)
+        {
+            const std::int64_t bottom = mBottom.load(std::memory_order_relaxed);
+            const std::int64_t top = mTop.load(std::memory_order_acquire);
+            Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+
+            if (bottom - top > buffer->mCapacity - 1)
+            {
+                buffer = Grow(buffer, bottom, top);
+            }
+
+            buffer->Put(bottom, item);
+            mBottom.store(bottom + 1, std::memory_order_release);
+        }
+
+        // Owner only, take last pushed item or nullptr if empty
+        T Pop()
+        {
+            const std::int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+            Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+            mBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = mTop.load(std::memory_order_relaxed);
+
+            T item = nullptr;
+            if (top <= bottom)
+            {
+                item = buffer->Get(bottom);
+                if (top == bottom)
+                {
+                    // last item, race against thieves for it
+                    if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    {
+                        item = nullptr;
+                    }
+                    mBottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        // Any thread, take oldest item or nullptr if empty or lost the race to other thread
+        T Steal()
+        {
+            std::int64_t top = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t bottom = mBottom.load(std::memory_order_acquire);
+
+            if (top < bottom)
+            {
+                T item = mBuffer.load(std::memory_order_acquire)->Get(top);
+                if (mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    return item;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Approximate if called while other threads push/pop/steal
+        bool IsEmpty() const
+        {
+            return mBottom.load(std::memory_order_acquire) <= mTop.load(std::memory_order_acquire);
+        }
+
+        std::size_t Size() const
+        {
+            const std::int64_t size = mBottom.load(std::memory_order_acquire) - mTop.load(std::memory_order_acquire);
+            return size > 0 ? static_cast<std::size_t>(size) : 0;
+        }
+
+    private:
+        struct Buffer
+        {
+            explicit Buffer(std::int64_t capacity)
+                : mCapacity(capacity)
+                , mItems(std::make_unique<std::atomic<T>[]>(capacity))
+            {}
+
+            T Get(std::int64_t index) const { return mItems[index & (mCapacity - 1)].load(std::memory_order_relaxed); }
+            void Put(std::int64_t index, T item) { mItems[index & (mCapacity - 1)].store(item, std::memory_order_relaxed); }
+
+            const std::int64_t mCapacity;
+            std::unique_ptr<std::atomic<T>[]> mItems;
+        };
+
+        Buffer* Grow(Buffer* buffer, std::int64_t bottom, std::int64_t top)
+        {
+            auto newBuffer = std::make_unique<Buffer>(buffer->mCapacity * 2);
+            for (std::int64_t i = top; i < bottom; ++i)
+            {
+                newBuffer->Put(i, buffer->Get(i));
+            }
+
+            Buffer* result = mBuffers.emplace_back(std::move(newBuffer)).get();
+            mBuffer.store(result, std::memory_order_release);
+            return result;
+        }
+
+        alignas(64) std::atomic<std::int64_t> mTop{ 0 };
+        alignas(64) std::atomic<std::int64_t> mBottom{ 0 };
+        std::atomic<Buffer*> mBuffer{ nullptr };
+        // owner only, current one is the last
+        std::vector<std::unique_ptr<Buffer>> mBuffers;
+    };
+
+} // namespace yaget::mt
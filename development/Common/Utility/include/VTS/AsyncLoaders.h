@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////
+// AsyncLoaders.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Coroutine awaitables for BlobLoader and VirtualTransportSystem.
+//      Awaiting coroutine is resumed from loader thread that finished request,
+//      co_await mt::SwitchTo(pool) to move it somewhere else.
+//
+//      mt::Coroutine<> LoadTextures(io::VirtualTransportSystem& vts, io::Tags tags)
+//      {
+//          std::vector<std::shared_ptr<TextureAsset>> textures = co_await io::RequestBlobs<TextureAsset>(vts, tags);
+//          io::Buffer buffer = co_await io::ReadBlob(blobLoader, "$(Data)/foo.bin");
+//      }
+//
+//
+//  #include "VTS/AsyncLoaders.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+
+#pragma once
+
+#include "ThreadModel/Coroutine.h"
+#include "VTS/VirtualTransportSystem.h"
+
+
+namespace yaget::io
+{
+    //! co_await ReadBlob(loader, fileName) to get content of the file
+    inline auto ReadBlob(BlobLoader& blobLoader, const std::string& fileName)
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                mBlobLoader.AddTask(mFileName, [this, handle](const io::Buffer& fileData)
+                {
+                    mBuffer = fileData;
+                    handle.resume();
+                });
+            }
+
+            io::Buffer await_resume() { return std::move(mBuffer); }
+
+            BlobLoader& mBlobLoader;
+            std::string mFileName;
+            io::Buffer mBuffer;
+        };
+
+        return Awaiter{ blobLoader, fileName, {} };
+    }
+
+
+    //! co_await RequestBlobs<A>(vts, tags) to get all assets for tags, in the same order as tags.
+    //! Tags which did not produce asset are skipped.
+    template <typename A = io::Asset>
+    auto RequestBlobs(VirtualTransportSystem& vts, const std::vector<io::Tag>& tags)
+    {
+        using AssetPtr = std::shared_ptr<A>;
+
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return mTags.empty(); }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                mVTS.RequestBlob(mTags, [this](std::shared_ptr<io::Asset> asset)
+                {
+                    std::lock_guard<std::mutex> locker(mMutex);
+                    mAssets.insert_or_assign(asset->mTag.mGuid, io::asset_cast<A>(asset));
+                }, nullptr, [handle]()
+                {
+                    handle.resume();
+                });
+            }
+
+            std::vector<AssetPtr> await_resume()
+            {
+                std::vector<AssetPtr> result;
+                for (const auto& tag : mTags)
+                {
+                    if (const auto it = mAssets.find(tag.mGuid); it != mAssets.end())
+                    {
+                        result.push_back(it->second);
+                    }
+                }
+
+                return result;
+            }
+
+            VirtualTransportSystem& mVTS;
+            std::vector<io::Tag> mTags;
+            std::mutex mMutex;
+            std::map<Guid, AssetPtr> mAssets;
+        };
+
+        return Awaiter{ vts, tags, {}, {} };
+    }
+
+    template <typename A = io::Asset>
+    auto RequestBlobs(VirtualTransportSystem& vts, const VirtualTransportSystem::Sections& sections)
+    {
+        return RequestBlobs<A>(vts, vts.GetTags(sections));
+    }
+
+} // namespace yaget::io
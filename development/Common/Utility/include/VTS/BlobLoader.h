@@ -18,6 +18,7 @@
 #pragma once
 
 #include "YagetCore.h"
+#include "Metrics/Concurrency.h"
 #include "ThreadModel/FileLoader.h"
 #include <functional>
 
@@ -58,6 +59,7 @@ namespace yaget
 
             ErrorCallback mErrorCallback;
             std::atomic_size_t mCounter{ 0 };
+            metrics::Gauge mCounterGauge{ "BlobLoader.Files" };    // mCounter as trace counter track
             mt::JobPool mJobPool;
             std::unique_ptr<io::DataLoader> mFileLoader;
             // on destruction, if true, it will process all the files before fully exiting.
@@ -7,6 +7,7 @@
 //
 //  NOTES:
 //      Provides virtual access to assets and how to load them asynced
+//      Pending blob requests and bytes of cached assets are traced as VTS.* counter tracks.
 //
 //
 //  #include "VTS/VirtualTransportSystem.h"
@@ -19,6 +20,7 @@
 #include "Database/Database.h"
 #include "Debugging/DevConfiguration.h"
 #include "Json/JsonHelpers.h"
+#include "Metrics/Concurrency.h"
 #include "Platform/Support.h"
 #include "Streams/Buffers.h"
 #include "VTS/BlobLoader.h"
@@ -125,6 +127,9 @@ namespace yaget
             size_t RequestBlob(const Sections& sections, BlobAssetCallback blobAssetCallback, std::atomic_size_t* tagsCounter) { return RequestBlob(GetTags(sections), blobAssetCallback, tagsCounter); }
             size_t RequestBlob(const io::Tag& tag, BlobAssetCallback blobAssetCallback, std::atomic_size_t* tagsCounter) { return RequestBlob(std::vector<io::Tag>{ tag }, blobAssetCallback, tagsCounter); }
             size_t RequestBlob(const std::vector<io::Tag>& tags, BlobAssetCallback blobAssetCallback, std::atomic_size_t* tagsCounter);
+            // Same as above, plus doneCallback is called once after all tags were processed, including ones that did not produce an asset.
+            // It is called from thread that processed last tag, or from this call if there is nothing to process.
+            size_t RequestBlob(const std::vector<io::Tag>& tags, BlobAssetCallback blobAssetCallback, std::atomic_size_t* tagsCounter, DoneCallback doneCallback);
 
             template<typename A>
             size_t RequestBlob(const Section& section, std::function<void(std::shared_ptr<A>)> blobAssetCallback, std::atomic_size_t* tagsCounter);
@@ -217,6 +222,8 @@ namespace yaget
             mutable std::mutex mMutexAssets;        // control write/read to preloaded assets
             std::map<io::Tag, std::shared_ptr<Asset>> mAssets;
             std::map<io::Tag, std::shared_ptr<Asset>> mOverrideAssets;
+            metrics::Gauge mPendingRequestsGauge{ "VTS.PendingRequests" };  // requested tags which did not get callback yet
+            metrics::Gauge mCachedBytesGauge{ "VTS.CachedBytes" };          // buffer bytes of assets and override assets
             Database mDatabase;                     // source of trues
             std::shared_ptr<SectionEntriesCollector> mSectionEntriesCollector;  // only used in gathering blobs on the disk and matching with db.
             BlobLoader mBlobLoader;                 // make sure that is always last in class here 
@@ -10,7 +10,7 @@ yaget::Application::Application(const std::string& title, items::Director& direc
     , IdCache(director.IdCache())
     , mDirector(director)
     , mInputDevice(vts)
-    , mGeneralPoolThread(std::make_unique<mt::JobPool>("AppPool", dev::CurrentConfiguration().mDebug.mThreads.App, mt::JobPool::Behaviour::StartAsPause))
+    , mGeneralPoolThread(std::make_unique<mt::JobPool>("AppPool", dev::CurrentConfiguration().mDebug.mThreads.App, mt::JobPool::Behaviour::StartAsPause, mt::JobPool::ConfiguredThreadOptions("App")))
     , mVTS(vts)
 {
     YLOG_INFO("INIT", "Created Application '%s'.", title.c_str());
@@ -31,16 +31,17 @@ void yaget::Application::onRenderTask(const Application::TickLogic& renderCallba
 
     mRenderClock.Resync();
     time::Microsecond_t lastRenderTime = mRenderClock.GetRealTime();
+    metrics::Counter renderFrameTime(YAGET_TRACE_NAME("Frame.RenderTime"));
 
     while (!mQuit)
     {
         FrameCounter::Collector fpsCollector(mRenderFrameCounter);
 
-        metrics::Channel rChannel("RenderTick");
+        metrics::Channel rChannel(YAGET_TRACE_NAME("RenderTick"));
 
         if (IsSuspended())
         {
-            metrics::Channel sChannel("Suspended");
+            metrics::Channel sChannel(YAGET_TRACE_NAME("Suspended"));
             platform::Sleep([this] { return IsSuspended(); });
         }
 
@@ -50,6 +51,7 @@ void yaget::Application::onRenderTask(const Application::TickLogic& renderCallba
         const time::Microsecond_t currentRenderTime = mRenderClock.GetRealTime();
         const time::Microsecond_t deltaTime = currentRenderTime - lastRenderTime;
         lastRenderTime = currentRenderTime;
+        renderFrameTime.Set(deltaTime);
 
         mRenderClock.Tick(deltaTime);
     }
@@ -73,6 +75,7 @@ void yaget::Application::onLogicTask(const TickLogic& logicCallback, const TickL
 
     const time::Microsecond_t kFixedDeltaTime = time::GetDeltaTime(dev::CurrentConfiguration().mInit.LogicTick);
     const metrics::PerformancePolicy defaultPerformancePolicy;
+    metrics::Counter logicFrameTime(YAGET_TRACE_NAME("Frame.LogicTime"));
 
     mApplicationClock.Resync();
     time::Microsecond_t startTime = platform::GetRealTime(time::kMicrosecondUnit);
@@ -94,7 +97,7 @@ void yaget::Application::onLogicTask(const TickLogic& logicCallback, const TickL
         {
             FrameCounter::Collector fpsCollector(mLogicFrameCounter);
 
-            metrics::Channel gameChannel("GameTick");
+            metrics::Channel gameChannel(YAGET_TRACE_NAME("GameTick"));
 
             const time::Microsecond_t startProcessTime = platform::GetRealTime(time::kMicrosecondUnit);
 
@@ -104,7 +107,7 @@ void yaget::Application::onLogicTask(const TickLogic& logicCallback, const TickL
 
             if (logicCallback)
             {
-                metrics::Channel channel("Callback");
+                metrics::Channel channel(YAGET_TRACE_NAME("Callback"));
 
                 logicCallback(mApplicationClock, channel);
             }                                                                                                                                      
@@ -112,6 +115,10 @@ void yaget::Application::onLogicTask(const TickLogic& logicCallback, const TickL
             mApplicationClock.Tick(kFixedDeltaTime);
 
             const time::Microsecond_t actualProcessTime = platform::GetRealTime(time::kMicrosecondUnit) - startProcessTime;
+            logicFrameTime.Set(actualProcessTime);
+            // one sample of all counter tracks (pool queues, vts, allocators) per logic tick
+            metrics::SampleGauges();
+
             if (actualProcessTime > kFixedDeltaTime)
             {
                 YLOG_NOTICE("PROF", "Tick Loop tool too long. Budget: '%d' (mc), Actual: '%d' (mc).", kFixedDeltaTime, actualProcessTime);
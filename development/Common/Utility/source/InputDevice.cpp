@@ -436,7 +436,7 @@ void input::InputDevice::ProcessRecord(const Record& record)
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 uint32_t input::InputDevice::Tick(const time::GameClock& gameClock, const metrics::PerformancePolicy& performancePolicy, metrics::Channel& /*channel*/)
 {
-    metrics::Channel channel("Input.Tick");
+    metrics::Channel channel(YAGET_TRACE_NAME("Input.Tick"));
 
     time::Microsecond_t begginingTime = platform::GetRealTime(time::kMicrosecondUnit);
     time::Microsecond_t maxBudgetTime = performancePolicy.mBudget == std::numeric_limits<time::Microsecond_t>::max() ? performancePolicy.mBudget : begginingTime + performancePolicy.mBudget;
@@ -461,7 +461,7 @@ uint32_t input::InputDevice::Tick(const time::GameClock& gameClock, const metric
     // we simply do not want to hit this marker for empty list
     if (!inputsToProcess.empty())
     {
-        metrics::Channel span("Input.Processing");
+        metrics::Channel span(YAGET_TRACE_NAME("Input.Processing"));
 
         while (!inputsToProcess.empty())
         {
@@ -5,6 +5,7 @@
 
 #if YAGET_CONC_METRICS_ENABLED == 1
 #include <atlbase.h>
+#include <vector>
 
 YAGET_COMPILE_GLOBAL_SETTINGS("(WIP) Concurenty Metrics Included")
 
@@ -16,39 +17,85 @@ namespace
 
         return profSaver;
     }
+
+    yaget::metrics::TraceNameId ChannelCategory()
+    {
+        return YAGET_TRACE_NAME("Channel");
+    }
+
+    yaget::metrics::TraceNameId TrackerCategory()
+    {
+        return YAGET_TRACE_NAME("Tracker");
+    }
+
+    yaget::metrics::TraceNameId CounterCategory()
+    {
+        return YAGET_TRACE_NAME("Counter");
+    }
+
+    // all existing gauges, it outlives any gauge, since first gauge constructs it
+    struct GaugeRegistry
+    {
+        std::mutex mMutex;
+        std::vector<yaget::metrics::Gauge*> mGauges;
+    };
+
+    GaugeRegistry& GetGaugeRegistry()
+    {
+        static GaugeRegistry gaugeRegistry;
+
+        return gaugeRegistry;
+    }
 }
 
 
-yaget::metrics::internal::Metric::Metric(const std::string& message, const std::source_location& location)
-    : mMessage(message)
+yaget::metrics::internal::Metric::Metric(const TraceName& name, const std::source_location& location)
+    : mName(name)
     , mLocation(location)
     , mStart(platform::GetRealTime(yaget::time::kMicrosecondUnit))
     , mTreadID(platform::CurrentThreadId())
 {}
 
 
-yaget::metrics::Channel::Channel(const std::string& message, const std::source_location& location)
-    : internal::Metric(message, location)
+yaget::metrics::internal::Metric::Metric(TraceNameId nameId, const std::source_location& location)
+    : mNameId(nameId)
+    , mLocation(location)
+    , mStart(platform::GetRealTime(yaget::time::kMicrosecondUnit))
+    , mTreadID(platform::CurrentThreadId())
 {
-    GetSaver().AddProfileStamp({ mMessage, mStart, mStart, mTreadID, TraceRecord::Event::Begin, 0, "Channel" });
+    mName[0] = '\0';
+}
+
+
+yaget::metrics::Channel::Channel(std::string_view message, const std::source_location& location)
+    : Channel(MakeTraceName(message), location)
+{}
+
+
+yaget::metrics::Channel::Channel(const TraceName& name, const std::source_location& location)
+    : internal::Metric(name, location)
+{
+    GetSaver().AddProfileStamp({ mNameId, mName, mStart, mStart, mTreadID, TraceRecord::Event::Begin, 0, ChannelCategory() });
+}
+
+
+yaget::metrics::Channel::Channel(TraceNameId nameId, const std::source_location& location)
+    : internal::Metric(nameId, location)
+{
+    GetSaver().AddProfileStamp({ mNameId, mName, mStart, mStart, mTreadID, TraceRecord::Event::Begin, 0, ChannelCategory() });
 }
 
 
 yaget::metrics::Channel::~Channel()
 {
-    if (mMessage == "T.TraceDataSaver.1")
-    {
-        int z = 0;
-        z;
-    }
     YAGET_ASSERT(mTreadID == platform::CurrentThreadId());
 
     const auto currentTime = platform::GetRealTime(yaget::time::kMicrosecondUnit);
-    GetSaver().AddProfileStamp({ mMessage, currentTime, currentTime, mTreadID, TraceRecord::Event::End, 0, "Channel" });
+    GetSaver().AddProfileStamp({ mNameId, mName, currentTime, currentTime, mTreadID, TraceRecord::Event::End, 0, ChannelCategory() });
 }
 
 
-void yaget::metrics::Channel::AddMessage(const std::string& message, MessageScope scope) const
+void yaget::metrics::Channel::AddMessage(std::string_view message, MessageScope scope) const
 {
     YAGET_ASSERT(mTreadID == platform::CurrentThreadId());
 
@@ -56,13 +103,13 @@ void yaget::metrics::Channel::AddMessage(const std::string& message, MessageScop
 }
 
 
-yaget::metrics::TimeSpan::TimeSpan(std::size_t id, const std::string& message, const std::source_location& location)
-    : internal::Metric(message, location)
+yaget::metrics::TimeSpan::TimeSpan(std::size_t id, std::string_view message, const std::source_location& location)
+    : internal::Metric(MakeTraceName(message), location)
     , mId(id)
 {
     if (mId)
     {
-        GetSaver().AddProfileStamp({ mMessage, mStart, mStart, mTreadID, TraceRecord::Event::FlowBegin, mId, "Tracker" });
+        GetSaver().AddProfileStamp({ mNameId, mName, mStart, mStart, mTreadID, TraceRecord::Event::FlowBegin, mId, TrackerCategory() });
     }
 }
 
@@ -73,46 +120,139 @@ yaget::metrics::TimeSpan::~TimeSpan()
     {
         const std::size_t threadID = platform::CurrentThreadId();
         const auto currentTime = platform::GetRealTime(time::kMicrosecondUnit);
-        GetSaver().AddProfileStamp({ mMessage, currentTime, currentTime, threadID, TraceRecord::Event::FlowEnd, mId, "Tracker" });
+        GetSaver().AddProfileStamp({ mNameId, mName, currentTime, currentTime, threadID, TraceRecord::Event::FlowEnd, mId, TrackerCategory() });
     }
 }
 
 
-void yaget::metrics::TimeSpan::AddMessage(const std::string& message) const
+void yaget::metrics::TimeSpan::AddMessage(std::string_view message) const
 {
     if (mId)
     {
         const std::size_t threadID = platform::CurrentThreadId();
         const auto currentTime = platform::GetRealTime(time::kMicrosecondUnit);
-        GetSaver().AddProfileStamp({ message, currentTime, currentTime, threadID, TraceRecord::Event::FlowPoint, mId, "Tracker" });
+        GetSaver().AddProfileStamp({ TraceNameId::Invalid, MakeTraceName(message), currentTime, currentTime, threadID, TraceRecord::Event::FlowPoint, mId, TrackerCategory() });
     }
 }
 
 
-yaget::metrics::Lock::Lock(const std::string& message, const std::source_location& location)
-    : internal::Metric(message, location)
-    , mChannel(message, location)
+yaget::metrics::Lock::Lock(const TraceName& name, const std::source_location& location)
+    : internal::Metric(name, location)
+    , mChannel(name, location)
 {
-    GetSaver().AddProfileStamp({ "Acquiring." + mMessage, mStart, mStart, mTreadID, TraceRecord::Event::Begin, 0, "Channel" });
+    GetSaver().AddProfileStamp({ TraceNameId::Invalid, MakeTraceName("Acquiring.", ToStringView(mName)), mStart, mStart, mTreadID, TraceRecord::Event::Begin, 0, ChannelCategory() });
 }
 
 
-yaget::metrics::UniqueLock::UniqueLock(std::mutex& mutex, const std::string& message, const std::source_location& location)
-    : Lock("Mutex:" + message, location)
+yaget::metrics::UniqueLock::UniqueLock(std::mutex& mutex, std::string_view message, const std::source_location& location)
+    : Lock(MakeTraceName("Mutex:", message), location)
     , mlocker(mutex)
 {
     const auto currentTime = platform::GetRealTime(time::kMicrosecondUnit);
-    GetSaver().AddProfileStamp({ "Acquiring." + mMessage, currentTime, currentTime, mTreadID, TraceRecord::Event::End, 0, "Channel" });
+    GetSaver().AddProfileStamp({ TraceNameId::Invalid, MakeTraceName("Acquiring.", ToStringView(mName)), currentTime, currentTime, mTreadID, TraceRecord::Event::End, 0, ChannelCategory() });
+}
+
+
+void yaget::metrics::MarkAddMessage(std::string_view message, MessageScope scope, size_t id)
+{
+    const std::size_t threadID = platform::CurrentThreadId();
+    const auto currentTime = platform::GetRealTime(time::kMicrosecondUnit);
+    GetSaver().AddProfileStamp({ TraceNameId::Invalid, MakeTraceName(message), currentTime, currentTime, threadID, TraceRecord::Event::Instant, id, TrackerCategory(), scope });
+}
+
+yaget::metrics::TraceNameId yaget::metrics::InternTraceName(std::string_view name)
+{
+    return GetSaver().InternName(name);
+}
+
+
+yaget::metrics::Counter::Counter(std::string_view name)
+    : mName(MakeTraceName(name))
+{}
+
+
+yaget::metrics::Counter::Counter(TraceNameId nameId)
+    : mNameId(nameId)
+{
+    mName[0] = '\0';
 }
 
 
-void yaget::metrics::MarkAddMessage(const std::string& message, MessageScope scope, size_t id)
+void yaget::metrics::Counter::Set(int64_t value)
 {
+    if (mValue.exchange(value, std::memory_order_relaxed) != value)
+    {
+        const auto currentTime = platform::GetRealTime(time::kMicrosecondUnit);
+        GetSaver().AddProfileStamp({ mNameId, mName, currentTime, currentTime, platform::CurrentThreadId(), TraceRecord::Event::Counter, 0, CounterCategory(), MessageScope::Thread, value });
+    }
+}
+
+
+yaget::metrics::Gauge::Gauge(std::string_view name)
+    : Gauge(MakeTraceName(name))
+{}
+
+
+yaget::metrics::Gauge::Gauge(const TraceName& name)
+    : Gauge(name, nullptr)
+{}
+
+
+yaget::metrics::Gauge::Gauge(const TraceName& name, Sampler sampler)
+    : mName(name)
+    , mSampler(std::move(sampler))
+{
+    GaugeRegistry& gaugeRegistry = GetGaugeRegistry();
+
+    std::unique_lock<std::mutex> mutexLock(gaugeRegistry.mMutex);
+    gaugeRegistry.mGauges.push_back(this);
+}
+
+
+yaget::metrics::Gauge::~Gauge()
+{
+    GaugeRegistry& gaugeRegistry = GetGaugeRegistry();
+
+    std::unique_lock<std::mutex> mutexLock(gaugeRegistry.mMutex);
+    std::erase(gaugeRegistry.mGauges, this);
+}
+
+
+void yaget::metrics::SampleGauges()
+{
+    // records are added after registry is unlocked, first record can create TraceCollector, which has gauges of it's own
+    struct Sample
+    {
+        TraceName mName;
+        int64_t mValue = 0;
+    };
+    thread_local std::vector<Sample> tSamples;
+    tSamples.clear();
+
+    {
+        GaugeRegistry& gaugeRegistry = GetGaugeRegistry();
+
+        std::unique_lock<std::mutex> mutexLock(gaugeRegistry.mMutex);
+        for (Gauge* gauge : gaugeRegistry.mGauges)
+        {
+            const int64_t value = gauge->mSampler ? gauge->mSampler() : gauge->mValue.load(std::memory_order_relaxed);
+            if (value != gauge->mSampledValue)
+            {
+                gauge->mSampledValue = value;
+                tSamples.push_back({ gauge->mName, value });
+            }
+        }
+    }
+
     const std::size_t threadID = platform::CurrentThreadId();
     const auto currentTime = platform::GetRealTime(time::kMicrosecondUnit);
-    GetSaver().AddProfileStamp({ message, currentTime, currentTime, threadID, TraceRecord::Event::Instant, id, "Tracker", scope });
+    for (const Sample& sample : tSamples)
+    {
+        GetSaver().AddProfileStamp({ TraceNameId::Invalid, sample.mName, currentTime, currentTime, threadID, TraceRecord::Event::Counter, 0, CounterCategory(), MessageScope::Thread, sample.mValue });
+    }
 }
 
+
 void yaget::metrics::MarkStartThread(uint32_t threadId, const char* threadName)
 {
     platform::SetThreadName(threadName, threadId);
@@ -1,5 +1,6 @@
 //#define YAGET_GET_STRUCT_SIZE
 #include "Metrics/PerformanceTracer.h"
+#include "Metrics/TraceFormat.h"
 #include "App/AppUtilities.h"
 #include "App/FileUtilities.h"
 #include "Debugging/DevConfiguration.h"
@@ -15,31 +16,6 @@ const int holder = yaget::meta::print_size_at_compile<yaget::metrics::TraceRecor
 
 namespace
 {
-    //enum class Event { Begin, End, Complete, Instant, AsyncBegin, AsyncEnd, AsyncPoint, Lock, FlowBegin, FlowEnd, FlowPoint };
-    const char* PH[]
-    {
-        "B",    // Begin
-        "E",    // End
-        "X",    // Complete
-        "I",    // Instant
-        "b",    // AsyncBegin
-        "e",    // AsyncEnd
-        "n",    // AsyncPoint
-        "X",    // Lock
-        "s",    // FlowBegin
-        "f",    // FlowEnd
-        "t"     // FlowPoint
-    };
-
-    //enum class MessageScope { Global, Process, Thread };
-    const char* S[]
-    {
-        "g",    // Global
-        "p",    // Process
-        "t"     // Thread
-    };
-
-
     std::string ResolveTraceFileName()
     {
         const auto& name = yaget::dev::CurrentConfiguration().mDebug.mMetrics.TraceFileName;
@@ -49,41 +25,9 @@ namespace
         return result ? traceFile : "";
     }
 
-    void SaveTraceRecord(const yaget::metrics::TraceRecord& profileStamp, std::ofstream& file)
+    bool IsBinaryTraceFormat()
     {
-        file << std::setprecision(3) << std::fixed;
-        file << ",{";
-        file << "\"name\":\"" << profileStamp.mName << "\",";
-        file << "\"pid\":0,";
-        file << "\"tid\":" << profileStamp.mThreadID << ",";
-        file << "\"ph\":\"" << PH[static_cast<int>(profileStamp.mEvent)] << "\",";
-        file << "\"cat\":\"" << profileStamp.mCategory << "\",";
-        file << "\"ts\":" << profileStamp.mStart;
-
-        switch (profileStamp.mEvent)
-        {
-        case yaget::metrics::TraceRecord::Event::Complete:
-        case yaget::metrics::TraceRecord::Event::Lock:
-            file << ",\"dur\":" << profileStamp.mEnd - profileStamp.mStart;
-
-            break;
-        case yaget::metrics::TraceRecord::Event::Begin:
-        case yaget::metrics::TraceRecord::Event::End:
-        case yaget::metrics::TraceRecord::Event::AsyncEnd:
-        case yaget::metrics::TraceRecord::Event::FlowEnd:
-        case yaget::metrics::TraceRecord::Event::AsyncPoint:
-        case yaget::metrics::TraceRecord::Event::FlowPoint:
-        case yaget::metrics::TraceRecord::Event::AsyncBegin:
-        case yaget::metrics::TraceRecord::Event::FlowBegin:
-            file << ",\"id\":" << profileStamp.mId;
-
-            break;
-        case yaget::metrics::TraceRecord::Event::Instant:
-            file << ",\"s\":\"" << S[static_cast<int>(profileStamp.mMessageScope)] << "\"";;
-            break;
-        }
-
-        file << "}";
+        return yaget::dev::CurrentConfiguration().mDebug.mMetrics.TraceFormat == "Binary";
     }
 }
 
@@ -95,19 +39,22 @@ yaget::metrics::TraceCollector::TraceCollector()
 {
     if (mTraceState == TraceState::StartSaver)
     {
-        mOutputStream.open(mFilePathName.c_str());
+        const bool binaryFormat = IsBinaryTraceFormat();
+        mOutputStream.open(mFilePathName.c_str(), binaryFormat ? std::ios::out | std::ios::binary : std::ios::out);
         if (mOutputStream.is_open())
         {
             const auto appName = util::ExpendEnv("$(AppName)", nullptr);
             const auto dateString = platform::GetCurrentDateTime();
 
-            mOutputStream << "{\"otherData\": {";
-            mOutputStream << "\"Application\": \"" + appName + "\",";
-            mOutputStream << "\"Date\": \"" + dateString + "\"";
-            mOutputStream << "},";
-
-            mOutputStream << "\"traceEvents\":[{}";
-            mOutputStream.flush();
+            if (binaryFormat)
+            {
+                mBinaryWriter = std::make_unique<trace::BinaryWriter>(mOutputStream, appName, dateString);
+                mBinaryWriter->Flush();
+            }
+            else
+            {
+                trace::WriteJsonHeader(mOutputStream, appName, dateString);
+            }
         }
         else
         {
@@ -129,54 +76,98 @@ yaget::metrics::TraceCollector::~TraceCollector()
 
         mTraceState = TraceState::Off;
         SaveCurrentProfileStamps();
-        YAGET_ASSERT(mProfileStamps.empty(), "There are still '%d' entries left in Profile Stamps.", mProfileStamps.size());
-
-        const auto& threadNames = yaget::platform::GetThreadNames();
 
-        for (const auto& [id, name] : threadNames)
+        if (mBinaryWriter)
+        {
+            mBinaryWriter->Flush();
+        }
+        else
         {
-            mOutputStream << ",{";
-            mOutputStream << "\"name\":\"thread_name\",";
-            mOutputStream << "\"ph\":\"M\",";
-            mOutputStream << "\"pid\":0,";
-            mOutputStream << "\"tid\":" << id << ",";
-            mOutputStream << "\"args\":{\"name\":\"" << name << "\"}";
-
-            mOutputStream << "}";
+            trace::WriteJsonFooter(mOutputStream);
         }
-        
-        mOutputStream << "]}";
-        mOutputStream.flush();
     }
 }
 
 
 //-------------------------------------------------------------------------------------------------
-void yaget::metrics::TraceCollector::AddProfileStamp(yaget::metrics::TraceRecord&& result)
+void yaget::metrics::TraceCollector::AddProfileStamp(const yaget::metrics::TraceRecord& record)
 {
-    if (mTraceState == TraceState::StartSaver)
+    TraceState traceState = mTraceState.load(std::memory_order_acquire);
+    if (traceState == TraceState::StartSaver)
     {
-        std::unique_lock<std::mutex> mutexLock(mmProfileStampMutex);
-        mDataSaver.AddTask([this]() { DataSaver(); });
-        mTraceState = TraceState::On;
+        // first record starts saver job, only one thread will do it
+        if (mTraceState.compare_exchange_strong(traceState, TraceState::On))
+        {
+            mDataSaver.AddTask([this]() { DataSaver(); });
+        }
+
+        traceState = TraceState::On;
     }
 
-    if (mTraceState == TraceState::On)
+    if (traceState != TraceState::On)
+    {
+        return;
+    }
+
+    ThreadBuffer& threadBuffer = GetThreadBuffer();
+    if (!threadBuffer.mRecords.TryPush(record))
+    {
+        threadBuffer.mNumDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (threadBuffer.mRecords.Size() == BufferCapacity / 2)
     {
-        std::size_t num = 0;
+        // do not wait for next save interval
+        mTracingCondition.Trigger();
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+yaget::metrics::TraceCollector::ThreadBuffer& yaget::metrics::TraceCollector::GetThreadBuffer()
+{
+    // keeps buffer alive until thread exits and marks it as free for other threads to use
+    struct BufferHandle
+    {
+        ~BufferHandle()
         {
-            std::unique_lock<std::mutex> mutexLock(mmProfileStampMutex);
-            mProfileStamps.emplace_back(std::move(result));
-            num = mProfileStamps.size();
+            if (mBuffer)
+            {
+                mBuffer->mRetired.store(true, std::memory_order_release);
+            }
         }
 
-        const int capacityChecker = 5000;
-        if (num % capacityChecker == 0)
+        const TraceCollector* mCollector = nullptr;
+        std::shared_ptr<ThreadBuffer> mBuffer;
+    };
+
+    thread_local BufferHandle tBufferHandle;
+    if (tBufferHandle.mCollector != this)
+    {
+        tBufferHandle.mBuffer = AcquireThreadBuffer();
+        tBufferHandle.mCollector = this;
+    }
+
+    return *tBufferHandle.mBuffer;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+std::shared_ptr<yaget::metrics::TraceCollector::ThreadBuffer> yaget::metrics::TraceCollector::AcquireThreadBuffer()
+{
+    std::unique_lock<std::mutex> mutexLock(mThreadBuffersMutex);
+
+    // reuse buffer from exited thread, after DataSaver saved all of it's records
+    for (const auto& threadBuffer : mThreadBuffers)
+    {
+        if (threadBuffer->mRetired.load(std::memory_order_acquire) && threadBuffer->mRecords.Empty())
         {
-            const std::string bytes = yaget::conv::ToThousandsSep(num * sizeof(ProfileStamps::value_type));
-            YLOG_DEBUG("METR", "Accumulated profile results: '%d' results using '%s' bytes of memory.", num, bytes.c_str());
+            threadBuffer->mRetired = false;
+            return threadBuffer;
         }
     }
+
+    mThreadBuffers.push_back(std::make_shared<ThreadBuffer>());
+    return mThreadBuffers.back();
 }
 
 
@@ -187,10 +178,13 @@ void yaget::metrics::TraceCollector::DataSaver()
     {
         mTracingCondition.Wait(200);
 
+        // gauges get sampled at least at saver rate
+        SampleGauges();
         SaveCurrentProfileStamps();
     }
     while (!mQuit);
 
+    SampleGauges();
     SaveCurrentProfileStamps();
 }
 
@@ -198,27 +192,148 @@ void yaget::metrics::TraceCollector::DataSaver()
 //-------------------------------------------------------------------------------------------------
 void yaget::metrics::TraceCollector::SaveCurrentProfileStamps()
 {
-    static size_t counter = 0;
-    ProfileStamps profileStamps;
+    ThreadBuffers threadBuffers;
+    {
+        std::unique_lock<std::mutex> mutexLock(mThreadBuffersMutex);
+        threadBuffers = mThreadBuffers;
+    }
+
+    if (mBinaryWriter)
+    {
+        SaveBinaryRecords(threadBuffers);
+        return;
+    }
+
+    const auto startTime = platform::GetRealTime(yaget::time::kMicrosecondUnit);
+    for (const auto& threadBuffer : threadBuffers)
     {
-        std::unique_lock<std::mutex> mutexLock(mmProfileStampMutex);
-        std::swap(profileStamps, mProfileStamps);
+        threadBuffer->mRecords.PopAll([this](const TraceRecord& record)
+        {
+            trace::WriteJsonRecord(mOutputStream, record, GetRecordName(record), GetName(record.mCategory));
+        });
 
-        counter += profileStamps.size();;
+        CheckDroppedRecords(*threadBuffer);
     }
 
-    //if (counter > 200)
-    //{
-    //    return;
-    //}
+    WriteNewThreadNames();
+
+    const auto endTime = platform::GetRealTime(yaget::time::kMicrosecondUnit);
+    TraceRecord traceRecord{ mFileWriteName, {}, startTime, endTime, platform::CurrentThreadId(), TraceRecord::Event::Complete, 0, mFileWriteCategory };
+    trace::WriteJsonRecord(mOutputStream, traceRecord, GetRecordName(traceRecord), GetName(traceRecord.mCategory));
+}
 
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::TraceCollector::SaveBinaryRecords(const ThreadBuffers& threadBuffers)
+{
     const auto startTime = platform::GetRealTime(yaget::time::kMicrosecondUnit);
-    for (const auto& profileStamp : profileStamps)
+    for (const auto& threadBuffer : threadBuffers)
     {
-        SaveTraceRecord(profileStamp, mOutputStream);
+        threadBuffer->mRecords.PopAll([this](const TraceRecord& record)
+        {
+            if (record.mNameId != TraceNameId::Invalid)
+            {
+                mBinaryWriter->AddRecord(record);
+            }
+            else
+            {
+                // inline names are interned here, so file stores each one once
+                TraceRecord internedRecord = record;
+                internedRecord.mNameId = InternName(ToStringView(record.mName));
+                mBinaryWriter->AddRecord(internedRecord);
+            }
+        });
+
+        CheckDroppedRecords(*threadBuffer);
     }
 
+    WriteNewNames();
+    WriteNewThreadNames();
+    mBinaryWriter->Flush();
+
+    // time it took to encode and write records is saved with next flush
     const auto endTime = platform::GetRealTime(yaget::time::kMicrosecondUnit);
-    TraceRecord traceRecord{ "TraceFileWrite", startTime, endTime, platform::CurrentThreadId(), TraceRecord::Event::Complete, 0, "FileWrite" };
-    SaveTraceRecord(traceRecord, mOutputStream);
+    mBinaryWriter->AddRecord({ mFileWriteName, {}, startTime, endTime, platform::CurrentThreadId(), TraceRecord::Event::Complete, 0, mFileWriteCategory });
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::TraceCollector::CheckDroppedRecords(ThreadBuffer& threadBuffer)
+{
+    if (const std::size_t numDropped = threadBuffer.mNumDropped.exchange(0, std::memory_order_relaxed))
+    {
+        mNumDroppedRecords += numDropped;
+        YLOG_WARNING("METR", "Dropped '%d' profile records, thread buffer with '%d' entries was full.", numDropped, BufferCapacity);
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::TraceCollector::WriteNewNames()
+{
+    std::unique_lock<std::mutex> mutexLock(mNamesMutex);
+
+    for (; mNumWrittenNames < mNames.size(); ++mNumWrittenNames)
+    {
+        mBinaryWriter->AddName(static_cast<TraceNameId>(mNumWrittenNames + 1), mNames[mNumWrittenNames]);
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::TraceCollector::WriteNewThreadNames()
+{
+    for (const auto& [id, name] : platform::GetThreadNames())
+    {
+        const auto [it, inserted] = mThreadNames.try_emplace(id, name);
+        if (!inserted && it->second == name)
+        {
+            continue;
+        }
+
+        it->second = name;
+        if (mBinaryWriter)
+        {
+            mBinaryWriter->AddThreadName(id, name);
+        }
+        else
+        {
+            trace::WriteJsonThreadName(mOutputStream, id, name);
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+yaget::metrics::TraceNameId yaget::metrics::TraceCollector::InternName(std::string_view name)
+{
+    std::unique_lock<std::mutex> mutexLock(mNamesMutex);
+
+    if (const auto it = mNameIds.find(name); it != mNameIds.end())
+    {
+        return it->second;
+    }
+
+    const std::string& storedName = mNames.emplace_back(name);
+    const auto nameId = static_cast<TraceNameId>(mNames.size());
+    mNameIds.emplace(storedName, nameId);
+
+    return nameId;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+std::string_view yaget::metrics::TraceCollector::GetName(TraceNameId nameId) const
+{
+    const auto index = static_cast<std::size_t>(nameId);
+
+    std::unique_lock<std::mutex> mutexLock(mNamesMutex);
+    return index && index <= mNames.size() ? std::string_view(mNames[index - 1]) : std::string_view();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+std::string_view yaget::metrics::TraceCollector::GetRecordName(const TraceRecord& record) const
+{
+    return record.mNameId != TraceNameId::Invalid ? GetName(record.mNameId) : ToStringView(record.mName);
 }
@@ -0,0 +1,558 @@
+#include "Metrics/TraceFormat.h"
+#include "Metrics/PerformanceTracer.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+
+namespace
+{
+    using Event = yaget::metrics::TraceRecord::Event;
+
+    //enum class Event { Begin, End, Complete, Instant, AsyncBegin, AsyncEnd, AsyncPoint, Lock, FlowBegin, FlowEnd, FlowPoint, Counter };
+    const char* PH[]
+    {
+        "B",    // Begin
+        "E",    // End
+        "X",    // Complete
+        "I",    // Instant
+        "b",    // AsyncBegin
+        "e",    // AsyncEnd
+        "n",    // AsyncPoint
+        "X",    // Lock
+        "s",    // FlowBegin
+        "f",    // FlowEnd
+        "t",    // FlowPoint
+        "C"     // Counter
+    };
+    constexpr std::size_t NumEvents = std::size(PH);
+
+    //enum class MessageScope { Global, Process, Thread };
+    const char* S[]
+    {
+        "g",    // Global
+        "p",    // Process
+        "t"     // Thread
+    };
+    constexpr std::size_t NumScopes = std::size(S);
+
+    bool HasDuration(Event event)
+    {
+        return event == Event::Complete || event == Event::Lock;
+    }
+
+    bool HasId(Event event)
+    {
+        return event != Event::Complete && event != Event::Lock && event != Event::Instant && event != Event::Counter;
+    }
+
+    bool HasValue(Event event)
+    {
+        return event == Event::Counter;
+    }
+
+    // names can have file paths in them
+    void WriteJsonString(std::ostream& output, std::string_view text)
+    {
+        output << '"';
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                output << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                output << ' ';
+            }
+            else
+            {
+                output << c;
+            }
+        }
+        output << '"';
+    }
+
+    void WriteString(std::string& buffer, std::string_view text)
+    {
+        yaget::metrics::trace::WriteVarint(buffer, text.size());
+        buffer.append(text);
+    }
+
+    bool ReadString(std::string_view& data, std::string& text)
+    {
+        uint64_t size = 0;
+        if (!yaget::metrics::trace::ReadVarint(data, size) || size > data.size())
+        {
+            return false;
+        }
+
+        text.assign(data.substr(0, size));
+        data.remove_prefix(size);
+        return true;
+    }
+
+    // varint directly from stream, used for header and block sizes
+    bool ReadStreamVarint(std::istream& input, uint64_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            const auto byte = input.get();
+            if (byte == std::istream::traits_type::eof())
+            {
+                return false;
+            }
+
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool ReadStreamString(std::istream& input, std::string& text)
+    {
+        uint64_t size = 0;
+        if (!ReadStreamVarint(input, size) || size > 0xFFFF)
+        {
+            return false;
+        }
+
+        text.resize(size);
+        return static_cast<bool>(input.read(text.data(), size));
+    }
+
+    // decodes binary blocks into json output
+    class JsonConverter
+    {
+    public:
+        JsonConverter(std::ostream& output)
+            : mOutput(output)
+        {}
+
+        bool ReadBlock(yaget::metrics::trace::Block block, std::string_view data)
+        {
+            using yaget::metrics::trace::Block;
+
+            switch (block)
+            {
+            case Block::Names:
+                return ReadNames(data);
+            case Block::Events:
+                return ReadEvents(data);
+            case Block::ThreadNames:
+                return ReadThreadNames(data);
+            }
+
+            // unknown block from newer version, skip it
+            return true;
+        }
+
+    private:
+        bool ReadNames(std::string_view data)
+        {
+            uint64_t numNames = 0;
+            if (!yaget::metrics::trace::ReadVarint(data, numNames))
+            {
+                return false;
+            }
+
+            for (uint64_t i = 0; i < numNames; ++i)
+            {
+                uint64_t nameId = 0;
+                std::string name;
+                if (!yaget::metrics::trace::ReadVarint(data, nameId) || !ReadString(data, name))
+                {
+                    return false;
+                }
+
+                mNames[nameId] = std::move(name);
+            }
+
+            return true;
+        }
+
+        bool ReadEvents(std::string_view data)
+        {
+            using namespace yaget::metrics;
+
+            uint64_t threadId = 0;
+            uint64_t numEvents = 0;
+            if (!trace::ReadVarint(data, threadId) || !trace::ReadVarint(data, numEvents))
+            {
+                return false;
+            }
+
+            yaget::time::TimeUnits_t& lastStart = mLastStarts[threadId];
+            for (uint64_t i = 0; i < numEvents; ++i)
+            {
+                if (data.empty())
+                {
+                    return false;
+                }
+
+                const auto header = static_cast<uint8_t>(data.front());
+                data.remove_prefix(1);
+                const std::size_t event = header & 0x0F;
+                const std::size_t scope = header >> 4;
+                if (event >= NumEvents || scope >= NumScopes)
+                {
+                    return false;
+                }
+
+                TraceRecord record;
+                record.mThreadID = threadId;
+                record.mEvent = static_cast<Event>(event);
+                record.mMessageScope = static_cast<MessageScope>(scope);
+
+                uint64_t nameId = 0, category = 0, startDelta = 0;
+                if (!trace::ReadVarint(data, nameId) || !trace::ReadVarint(data, category) || !trace::ReadVarint(data, startDelta))
+                {
+                    return false;
+                }
+
+                lastStart += trace::UnZigZag(startDelta);
+                record.mStart = lastStart;
+                record.mEnd = lastStart;
+
+                uint64_t value = 0;
+                if (HasDuration(record.mEvent) || HasId(record.mEvent) || HasValue(record.mEvent))
+                {
+                    if (!trace::ReadVarint(data, value))
+                    {
+                        return false;
+                    }
+
+                    if (HasDuration(record.mEvent))
+                    {
+                        record.mEnd = record.mStart + trace::UnZigZag(value);
+                    }
+                    else if (HasValue(record.mEvent))
+                    {
+                        record.mValue = trace::UnZigZag(value);
+                    }
+                    else
+                    {
+                        record.mId = value;
+                    }
+                }
+
+                trace::WriteJsonRecord(mOutput, record, GetName(nameId), GetName(category));
+            }
+
+            return true;
+        }
+
+        bool ReadThreadNames(std::string_view data)
+        {
+            uint64_t numThreads = 0;
+            if (!yaget::metrics::trace::ReadVarint(data, numThreads))
+            {
+                return false;
+            }
+
+            for (uint64_t i = 0; i < numThreads; ++i)
+            {
+                uint64_t threadId = 0;
+                std::string name;
+                if (!yaget::metrics::trace::ReadVarint(data, threadId) || !ReadString(data, name))
+                {
+                    return false;
+                }
+
+                yaget::metrics::trace::WriteJsonThreadName(mOutput, threadId, name);
+            }
+
+            return true;
+        }
+
+        std::string_view GetName(uint64_t nameId) const
+        {
+            const auto it = mNames.find(nameId);
+            return it != mNames.end() ? std::string_view(it->second) : std::string_view();
+        }
+
+        std::ostream& mOutput;
+        std::unordered_map<uint64_t, std::string> mNames;
+        std::unordered_map<uint64_t, yaget::time::TimeUnits_t> mLastStarts;
+    };
+
+}
+
+
+//-------------------------------------------------------------------------------------------------
+yaget::metrics::trace::BinaryWriter::BinaryWriter(std::ostream& output, std::string_view appName, std::string_view date)
+    : mOutput(output)
+{
+    mPending.append(std::begin(kMagic), std::end(kMagic));
+    mPending.push_back(static_cast<char>(kVersion));
+    WriteString(mPending, appName);
+    WriteString(mPending, date);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::BinaryWriter::AddName(TraceNameId nameId, std::string_view name)
+{
+    WriteVarint(mNames, static_cast<uint64_t>(nameId));
+    WriteString(mNames, name);
+    ++mNumNames;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::BinaryWriter::AddRecord(const TraceRecord& record)
+{
+    YAGET_ASSERT(record.mNameId != TraceNameId::Invalid, "Binary trace record requires interned name.");
+
+    ThreadStream& threadStream = mThreadStreams[record.mThreadID];
+    std::string& events = threadStream.mEvents;
+
+    events.push_back(static_cast<char>(static_cast<uint8_t>(record.mEvent) | static_cast<uint8_t>(record.mMessageScope) << 4));
+    WriteVarint(events, static_cast<uint64_t>(record.mNameId));
+    WriteVarint(events, static_cast<uint64_t>(record.mCategory));
+    WriteVarint(events, ZigZag(record.mStart - threadStream.mLastStart));
+    threadStream.mLastStart = record.mStart;
+
+    if (HasDuration(record.mEvent))
+    {
+        WriteVarint(events, ZigZag(record.mEnd - record.mStart));
+    }
+    else if (HasValue(record.mEvent))
+    {
+        WriteVarint(events, ZigZag(record.mValue));
+    }
+    else if (HasId(record.mEvent))
+    {
+        WriteVarint(events, record.mId);
+    }
+
+    ++threadStream.mNumEvents;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::BinaryWriter::AddThreadName(std::size_t threadId, std::string_view name)
+{
+    WriteVarint(mThreadNames, threadId);
+    WriteString(mThreadNames, name);
+    ++mNumThreadNames;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::BinaryWriter::Flush()
+{
+    std::string payload;
+
+    // names first, so reader knows them before events
+    if (mNumNames)
+    {
+        WriteVarint(payload, mNumNames);
+        payload.append(mNames);
+        AddBlock(Block::Names, payload);
+
+        mNames.clear();
+        mNumNames = 0;
+    }
+
+    for (auto& [threadId, threadStream] : mThreadStreams)
+    {
+        if (threadStream.mNumEvents)
+        {
+            payload.clear();
+            WriteVarint(payload, threadId);
+            WriteVarint(payload, threadStream.mNumEvents);
+            payload.append(threadStream.mEvents);
+            AddBlock(Block::Events, payload);
+
+            // keep capacity and last start, next block deltas continue from it
+            threadStream.mEvents.clear();
+            threadStream.mNumEvents = 0;
+        }
+    }
+
+    if (mNumThreadNames)
+    {
+        payload.clear();
+        WriteVarint(payload, mNumThreadNames);
+        payload.append(mThreadNames);
+        AddBlock(Block::ThreadNames, payload);
+
+        mThreadNames.clear();
+        mNumThreadNames = 0;
+    }
+
+    if (!mPending.empty())
+    {
+        mOutput.write(mPending.data(), mPending.size());
+        mOutput.flush();
+        mNumBytesWritten += mPending.size();
+        mPending.clear();
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::BinaryWriter::AddBlock(Block block, const std::string& payload)
+{
+    YAGET_ASSERT(payload.size() <= kMaxBlockSize, "Trace block of '%d' bytes is bigger then max block size '%d'.", payload.size(), kMaxBlockSize);
+
+    mPending.push_back(static_cast<char>(block));
+    WriteVarint(mPending, payload.size());
+    mPending.append(payload);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::WriteJsonHeader(std::ostream& output, std::string_view appName, std::string_view date)
+{
+    output << "{\"otherData\": {";
+    output << "\"Application\": ";
+    WriteJsonString(output, appName);
+    output << ",\"Date\": ";
+    WriteJsonString(output, date);
+    output << "},";
+
+    output << "\"traceEvents\":[{}";
+    output.flush();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::WriteJsonRecord(std::ostream& output, const TraceRecord& record, std::string_view name, std::string_view category)
+{
+    output << ",{";
+    output << "\"name\":";
+    WriteJsonString(output, name);
+    output << ",\"pid\":0,";
+    output << "\"tid\":" << record.mThreadID << ",";
+    output << "\"ph\":\"" << PH[static_cast<int>(record.mEvent)] << "\",";
+    output << "\"cat\":";
+    WriteJsonString(output, category);
+    output << ",\"ts\":" << record.mStart;
+
+    if (HasDuration(record.mEvent))
+    {
+        output << ",\"dur\":" << record.mEnd - record.mStart;
+    }
+    else if (HasValue(record.mEvent))
+    {
+        output << ",\"args\":{\"value\":" << record.mValue << "}";
+    }
+    else if (HasId(record.mEvent))
+    {
+        output << ",\"id\":" << record.mId;
+    }
+    else
+    {
+        output << ",\"s\":\"" << S[static_cast<int>(record.mMessageScope)] << "\"";
+    }
+
+    output << "}";
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::WriteJsonThreadName(std::ostream& output, std::size_t threadId, std::string_view name)
+{
+    output << ",{";
+    output << "\"name\":\"thread_name\",";
+    output << "\"ph\":\"M\",";
+    output << "\"pid\":0,";
+    output << "\"tid\":" << threadId << ",";
+    output << "\"args\":{\"name\":";
+    WriteJsonString(output, name);
+    output << "}}";
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::metrics::trace::WriteJsonFooter(std::ostream& output)
+{
+    output << "]}";
+    output.flush();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+yaget::metrics::trace::ConvertResult yaget::metrics::trace::ConvertToJson(std::istream& input, std::ostream& output)
+{
+    char magic[std::size(kMagic)] = {};
+    if (!input.read(magic, std::size(magic)) || !std::equal(std::begin(magic), std::end(magic), std::begin(kMagic)))
+    {
+        return { false, "Input is not a binary trace file." };
+    }
+
+    const auto version = input.get();
+    if (version != kVersion)
+    {
+        return { false, fmt::format("Binary trace version '{}' is not supported, expected '{}'.", version, kVersion) };
+    }
+
+    std::string appName, date;
+    if (!ReadStreamString(input, appName) || !ReadStreamString(input, date))
+    {
+        return { false, "Binary trace header is truncated." };
+    }
+
+    // size of each block is checked against what is left in input before it's read,
+    // input which can not be sized (pipe) is only checked against kMaxBlockSize
+    const std::istream::pos_type blocksStart = input.tellg();
+    std::istream::pos_type inputEnd = -1;
+    if (blocksStart != std::istream::pos_type(-1) && input.seekg(0, std::ios::end))
+    {
+        inputEnd = input.tellg();
+        input.seekg(blocksStart);
+    }
+
+    WriteJsonHeader(output, appName, date);
+
+    JsonConverter converter(output);
+    ConvertResult result{ true, "" };
+    std::string payload;
+    std::size_t blockIndex = 0;
+    for (int blockType = input.get(); blockType != std::istream::traits_type::eof(); blockType = input.get(), ++blockIndex)
+    {
+        uint64_t size = 0;
+        if (!ReadStreamVarint(input, size))
+        {
+            result = { false, fmt::format("Block '{}' is truncated.", blockIndex) };
+            break;
+        }
+
+        if (size > kMaxBlockSize)
+        {
+            result = { false, fmt::format("Block '{}' size '{}' is bigger then max block size '{}'.", blockIndex, size, kMaxBlockSize) };
+            break;
+        }
+
+        const bool pastInputEnd = inputEnd != std::istream::pos_type(-1) && size > static_cast<uint64_t>(inputEnd - input.tellg());
+        if (pastInputEnd)
+        {
+            result = { false, fmt::format("Block '{}' is truncated, expected '{}' bytes.", blockIndex, size) };
+            break;
+        }
+
+        payload.resize(size);
+        if (!input.read(payload.data(), size))
+        {
+            // capture was cut short (crash or kill), keep everything before last block
+            result = { false, fmt::format("Block '{}' is truncated, expected '{}' bytes.", blockIndex, size) };
+            break;
+        }
+
+        if (!converter.ReadBlock(static_cast<Block>(blockType), payload))
+        {
+            result = { false, fmt::format("Block '{}' of type '{}' is corrupted.", blockIndex, blockType) };
+            break;
+        }
+    }
+
+    WriteJsonFooter(output);
+    return result;
+}
@@ -39,12 +39,12 @@ yaget::io::Watcher::~Watcher()
     {
         // there may be outstanding requests to remove watched file (engine shutdown may bunch up closing all threads closely together)
         //
-        auto message = fmt::format("Cleaning '{}' left over file watches", GetWatchedFiles().size());
+        auto message = fmt::format("Cleaning '{}' left over file watches", mWatchedFiles.Get()->size());
         metrics::TimeScoper<time::kMilisecondUnit> cleanupTimer(message.c_str());
         auto endTime = platform::GetRealTime(time::kMilisecondUnit) + DefaultCleanupWait;
         platform::Sleep([this, endTime]()
         {
-            if (GetWatchedFiles().empty() || endTime < platform::GetRealTime(time::kMilisecondUnit))
+            if (mWatchedFiles.Get()->empty() || endTime < platform::GetRealTime(time::kMilisecondUnit))
             {
                 return false;
             }
@@ -58,7 +58,7 @@ yaget::io::Watcher::~Watcher()
     // we should have not mTickets here. If we do, then race condition, between waiting
     // for cleanup and quit set to true. We should generate error for this.
     YLOG_CERROR("WATC", GetWatchedFiles().empty(), "There are still '%d' files left in Watched List. [%s].", GetWatchedFiles().size(), conv::Combine(GetWatchedFiles(), "], [").c_str());
-    YLOG_CERROR("WATC", static_cast<Tickets>(mTickets).empty(), "There are '%d' outstanding new tickets.", static_cast<Tickets>(mTickets).size());
+    YLOG_CERROR("WATC", mTickets.Get()->empty(), "There are '%d' outstanding new tickets.", mTickets.Get()->size());
 }
 
 
@@ -78,9 +78,11 @@ void yaget::io::Watcher::Observe()
             break;
         }
 
-        // processed first any new incoming ticket requests
-        if (Tickets peekTickets = mTickets.Swap({}); !peekTickets.empty())
+        // processed first any new incoming ticket requests,
+        // peek at snapshot first so idle polling does not take write lock
+        if (!mTickets.Get()->empty())
         {
+            Tickets peekTickets = *mTickets.Exchange({});
             for (auto& it : peekTickets)
             {
                 // if we already have this file to watch we simply replace it with incoming one (only callback)
@@ -169,7 +171,7 @@ void yaget::io::Watcher::Observe()
             }
 
             std::sort(watchedFiles.begin(), watchedFiles.end());
-            mWatchedFiles = watchedFiles;
+            mWatchedFiles = std::move(watchedFiles);
         }
 
         time::Milisecond_t endFrameTime = platform::GetRealTime(time::kMilisecondUnit);
@@ -182,7 +184,7 @@ void yaget::io::Watcher::Observe()
 
 yaget::Strings yaget::io::Watcher::GetWatchedFiles() const
 {
-    return mWatchedFiles;
+    return mWatchedFiles.GetValue();
 }
 
 void yaget::io::Watcher::Add(uint64_t ownerId, const std::string& fileName, ChangedCallback changedCallback)
@@ -192,10 +194,10 @@ void yaget::io::Watcher::Add(uint64_t ownerId, const std::string& fileName, Chan
         return;
     }
 
-    Tickets newTickets = mTickets;
-    newTickets.emplace_back(Ticket{ fileName, changedCallback, ownerId });
-
-    mTickets = newTickets;
+    mTickets.Update([&](Tickets& tickets)
+    {
+        tickets.emplace_back(Ticket{ fileName, changedCallback, ownerId });
+    });
 }
 
 void yaget::io::Watcher::Remove(uint64_t ownerId)
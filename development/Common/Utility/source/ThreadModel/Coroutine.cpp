@@ -0,0 +1,80 @@
+#include "ThreadModel/Coroutine.h"
+#include "Logger/YLog.h"
+#include <vector>
+
+
+void yaget::mt::internal::LogDetachedCoroutineException(std::exception_ptr exception)
+{
+    try
+    {
+        std::rethrow_exception(exception);
+    }
+    catch (const std::exception& e)
+    {
+        YLOG_ERROR("MULT", "Coroutine failed with exception: '%s'.", e.what());
+    }
+    catch (...)
+    {
+        YLOG_ERROR("MULT", "Coroutine failed with unknown exception.");
+    }
+}
+
+
+yaget::mt::GameTimer::~GameTimer()
+{
+    std::lock_guard<std::mutex> locker(mMutex);
+    if (!mWaiters.empty())
+    {
+        YLOG_WARNING("MULT", "GameTimer destroyed with '%d' coroutines still waiting, they will not be resumed.", mWaiters.size());
+    }
+}
+
+
+void yaget::mt::GameTimer::Tick(time::Microsecond_t logicTime)
+{
+    std::vector<std::coroutine_handle<>> readyWaiters;
+    {
+        std::lock_guard<std::mutex> locker(mMutex);
+        mLogicTime = logicTime;
+
+        const auto end = mWaiters.upper_bound(logicTime);
+        for (auto it = mWaiters.begin(); it != end; ++it)
+        {
+            readyWaiters.push_back(it->second);
+        }
+        mWaiters.erase(mWaiters.begin(), end);
+    }
+
+    // resumed coroutine may wait on this timer again
+    for (auto handle : readyWaiters)
+    {
+        handle.resume();
+    }
+}
+
+
+yaget::time::Microsecond_t yaget::mt::GameTimer::LogicTime() const
+{
+    std::lock_guard<std::mutex> locker(mMutex);
+    return mLogicTime;
+}
+
+
+std::size_t yaget::mt::GameTimer::NumWaiting() const
+{
+    std::lock_guard<std::mutex> locker(mMutex);
+    return mWaiters.size();
+}
+
+
+bool yaget::mt::GameTimer::AddWaiter(time::Microsecond_t logicTime, std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> locker(mMutex);
+    if (logicTime <= mLogicTime)
+    {
+        return false;
+    }
+
+    mWaiters.emplace(logicTime, handle);
+    return true;
+}
@@ -1,4 +1,6 @@
 #include "ThreadModel/JobPool.h"
+#include "ThreadModel/WorkStealingQueue.h"
+#include "MemoryManager/ConcurrentPoolAllocator.h"
 #include "Debugging/DevConfiguration.h"
 #include "Logger/YLog.h"
 #include "Platform/Support.h"
@@ -43,6 +45,9 @@ namespace
         return nameIndexer;
     }
 
+    // config names pools are created with, see ConfiguredThreadOptions callers
+    constexpr const char* ConfiguredPoolNames[] = { "App", "Blob", "VTS", "Systems", "FileLoader" };
+
     void StopThreads(yaget::mt::JobPool::Threads_t& threads)
     {
         for (auto&& it : threads)
@@ -51,6 +56,24 @@ namespace
         }
     }
 
+    // set for worker threads, so tasks added from a worker go to it's own queue
+    struct CurrentWorker
+    {
+        const yaget::mt::JobPool* mPool = nullptr;
+        std::size_t mIndex = 0;
+    };
+
+    thread_local CurrentWorker tCurrentWorker;
+
+    // taken tasks at the front of injection queue before it's compacted
+    const std::size_t MinTasksToCompact = 1024;
+
+    const char* PriorityName(std::size_t priority)
+    {
+        const char* names[] = { "High", "Normal", "Low" };
+        return names[priority];
+    }
+
     uint32_t CalculateMaxNumThreads(uint32_t numThreads)
     {
         uint32_t maxThreads = numThreads;
@@ -71,36 +94,88 @@ std::string yaget::mt::GenerateNextName(const std::string& name)
 }
 
 
+struct yaget::mt::JobPool::Worker
+{
+    // written only by owning worker thread, read by GetQueueLatency
+    struct Latency
+    {
+        std::atomic<std::size_t> mNumTasks{ 0 };
+        std::atomic<time::Raw_t> mTotal{ 0 };
+        std::atomic<time::Raw_t> mMax{ 0 };
+    };
+
+    void RecordLatency(std::size_t priority, time::Raw_t latency)
+    {
+        Latency& counter = mLatency[priority];
+        counter.mNumTasks.store(counter.mNumTasks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        counter.mTotal.store(counter.mTotal.load(std::memory_order_relaxed) + latency, std::memory_order_relaxed);
+        if (latency > counter.mMax.load(std::memory_order_relaxed))
+        {
+            counter.mMax.store(latency, std::memory_order_relaxed);
+        }
+    }
+
+    // tasks added by this worker, stolen by others, one queue per priority
+    std::array<WorkStealingQueue<QueuedTask*>, NumPriorities> mTasks;
+    // memory for tasks in mTasks, allocated by owner and freed by whoever runs it
+    memory::ConcurrentPoolAllocator<QueuedTask, 256> mTaskAllocator;
+    std::array<Latency, NumPriorities> mLatency;
+    // worker did not find any task and is (about to be) waiting on it's processor
+    std::atomic_bool mParked{ false };
+    // previous task returned from PopNextTask is finished when this worker asks for next one.
+    // Written only by owning worker thread, read by GetNumBusyWorkers
+    std::atomic_bool mRunningTask{ false };
+    JobProcessor::Holder* mHolder = nullptr;
+};
+
+
 yaget::mt::JobPool::JobPool(const char* poolName, uint32_t numThreads /*= 0*/, Behaviour behaviour /*= Behaviour::StartAsRun*/) 
+    : JobPool(poolName, numThreads, behaviour, ThreadOptions{})
+{
+}
+
+
+yaget::mt::JobPool::JobPool(const char* poolName, uint32_t numThreads, Behaviour behaviour, const ThreadOptions& threadOptions)
     : mName(GenerateNextName(poolName))
     , mBehaviour(behaviour)
     , mDynamicThreads(true)
     , mMaxNumThreads(CalculateMaxNumThreads(numThreads))
-{
-    mEmptyCondition.Trigger();
+    , mThreadOptions(threadOptions)
+    // all workers exist before gauges, which read them from sampling thread
+    , mWorkers([this]()
+    {
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (uint32_t i = 0; i < mMaxNumThreads; ++i)
+        {
+            workers.emplace_back(std::make_unique<Worker>());
+        }
 
+        return workers;
+    }())
+    , mQueuedTasksGauge(metrics::MakeTraceName("JobPool.", mName + ".Queued"), [this]()
+    {
+        const std::size_t numOutstanding = mNumOutstandingTasks.load(std::memory_order_relaxed);
+        return static_cast<int64_t>(numOutstanding - std::min(numOutstanding, GetNumBusyWorkers()));
+    })
+    , mBusyThreadsGauge(metrics::MakeTraceName("JobPool.", mName + ".Busy"), [this]() { return static_cast<int64_t>(GetNumBusyWorkers()); })
+{
     YLOG_DEBUG("POOL", "Creating JobPool '%s' with '%d' threads.", mName.c_str(), mMaxNumThreads);
 
     const auto numThreadsToCreate = mDynamicThreads ? 0 : mMaxNumThreads;
     for (uint32_t i = 0; i < numThreadsToCreate; ++i)
     { 
-        std::string threadName = mMaxNumThreads > 1 ? fmt::format("{}_{}/{}", mName, i + 1, mMaxNumThreads) : mName;
-        mThreads.insert(std::make_pair(threadName, JobProcessor::Holder(threadName, [this]() { return PopNextTask(); }))); 
+        AddWorker();
     } 
 } 
 
 
 void yaget::mt::JobPool::Clear() 
 {
+    mt::unique_lock mutexLock = mDynamicThreads ? mt::unique_lock(mThreadListMutext) : mt::unique_lock{};
+    for (auto&& it : mThreads)
     {
-        mt::unique_lock mutexLock = mDynamicThreads ? mt::unique_lock(mThreadListMutext) : mt::unique_lock{};
-        for (auto&& it : mThreads)
-        {
-            it.second.Clear();
-        }
+        it.second.Clear();
     }
-
-    mEmptyCondition.Trigger();
 }
 
 
@@ -108,21 +183,64 @@ void yaget::mt::JobPool::Destroy()
 {
     {
         std::unique_lock<std::mutex> mutexLock(mPendingTasksMutex);
-        if (!mTasks.empty())
+        for (std::size_t priority = 0; priority < NumPriorities; ++priority)
         {
-            YLOG_DEBUG("POOL", "Deleting threads for JobPool '%s'.%s", mName.c_str(), (mTasks.empty() ? "" : fmt::format(" There are '{}' unfinished tasks in queue.", mTasks.size()).c_str()));
-            mTasks.clear();
+            if (mInjectedTasks[priority].Size())
+            {
+                YLOG_DEBUG("POOL", "Deleting threads for JobPool '%s'. There are '%d' unfinished %s priority tasks in queue.", mName.c_str(), mInjectedTasks[priority].Size(), PriorityName(priority));
+            }
+
+            mInjectedTasks[priority].Clear();
+            mNumPendingTasks[priority] = 0;
         }
     }
 
     Clear();
 
-    mt::unique_lock mutexLock = mDynamicThreads ? mt::unique_lock(mThreadListMutext) : mt::unique_lock{};
-    if (!mThreads.empty())
+    // running tasks may still add new ones and try to wake or create workers,
+    // so threads are deleted outside of the lock
+    Threads_t threads;
+    {
+        mt::unique_lock mutexLock = mt::unique_lock(mThreadListMutext);
+        mStopping = true;
+        threads.swap(mThreads);
+    }
+
+    if (!threads.empty())
     {
-        mThreads.clear();
+        threads.clear();
         YLOG_DEBUG("POOL", "Done deleting threads for JobPool '%s'.", mName.c_str());
     }
+
+    // all threads are stopped, drop tasks left in worker queues
+    mNumWorkers = 0;
+    for (auto& worker : mWorkers)
+    {
+        worker->mHolder = nullptr;
+        worker->mParked = false;
+        worker->mRunningTask = false;
+        for (auto& tasks : worker->mTasks)
+        {
+            while (QueuedTask* task = tasks.Pop())
+            {
+                worker->mTaskAllocator.Free(task);
+            }
+        }
+    }
+
+    for (std::size_t priority = 0; priority < NumPriorities; ++priority)
+    {
+        if (const QueueLatency latency = GetQueueLatency(static_cast<Priority>(priority)); latency.mNumTasks)
+        {
+            YLOG_DEBUG("POOL", "JobPool '%s' %s priority queue latency for '%d' tasks, average: '%d', max: '%d' microseconds.", mName.c_str(), PriorityName(priority), latency.mNumTasks, latency.Average(), latency.mMax);
+        }
+    }
+
+    mNumOutstandingTasks = 0;
+    mNumOutstandingTasks.notify_all();
+
+    mt::unique_lock mutexLock = mt::unique_lock(mThreadListMutext);
+    mStopping = false;
 }
 
 
@@ -132,50 +250,82 @@ yaget::mt::JobPool::~JobPool()
 }
 
 
-void yaget::mt::JobPool::UpdateThreadPool(size_t numTasksLeft)
+bool yaget::mt::JobPool::AddWorker()
 {
-    if (mDynamicThreads && numTasksLeft)
+    // all workers are created, do not touch the lock
+    if (mNumWorkers.load() >= mMaxNumThreads)
     {
-        mt::unique_lock mutexLock = mt::unique_lock(mThreadListMutext);
-        size_t threadListSize = mThreads.size();
+        return false;
+    }
 
-        // looks like we have tasks left, let check to see if we reached max number of threads
-        // and if not, are all busy?
-        while (numTasksLeft && threadListSize < mMaxNumThreads)
-        {
-            const bool allBusy = std::ranges::all_of(mThreads.begin(), mThreads.end(), [](auto itr)
-            {
-                return itr.second.IsBusy();
-            });
+    mt::unique_lock mutexLock = mt::unique_lock(mThreadListMutext);
+
+    const uint32_t workerIndex = mNumWorkers.load();
+    if (mStopping || workerIndex >= mMaxNumThreads)
+    {
+        return false;
+    }
+
+    std::string threadName = mMaxNumThreads > 1 ? fmt::format("{}_{}/{}", mName, workerIndex + 1, mMaxNumThreads) : mName;
+    auto it = mThreads.insert(std::make_pair(threadName, JobProcessor::Holder(threadName, [this, workerIndex]() { return PopNextTask(workerIndex); }))).first;
+    mWorkers[workerIndex]->mHolder = &it->second;
+    mNumWorkers.store(workerIndex + 1);
+
+    return true;
+}
+
+
+bool yaget::mt::JobPool::WakeWorker()
+{
+    if (mBehaviour == Behaviour::StartAsPause)
+    {
+        return false;
+    }
 
-            if (allBusy)
+    // pairs with fence in PopNextTask, either we see parked worker or it sees new task
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const uint32_t numWorkers = mNumWorkers.load();
+    for (uint32_t i = 0; i < numWorkers; ++i)
+    {
+        Worker& worker = *mWorkers[i];
+        if (worker.mParked.load(std::memory_order_relaxed) && worker.mParked.exchange(false))
+        {
+            // holder is only valid while pool is not being destroyed
+            mt::unique_lock mutexLock = mt::unique_lock(mThreadListMutext);
+            if (mStopping)
             {
-                // spawn another thread
-                std::string threadName = mMaxNumThreads > 1 ? fmt::format("{}_{}/{}", mName, threadListSize + 1, mMaxNumThreads) : mName;
-                mThreads.insert(std::make_pair(threadName, JobProcessor::Holder(threadName, [this]() { return PopNextTask(); })));
+                return false;
             }
 
-            threadListSize = mThreads.size();
-            --numTasksLeft;
+            worker.mHolder->StartProcessing();
+            return true;
         }
     }
+
+    // everyone is busy
+    return AddWorker();
 }
 
 
 size_t yaget::mt::JobPool::GetNumTasksLeft() const
 {
-    std::unique_lock<std::mutex> mutexLock(mPendingTasksMutex);
-    const size_t numTasksLeft = mTasks.size();
-    return numTasksLeft;
+    return mNumOutstandingTasks.load();
 }
 
 
 void yaget::mt::JobPool::AddTask(mt::JobProcessor::Task_t task, TaskExecutionThread taskExecutionThread/* = TaskExecutionThread::Default*/) 
 {
-    JobProcessor::Task_t selectedTask = task;
+    AddTask(std::move(task), Priority::Normal, taskExecutionThread);
+}
+
+
+void yaget::mt::JobPool::AddTask(JobProcessor::Task_t task, Priority priority, TaskExecutionThread taskExecutionThread/* = TaskExecutionThread::Default*/)
+{
+    JobProcessor::Task_t selectedTask = std::move(task);
     if (taskExecutionThread == TaskExecutionThread::Tasked)
     {
-        auto taskRedirector = [threadId = platform::CurrentThreadId(), task]()
+        auto taskRedirector = [threadId = platform::CurrentThreadId(), task = std::move(selectedTask)]()
         {
             task();
         };
@@ -183,26 +333,36 @@ void yaget::mt::JobPool::AddTask(mt::JobProcessor::Task_t task, TaskExecutionThr
         selectedTask = std::move(taskRedirector);
     }
 
-    size_t numTasksLeft = 0;
-    mEmptyCondition.Reset();
+    mNumOutstandingTasks.fetch_add(1);
+
+    const std::size_t queueIndex = static_cast<std::size_t>(priority);
+    QueuedTask queuedTask{ std::move(selectedTask), QueueTime() };
+
+    // single thread pools keep tasks in order they were added
+    if (tCurrentWorker.mPool == this && mMaxNumThreads > 1)
+    {
+        Worker& worker = *mWorkers[tCurrentWorker.mIndex];
+        worker.mTasks[queueIndex].Push(worker.mTaskAllocator.Allocate(std::move(queuedTask)));
+    }
+    else
     {
         std::unique_lock<std::mutex> mutexLock(mPendingTasksMutex);
-        mTasks.emplace_back(std::move(selectedTask));
-        numTasksLeft = mTasks.size();
+        mInjectedTasks[queueIndex].Push(std::move(queuedTask));
+        mNumPendingTasks[queueIndex].store(mInjectedTasks[queueIndex].Size());
     }
 
-    if (mBehaviour == Behaviour::StartAsRun) 
-    { 
-        UpdateThreadPool(numTasksLeft);
-        UnpauseAll();
-    } 
+    WakeWorker();
 } 
 
 
 void yaget::mt::JobPool::Join() 
 { 
-    mEmptyCondition.Wait(); 
-    mEmptyCondition.Trigger();
+    YAGET_ASSERT(tCurrentWorker.mPool != this, "JobPool '%s' Join called from it's own worker thread.", mName.c_str());
+
+    for (std::size_t numTasks = mNumOutstandingTasks.load(); numTasks; numTasks = mNumOutstandingTasks.load())
+    {
+        mNumOutstandingTasks.wait(numTasks);
+    }
 }
 
 
@@ -215,40 +375,276 @@ void yaget::mt::JobPool::JoinDestroy()
 
 void yaget::mt::JobPool::UnpauseAll() 
 {
-    if (mDynamicThreads && mBehaviour == Behaviour::StartAsPause)
+    mBehaviour = Behaviour::StartAsRun;
+
+    // one worker per task, up to all of them
+    const std::size_t numTasksLeft = std::max<std::size_t>(GetNumTasksLeft(), 1);
+    for (std::size_t i = 0; i < numTasksLeft; ++i)
     {
-        const size_t numTasksLeft = GetNumTasksLeft();
-        UpdateThreadPool(numTasksLeft);
+        if (!WakeWorker())
+        {
+            break;
+        }
     }
-
-    mEmptyCondition.Reset();
-    mBehaviour = Behaviour::StartAsRun;
- 
-    mt::unique_lock mutexLock = mDynamicThreads ? mt::unique_lock(mThreadListMutext) : mt::unique_lock{};
-    for (auto&& it : mThreads)
-    { 
-        it.second.StartProcessing(); 
-    } 
 } 
 
 
-yaget::mt::JobProcessor::Task_t yaget::mt::JobPool::PopNextTask()
+void yaget::mt::JobPool::OnTaskFinished()
+{
+    if (mNumOutstandingTasks.fetch_sub(1) == 1)
+    {
+        mNumOutstandingTasks.notify_all();
+    }
+}
+
+
+bool yaget::mt::JobPool::InjectedTasks::Pop(QueuedTask& task)
+{
+    if (!Size())
+    {
+        return false;
+    }
+
+    task = std::move(mTasks[mHead++]);
+    if (mHead == mTasks.size())
+    {
+        Clear();
+    }
+    else if (mHead >= MinTasksToCompact && mHead * 2 >= mTasks.size())
+    {
+        // queue never drained, drop taken slots so it does not keep growing
+        mTasks.erase(mTasks.begin(), mTasks.begin() + mHead);
+        mHead = 0;
+    }
+
+    return true;
+}
+
+
+yaget::time::Raw_t yaget::mt::JobPool::QueueTime()
 {
-    JobProcessor::Task_t task = {};
+    return platform::GetRealTime(time::kRawUnit);
+}
+
+
+bool yaget::mt::JobPool::PopLocalTask(std::size_t workerIndex, std::size_t priority, QueuedTask& task)
+{
+    Worker& worker = *mWorkers[workerIndex];
+    if (QueuedTask* localTask = worker.mTasks[priority].Pop())
+    {
+        task = std::move(*localTask);
+        worker.mTaskAllocator.Free(localTask);
+        return true;
+    }
+
+    return false;
+}
+
+
+bool yaget::mt::JobPool::PopInjectedTask(std::size_t priority, QueuedTask& task)
+{
+    if (mNumPendingTasks[priority].load(std::memory_order_relaxed))
     {
         std::unique_lock<std::mutex> mutexLock(mPendingTasksMutex);
-        if (!mTasks.empty())
+        if (mInjectedTasks[priority].Pop(task))
         {
-            task = *mTasks.begin();
-            mTasks.pop_front();
+            mNumPendingTasks[priority].store(mInjectedTasks[priority].Size());
+            return true;
         }
     }
 
-    if (task)
+    return false;
+}
+
+
+bool yaget::mt::JobPool::StealTask(std::size_t workerIndex, std::size_t priority, QueuedTask& task)
+{
+    // start with next worker, so thieves do not all go after the same one
+    const uint32_t numWorkers = mNumWorkers.load();
+    for (uint32_t i = 1; i < numWorkers; ++i)
     {
-        return task;
+        Worker& victim = *mWorkers[(workerIndex + i) % numWorkers];
+        if (QueuedTask* stolenTask = victim.mTasks[priority].Steal())
+        {
+            task = std::move(*stolenTask);
+            victim.mTaskAllocator.Free(stolenTask);
+            return true;
+        }
     }
- 
-    mEmptyCondition.Trigger(); 
-    return {}; 
-} 
+
+    return false;
+}
+
+
+bool yaget::mt::JobPool::HasTasks() const
+{
+    const uint32_t numWorkers = mNumWorkers.load();
+    for (std::size_t priority = 0; priority < NumPriorities; ++priority)
+    {
+        if (mNumPendingTasks[priority].load(std::memory_order_relaxed))
+        {
+            return true;
+        }
+
+        for (uint32_t i = 0; i < numWorkers; ++i)
+        {
+            if (!mWorkers[i]->mTasks[priority].IsEmpty())
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+yaget::mt::JobProcessor::Task_t yaget::mt::JobPool::PopNextTask(std::size_t workerIndex)
+{
+    if (tCurrentWorker.mPool != this)
+    {
+        tCurrentWorker = { this, workerIndex };
+        ApplyThreadOptions();
+    }
+
+    Worker& worker = *mWorkers[workerIndex];
+
+    if (worker.mRunningTask.load(std::memory_order_relaxed))
+    {
+        worker.mRunningTask.store(false, std::memory_order_relaxed);
+        OnTaskFinished();
+    }
+
+    while (true)
+    {
+        // all queues of higher priority are checked before lower one
+        QueuedTask task;
+        for (std::size_t priority = 0; priority < NumPriorities; ++priority)
+        {
+            if (PopLocalTask(workerIndex, priority, task) || PopInjectedTask(priority, task) || StealTask(workerIndex, priority, task))
+            {
+                worker.RecordLatency(priority, std::max<time::Raw_t>(QueueTime() - task.mQueueTime, 0));
+                worker.mRunningTask.store(true, std::memory_order_relaxed);
+                return std::move(task.mTask);
+            }
+        }
+
+        // nothing to do, park and check once more in case task was added while we were searching,
+        // and it's producer did not see us parked yet
+        worker.mParked = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!HasTasks() || !worker.mParked.exchange(false))
+        {
+            // parked, or someone already woke us up, in which case processor will call us right back
+            return {};
+        }
+    }
+}
+
+
+yaget::mt::JobPool::QueueLatency yaget::mt::JobPool::GetQueueLatency(Priority priority) const
+{
+    const std::size_t index = static_cast<std::size_t>(priority);
+
+    time::Raw_t total = 0;
+    time::Raw_t max = 0;
+    QueueLatency result;
+    for (const auto& worker : mWorkers)
+    {
+        const Worker::Latency& latency = worker->mLatency[index];
+        result.mNumTasks += latency.mNumTasks.load(std::memory_order_relaxed);
+        total += latency.mTotal.load(std::memory_order_relaxed);
+        max = std::max(max, latency.mMax.load(std::memory_order_relaxed));
+    }
+
+    result.mTotal = time::FromTo<time::Microsecond_t>(total, time::kRawUnit, time::kMicrosecondUnit);
+    result.mMax = time::FromTo<time::Microsecond_t>(max, time::kRawUnit, time::kMicrosecondUnit);
+    return result;
+}
+
+
+std::size_t yaget::mt::JobPool::GetNumBusyWorkers() const
+{
+    return std::ranges::count_if(mWorkers, [](const auto& worker) { return worker->mRunningTask.load(std::memory_order_relaxed); });
+}
+
+
+void yaget::mt::JobPool::ApplyThreadOptions() const
+{
+    if (mThreadOptions.mPriority != platform::ThreadPriority::Normal && !platform::SetCurrentThreadPriority(mThreadOptions.mPriority))
+    {
+        YLOG_WARNING("POOL", "Could not set thread priority '%d' for JobPool '%s'. %s", static_cast<int>(mThreadOptions.mPriority), mName.c_str(), platform::LastErrorMessage().c_str());
+    }
+
+    if (mThreadOptions.mAffinityMask && !platform::SetCurrentThreadAffinity(mThreadOptions.mAffinityMask))
+    {
+        YLOG_WARNING("POOL", "Could not set thread affinity '0x%llx' for JobPool '%s'. %s", mThreadOptions.mAffinityMask, mName.c_str(), platform::LastErrorMessage().c_str());
+    }
+}
+
+
+yaget::mt::JobPool::ThreadOptions yaget::mt::JobPool::ConfiguredThreadOptions(const std::string& configName)
+{
+    ThreadOptions threadOptions;
+
+    const auto& pools = dev::CurrentConfiguration().mDebug.mThreads.Pools;
+
+    // block for pool which does not exist is most likely a typo, check once for all pools
+    [[maybe_unused]] static const bool poolsChecked = [&pools]()
+    {
+        for (const auto& [poolName, poolOptions] : pools)
+        {
+            if (std::ranges::find(ConfiguredPoolNames, poolName) == std::end(ConfiguredPoolNames))
+            {
+                std::string validNames;
+                for (const char* name : ConfiguredPoolNames)
+                {
+                    validNames += validNames.empty() ? name : fmt::format(", {}", name);
+                }
+
+                YLOG_WARNING("POOL", "Unknown pool '%s' in Debug.Threads.Pools configuration, it's options are ignored. Valid pools: '%s'.", poolName.c_str(), validNames.c_str());
+            }
+        }
+
+        return true;
+    }();
+
+    const auto it = pools.find(configName);
+    if (it == pools.end())
+    {
+        return threadOptions;
+    }
+
+    const std::map<std::string, platform::ThreadPriority> priorities =
+    {
+        { "Lowest", platform::ThreadPriority::Lowest },
+        { "Low", platform::ThreadPriority::Low },
+        { "Normal", platform::ThreadPriority::Normal },
+        { "High", platform::ThreadPriority::High },
+        { "Highest", platform::ThreadPriority::Highest }
+    };
+
+    if (const auto priorityIt = priorities.find(it->second.Priority); priorityIt != priorities.end())
+    {
+        threadOptions.mPriority = priorityIt->second;
+    }
+    else
+    {
+        YLOG_WARNING("POOL", "Unknown thread priority '%s' for pool '%s' in configuration, using Normal.", it->second.Priority.c_str(), configName.c_str());
+    }
+
+    for (uint32_t core : it->second.Cores)
+    {
+        if (core < 64)
+        {
+            threadOptions.mAffinityMask |= uint64_t{ 1 } << core;
+        }
+        else
+        {
+            YLOG_WARNING("POOL", "Core '%d' for pool '%s' in configuration is out of range, only first 64 cores can be used.", core, configName.c_str());
+        }
+    }
+
+    return threadOptions;
+}
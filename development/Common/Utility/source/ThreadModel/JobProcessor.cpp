@@ -117,7 +117,7 @@ void yaget::mt::JobProcessor::operator()(PopNextTask_t popNextTask)
         { 
             try 
             { 
-                metrics::Channel lifetimeChannel("Task Lifetime"); 
+                metrics::Channel lifetimeChannel(YAGET_TRACE_NAME("Task Lifetime")); 
  
                 mTaskInProgress = true; 
                 nextTask(); 
@@ -0,0 +1,217 @@
+#include "ThreadModel/TaskGraph.h"
+#include "Debugging/Assert.h"
+#include "Logger/YLog.h"
+
+namespace
+{
+    std::string ExceptionMessage(std::exception_ptr exception)
+    {
+        try
+        {
+            std::rethrow_exception(exception);
+        }
+        catch (const std::exception& e)
+        {
+            return e.what();
+        }
+        catch (...)
+        {
+            return "unknown exception";
+        }
+    }
+
+} // namespace
+
+
+yaget::mt::internal::TaskNode::TaskNode(JobPool& pool, UniqueFunction<void()> work)
+    : mPool(pool)
+    , mWork(std::move(work))
+    , mHasWork(static_cast<bool>(mWork))
+{
+}
+
+
+void yaget::mt::internal::TaskNode::Schedule(const Dependencies& dependencies)
+{
+    mNumPendingDependencies += dependencies.size();
+    for (const auto& dependency : dependencies)
+    {
+        YAGET_ASSERT(dependency, "Task dependency is not valid.");
+        dependency->AddContinuation(shared_from_this());
+    }
+
+    // release the one we started with, this may schedule task right away
+    OnDependencyFinished(true);
+}
+
+
+bool yaget::mt::internal::TaskNode::Cancel()
+{
+    TaskState expected = TaskState::Pending;
+    if (mState.compare_exchange_strong(expected, TaskState::Cancelled))
+    {
+        Finish(TaskState::Cancelled);
+        return true;
+    }
+
+    return false;
+}
+
+
+void yaget::mt::internal::TaskNode::Wait()
+{
+    std::unique_lock<std::mutex> locker(mMutex);
+    mFinishedCondition.wait(locker, [this] { return mFinished; });
+}
+
+
+std::exception_ptr yaget::mt::internal::TaskNode::Exception() const
+{
+    std::lock_guard<std::mutex> locker(mMutex);
+    return mException;
+}
+
+
+void yaget::mt::internal::TaskNode::AddContinuation(std::shared_ptr<TaskNode> continuation)
+{
+    {
+        std::lock_guard<std::mutex> locker(mMutex);
+        if (!mFinished)
+        {
+            mContinuations.emplace_back(std::move(continuation));
+            return;
+        }
+    }
+
+    continuation->OnDependencyFinished(mState == TaskState::Done);
+}
+
+
+void yaget::mt::internal::TaskNode::OnDependencyFinished(bool succeeded)
+{
+    if (!succeeded)
+    {
+        mDependencyFailed = true;
+    }
+
+    if (mNumPendingDependencies.fetch_sub(1) != 1)
+    {
+        return;
+    }
+
+    if (mDependencyFailed)
+    {
+        Cancel();
+    }
+    else if (mState == TaskState::Pending)
+    {
+        if (mHasWork)
+        {
+            // pool can drop queued tasks without running them (Clear, Destroy),
+            // in which case node is cancelled, so no one waits on it forever
+            struct PoolTask
+            {
+                explicit PoolTask(std::shared_ptr<TaskNode> node) : mNode(std::move(node)) {}
+                PoolTask(PoolTask&& other) noexcept = default;
+                ~PoolTask()
+                {
+                    if (mNode)
+                    {
+                        mNode->Cancel();
+                    }
+                }
+
+                void operator()()
+                {
+                    std::exchange(mNode, nullptr)->Execute();
+                }
+
+                std::shared_ptr<TaskNode> mNode;
+            };
+
+            mPool.AddTask(PoolTask(shared_from_this()));
+        }
+        else
+        {
+            Execute();
+        }
+    }
+}
+
+
+void yaget::mt::internal::TaskNode::Execute()
+{
+    // lost to Cancel
+    TaskState expected = TaskState::Pending;
+    if (!mState.compare_exchange_strong(expected, TaskState::Running))
+    {
+        return;
+    }
+
+    TaskState result = TaskState::Done;
+    if (mHasWork)
+    {
+        std::exception_ptr exception;
+        try
+        {
+            mWork();
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        if (exception)
+        {
+            YLOG_ERROR("MULT", "Task failed with exception: '%s'. All of it's continuations are cancelled.", ExceptionMessage(exception).c_str());
+            std::lock_guard<std::mutex> locker(mMutex);
+            mException = exception;
+            result = TaskState::Failed;
+        }
+    }
+
+    Finish(result);
+}
+
+
+void yaget::mt::internal::TaskNode::Finish(TaskState state)
+{
+    // work may hold on to results of other tasks, release them as soon as possible
+    mWork = nullptr;
+
+    Dependencies continuations;
+    {
+        std::lock_guard<std::mutex> locker(mMutex);
+        mState = state;
+        mFinished = true;
+        continuations.swap(mContinuations);
+    }
+
+    mFinishedCondition.notify_all();
+
+    for (const auto& continuation : continuations)
+    {
+        continuation->OnDependencyFinished(state == TaskState::Done);
+    }
+}
+
+
+yaget::mt::TaskHandle<void> yaget::mt::TaskGraph::WhenAll(const std::vector<Task>& tasks)
+{
+    auto node = std::make_shared<internal::TaskNode>(mPool, nullptr);
+    node->Schedule(Nodes(tasks));
+    return TaskHandle<void>(std::move(node), nullptr);
+}
+
+
+yaget::mt::internal::TaskNode::Dependencies yaget::mt::TaskGraph::Nodes(const std::vector<Task>& tasks)
+{
+    internal::TaskNode::Dependencies nodes;
+    nodes.reserve(tasks.size());
+    for (const auto& task : tasks)
+    {
+        nodes.push_back(task.mNode);
+    }
+
+    return nodes;
+}
@@ -10,7 +10,7 @@ namespace fs = std::filesystem;
 
 yaget::io::BlobLoader::BlobLoader(bool loadAllFiles, ErrorCallback errorCallback)
     : mErrorCallback(errorCallback ? errorCallback : [](const std::string&, const std::string&) {})
-    , mJobPool("BlobLoader", dev::CurrentConfiguration().mDebug.mThreads.Blob)
+    , mJobPool("BlobLoader", dev::CurrentConfiguration().mDebug.mThreads.Blob, mt::JobPool::Behaviour::StartAsRun, mt::JobPool::ConfiguredThreadOptions("Blob"))
     , mFileLoader(std::make_unique<io::FileLoader>())
     , mLoadAllFiles(loadAllFiles)
 {}
@@ -44,7 +44,9 @@ void yaget::io::BlobLoader::AddTask(const Strings& fileNames, const std::vector<
     YAGET_ASSERT_ERROR((fileNames.size() == convertors.size()) || (fileNames.size() > 1 && convertors.size() == 1),
         "File names and converters arrays did not match. Both must be the same size OR converter must be 1. FileNames: '%d', Converters: '%d'", fileNames.size(), convertors.size());
 
-    mCounter += convertors.empty() ? 0 : fileNames.size();
+    const std::size_t numFiles = convertors.empty() ? 0 : fileNames.size();
+    mCounter += numFiles;
+    mCounterGauge.Add(static_cast<int64_t>(numFiles));
 
     std::vector<io::DataLoader::DoneCallback_t> adjustedConverters;
     for (const auto& it : convertors)
@@ -72,7 +74,7 @@ void yaget::io::BlobLoader::AddTask(const std::string& fileName, Convertor conve
 void yaget::io::BlobLoader::onDataPayload(const io::Buffer& dataBuffer, const std::string& fileName, Convertor convertor)
 {
     // Since actual processing of the buffer data might take a while, we farm that to another thread, which in turn will call convertor from that thread
-    mJobPool.AddTask([this, dataBuffer, fileName, convertor]()
+    mJobPool.AddTask([this, dataBuffer, fileName, convertor = std::move(convertor)]()
     {
         metrics::Channel channel(fs::path(fileName).filename().generic_string());
 
@@ -87,6 +89,7 @@ void yaget::io::BlobLoader::onDataPayload(const io::Buffer& dataBuffer, const st
         }
 
         mCounter--;
+        mCounterGauge.Add(-1);
     });
 }
 
@@ -19,7 +19,7 @@ namespace fs = std::filesystem;
 yaget::io::VirtualTransportSystem::VirtualTransportSystem(dev::Configuration::Init::VTSConfigList configList, VirtualTransportSystem::DoneCallback doneCallback, const AssetResolvers& assetResolvers, const std::string& fileName, RuntimeMode reset)
     : mRuntimeMode(RuntimeMode::Optimum)
     , mDoneCallback(std::move(doneCallback))
-    , mRequestPool("vts.Request", dev::CurrentConfiguration().mDebug.mThreads.VTS)
+    , mRequestPool("vts.Request", dev::CurrentConfiguration().mDebug.mThreads.VTS, mt::JobPool::Behaviour::StartAsRun, mt::JobPool::ConfiguredThreadOptions("VTS"))
     , mAssetResolvers(assetResolvers)
     , mDatabase(ResolveDatabaseName(fileName, reset == RuntimeMode::Reset), vtsSchema, YAGET_VTS_VERSION)
     , mSectionEntriesCollector(std::make_shared<SectionEntriesCollector>(configList, mDatabase, [this]() { onEntriesCollected(); }))
@@ -121,6 +121,7 @@ void yaget::io::VirtualTransportSystem::onBlobLoaded(const io::Buffer& dataBuffe
     metrics::Channel span(fmt::format("BlobLoaded {}", requestedTag.mVTSName).c_str());
 
     TagCounterKeeper tagCounterKeeper(tagsCounter, requestedTag);
+    mPendingRequestsGauge.Add(-1);
 
     try
     {
@@ -182,6 +183,10 @@ std::shared_ptr<yaget::io::Asset> yaget::io::VirtualTransportSystem::AddAssetNon
 {
     auto result = mAssets.insert(std::make_pair(asset->mTag, asset));
     YAGET_ASSERT(result.second, "Asset: '%s' already exists in collection.", asset->mTag.mVTSName.c_str());
+    if (result.second)
+    {
+        mCachedBytesGauge.Add(static_cast<int64_t>(asset->mBuffer.second));
+    }
 
     return result.first->second;
 }
@@ -193,8 +198,14 @@ void yaget::io::VirtualTransportSystem::ClearAssets(const io::Tags& tags)
     std::unique_lock<std::mutex> locker(mMutexAssets);
     for (const auto& tag : tags)
     {
-        mAssets.erase(tag);
-        mOverrideAssets.erase(tag);
+        for (auto* assets : { &mAssets, &mOverrideAssets })
+        {
+            if (auto it = assets->find(tag); it != assets->end())
+            {
+                mCachedBytesGauge.Add(-static_cast<int64_t>(it->second->mBuffer.second));
+                assets->erase(it);
+            }
+        }
     }
 }
 
@@ -242,6 +253,10 @@ void yaget::io::VirtualTransportSystem::AddOverride(const std::shared_ptr<yaget:
 
     auto result = mOverrideAssets.insert(std::make_pair(asset->mTag, asset));
     YAGET_ASSERT(result.second, "Asset: '%s' already exists in cashed collection.", asset->mTag.mVTSName.c_str());
+    if (result.second)
+    {
+        mCachedBytesGauge.Add(static_cast<int64_t>(asset->mBuffer.second));
+    }
 }
 
 
@@ -346,6 +361,7 @@ bool yaget::io::VirtualTransportSystem::UpdateAssetData(const std::shared_ptr<io
             return false;
         }
 
+        mCachedBytesGauge.Add(static_cast<int64_t>(asset->mBuffer.second) - static_cast<int64_t>(assetData->mBuffer.second));
         assetData->mBuffer = io::CloneBuffer(asset->mBuffer);
         return true;
     }
@@ -526,6 +542,7 @@ size_t yaget::io::VirtualTransportSystem::RequestBlob(const std::vector<io::Tag>
         {
             (*tagsCounter) += tagRecords.size();
         }
+        mPendingRequestsGauge.Add(static_cast<int64_t>(tagRecords.size()));
 
         std::vector<std::shared_ptr<io::Asset>> loadedAssets;
         Strings fileNames;
@@ -568,6 +585,7 @@ size_t yaget::io::VirtualTransportSystem::RequestBlob(const std::vector<io::Tag>
                 for (const auto& it : loadedAssets)
                 {
                     TagCounterKeeper tagCounterKeeper(tagsCounter, it->mTag);
+                    mPendingRequestsGauge.Add(-1);
 
                     try
                     {
@@ -587,6 +605,38 @@ size_t yaget::io::VirtualTransportSystem::RequestBlob(const std::vector<io::Tag>
 }
 
 
+size_t yaget::io::VirtualTransportSystem::RequestBlob(const std::vector<io::Tag>& tags, BlobAssetCallback blobAssetCallback, std::atomic_size_t* tagsCounter, DoneCallback doneCallback)
+{
+    // Every copy of callback is released after it's tag was processed, whether asset was created or not,
+    // so doneCallback is triggered when the last one goes away.
+    struct DoneNotifier : public Noncopyable<DoneNotifier>
+    {
+        explicit DoneNotifier(DoneCallback doneCallback)
+            : mDoneCallback(std::move(doneCallback))
+        {}
+
+        ~DoneNotifier()
+        {
+            if (mDoneCallback)
+            {
+                mDoneCallback();
+            }
+        }
+
+        DoneCallback mDoneCallback;
+    };
+
+    auto doneNotifier = std::make_shared<DoneNotifier>(std::move(doneCallback));
+    auto callback = [doneNotifier, blobAssetCallback = std::move(blobAssetCallback)](std::shared_ptr<io::Asset> asset)
+    {
+        blobAssetCallback(asset);
+    };
+
+    doneNotifier.reset();
+    return RequestBlob(tags, callback, tagsCounter);
+}
+
+
 std::string yaget::io::VirtualTransportSystem::GetResolverType(const io::Tag& tag) const
 {
     std::string resolverType;
@@ -399,8 +399,9 @@ namespace
             return "";
         }
 
-        const platform::ThreadNames& GetThreadNames() const
+        platform::ThreadNames GetThreadNames() const
         {
+            std::unique_lock<std::mutex> locker(mMutex);
             return mNames;
         }
 
@@ -547,11 +548,41 @@ uint32_t platform::CurrentThreadId()
     return ::GetCurrentThreadId();
 }
 
-const platform::ThreadNames& platform::GetThreadNames()
+platform::ThreadNames platform::GetThreadNames()
 {
     return threadNames.GetThreadNames();
 }
 
+bool platform::SetCurrentThreadPriority(ThreadPriority priority)
+{
+    int threadPriority = THREAD_PRIORITY_NORMAL;
+    switch (priority)
+    {
+    case ThreadPriority::Lowest:
+        threadPriority = THREAD_PRIORITY_LOWEST;
+        break;
+    case ThreadPriority::Low:
+        threadPriority = THREAD_PRIORITY_BELOW_NORMAL;
+        break;
+    case ThreadPriority::Normal:
+        threadPriority = THREAD_PRIORITY_NORMAL;
+        break;
+    case ThreadPriority::High:
+        threadPriority = THREAD_PRIORITY_ABOVE_NORMAL;
+        break;
+    case ThreadPriority::Highest:
+        threadPriority = THREAD_PRIORITY_HIGHEST;
+        break;
+    }
+
+    return ::SetThreadPriority(::GetCurrentThread(), threadPriority) != 0;
+}
+
+bool platform::SetCurrentThreadAffinity(uint64_t affinityMask)
+{
+    return ::SetThreadAffinityMask(::GetCurrentThread(), static_cast<DWORD_PTR>(affinityMask)) != 0;
+}
+
 void platform::Sleep(SleepPredicate sleepPredicate)
 {
     while (sleepPredicate())
@@ -0,0 +1,140 @@
+#include "PerfHarness.h"
+#include "Components/Coordinator.h"
+
+
+namespace
+{
+    struct PerfPosition
+    {
+        static constexpr int Capacity = 4096;
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+    };
+
+    struct PerfVelocity
+    {
+        static constexpr int Capacity = 4096;
+        float x = 1.0f, y = 1.0f, z = 1.0f;
+    };
+
+    struct PerfTag
+    {
+        static constexpr int Capacity = 4096;
+    };
+
+    // every fourth item also has PerfTag, which splits items into two patterns
+    template <typename P>
+    void Populate(yaget::comp::Coordinator<P>& coordinator, std::size_t numItems)
+    {
+        for (std::size_t i = 1; i <= numItems; ++i)
+        {
+            const auto id = static_cast<yaget::comp::Id_t>(i);
+            coordinator.template AddComponent<PerfPosition>(id);
+            coordinator.template AddComponent<PerfVelocity>(id);
+            if (i % 4 == 0)
+            {
+                coordinator.template AddComponent<PerfTag>(id);
+            }
+        }
+    }
+
+    template <typename P>
+    void RunForEach(const std::string& label)
+    {
+        using namespace yaget;
+        using Coordinator = comp::Coordinator<P>;
+        using MoveRow = comp::RowPolicy<PerfPosition*, PerfVelocity*>;
+
+        for (std::size_t numItems : { 10'000, 100'000, 1'000'000 })
+        {
+            Coordinator coordinator;
+            Populate(coordinator, numItems);
+
+            float accumulator = 0.0f;
+            auto step = [&accumulator](comp::Id_t /*id*/, const MoveRow::Row& row)
+            {
+                auto [position, velocity] = row;
+                position->x += velocity->x;
+                accumulator += position->x;
+                return true;
+            };
+
+            // sorted path, std::function with intermediate ItemIds set and per id lookup
+            perf::Measure(fmt::format("{} ForEach {}", label, numItems), numItems, [&coordinator, &step]()
+            {
+                coordinator.template ForEach<MoveRow>(step);
+            });
+
+            perf::Measure(fmt::format("{} ForEachUnordered {}", label, numItems), numItems, [&coordinator, &step]()
+            {
+                coordinator.template ForEachUnordered<MoveRow>(step);
+            });
+
+            YLOG_DEBUG("PROF", "Accumulator: %f", accumulator);
+
+            comp::ItemIds ids = coordinator.template GetItemIds<comp::RowPolicy<PerfPosition*>>();
+            coordinator.RemoveItems(ids);
+        }
+    }
+
+    template <typename P>
+    void RunSpawn(const std::string& label)
+    {
+        using namespace yaget;
+        using Coordinator = comp::Coordinator<P>;
+        using SpawnRow = comp::RowPolicy<PerfPosition*, PerfVelocity*, PerfTag*>;
+
+        for (std::size_t numItems : { 10'000, 100'000 })
+        {
+            comp::ItemIds ids;
+            for (std::size_t i = 1; i <= numItems; ++i)
+            {
+                ids.insert(static_cast<comp::Id_t>(i));
+            }
+
+            // previous path, one component at the time, each moving item to next pattern
+            perf::Measure(fmt::format("{} per component spawn/destroy {}", label, numItems), numItems, [&ids]()
+            {
+                Coordinator coordinator;
+                for (const auto& id : ids)
+                {
+                    coordinator.template AddComponent<PerfPosition>(id);
+                    coordinator.template AddComponent<PerfVelocity>(id);
+                    coordinator.template AddComponent<PerfTag>(id);
+                }
+
+                for (const auto& id : ids)
+                {
+                    coordinator.template RemoveComponent<PerfTag>(id);
+                    coordinator.template RemoveComponent<PerfVelocity>(id);
+                    coordinator.template RemoveComponent<PerfPosition>(id);
+                }
+            });
+
+            perf::Measure(fmt::format("{} bulk spawn/destroy {}", label, numItems), numItems, [&ids]()
+            {
+                Coordinator coordinator;
+                coordinator.template AddItems<SpawnRow>(ids);
+                coordinator.RemoveItems(ids);
+            });
+        }
+    }
+
+} // namespace
+
+
+YAGET_PERF(Coordinator_Spawn)
+{
+    using namespace yaget;
+
+    RunSpawn<comp::RowPolicy<PerfPosition*, PerfVelocity*, PerfTag*>>("Pattern");
+    RunSpawn<comp::ChunkedRowPolicy<PerfPosition*, PerfVelocity*, PerfTag*>>("Chunked");
+}
+
+
+YAGET_PERF(Coordinator_ForEach)
+{
+    using namespace yaget;
+
+    RunForEach<comp::RowPolicy<PerfPosition*, PerfVelocity*, PerfTag*>>("Pattern");
+    RunForEach<comp::ChunkedRowPolicy<PerfPosition*, PerfVelocity*, PerfTag*>>("Chunked");
+}
@@ -0,0 +1,176 @@
+#include "PerfHarness.h"
+#include "ThreadModel/JobPool.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    // small amount of work per task, so scheduling overhead dominates
+    void SmallWork(std::atomic<std::size_t>& counter)
+    {
+        std::size_t value = 0;
+        for (std::size_t i = 0; i < 64; ++i)
+        {
+            value += i * i;
+        }
+
+        counter.fetch_add(value ? 1 : 0, std::memory_order_relaxed);
+    }
+
+    // each task adds fanOut tasks until depth is reached, all spawning happens on worker threads
+    void Spawn(yaget::mt::JobPool& pool, std::atomic<std::size_t>& counter, int fanOut, int depth)
+    {
+        SmallWork(counter);
+        if (depth == 0)
+        {
+            return;
+        }
+
+        for (int i = 0; i < fanOut; ++i)
+        {
+            pool.AddTask([&pool, &counter, fanOut, depth]() { Spawn(pool, counter, fanOut, depth - 1); });
+        }
+    }
+
+    std::size_t NumTreeTasks(int fanOut, int depth)
+    {
+        std::size_t result = 0;
+        std::size_t level = 1;
+        for (int i = 0; i <= depth; ++i)
+        {
+            result += level;
+            level *= fanOut;
+        }
+
+        return result;
+    }
+
+    // task capturing counter and NumBytes of payload
+    template <std::size_t NumBytes>
+    auto MakeTask(std::atomic<std::size_t>& counter)
+    {
+        std::array<std::byte, NumBytes - sizeof(void*)> payload{};
+        return [&counter, payload]()
+        {
+            counter.fetch_add(payload.size() + static_cast<std::size_t>(payload[0]), std::memory_order_relaxed);
+        };
+    }
+
+    // one task per run, so allocs/run reported by harness is number of allocations per task
+    template <std::size_t NumBytes>
+    void MeasureTaskStorage(yaget::mt::JobPool& pool, std::atomic<std::size_t>& counter)
+    {
+        using namespace yaget;
+
+        perf::Measure(fmt::format("std::function, {} bytes capture", NumBytes), 1, [&counter]()
+        {
+            std::function<void()> task = MakeTask<NumBytes>(counter);
+            std::function<void()> movedTask = std::move(task);
+            movedTask();
+        });
+
+        perf::Measure(fmt::format("JobProcessor::Task_t, {} bytes capture", NumBytes), 1, [&counter]()
+        {
+            mt::JobProcessor::Task_t task = MakeTask<NumBytes>(counter);
+            mt::JobProcessor::Task_t movedTask = std::move(task);
+            movedTask();
+        });
+
+        perf::Measure(fmt::format("JobPool AddTask, {} bytes capture", NumBytes), 1, [&pool, &counter]()
+        {
+            pool.AddTask(MakeTask<NumBytes>(counter));
+            pool.Join();
+        });
+    }
+
+    std::vector<uint32_t> ThreadCounts()
+    {
+        const uint32_t maxThreads = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+
+        std::vector<uint32_t> result;
+        for (uint32_t numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+        {
+            result.push_back(numThreads);
+        }
+        result.push_back(maxThreads);
+
+        return result;
+    }
+
+}
+
+
+YAGET_PERF(JobPool_ExternalTasks)
+{
+    using namespace yaget;
+
+    const std::size_t numTasks = 100'000;
+    for (uint32_t numThreads : ThreadCounts())
+    {
+        mt::JobPool pool("PERF", numThreads);
+        std::atomic<std::size_t> counter{ 0 };
+
+        perf::Measure(fmt::format("JobPool AddTask from main thread, threads {}", numThreads), numTasks, [&pool, &counter, numTasks]()
+        {
+            for (std::size_t i = 0; i < numTasks; ++i)
+            {
+                pool.AddTask([&counter]() { SmallWork(counter); });
+            }
+
+            pool.Join();
+        });
+
+        perf::Measure(fmt::format("JobPool Locker AddTask from main thread, threads {}", numThreads), numTasks, [&pool, &counter, numTasks]()
+        {
+            {
+                auto locker = pool.GetLocker();
+                for (std::size_t i = 0; i < numTasks; ++i)
+                {
+                    locker.AddTask([&counter]() { SmallWork(counter); });
+                }
+            }
+
+            pool.Join();
+        });
+    }
+}
+
+
+YAGET_PERF(JobPool_NestedTasks)
+{
+    using namespace yaget;
+
+    const int fanOut = 8;
+    const int depth = 5;
+    const std::size_t numTasks = NumTreeTasks(fanOut, depth);
+    for (uint32_t numThreads : ThreadCounts())
+    {
+        mt::JobPool pool("PERF", numThreads);
+        std::atomic<std::size_t> counter{ 0 };
+
+        perf::Measure(fmt::format("JobPool nested AddTask tree {}, threads {}", numTasks, numThreads), numTasks, [&pool, &counter, fanOut, depth]()
+        {
+            pool.AddTask([&pool, &counter, fanOut, depth]() { Spawn(pool, counter, fanOut, depth); });
+            pool.Join();
+        });
+    }
+}
+
+
+YAGET_PERF(JobPool_TaskStorage)
+{
+    using namespace yaget;
+
+    mt::JobPool pool("PERF", 1);
+    std::atomic<std::size_t> counter{ 0 };
+
+    MeasureTaskStorage<16>(pool, counter);
+    MeasureTaskStorage<48>(pool, counter);
+    MeasureTaskStorage<64>(pool, counter);
+    MeasureTaskStorage<128>(pool, counter);
+}
@@ -0,0 +1,89 @@
+#include "PerfHarness.h"
+#include "ThreadModel/Parallel.h"
+#include <cmath>
+#include <functional>
+#include <vector>
+
+
+namespace
+{
+    // few flops per element, similar to integrating positions in game system
+    void Step(std::vector<float>& values, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            values[i] = values[i] * 0.99f + std::sqrt(static_cast<float>(i));
+        }
+    }
+
+    double Sum(const std::vector<float>& values, std::size_t begin, std::size_t end)
+    {
+        double result = 0.0;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            result += values[i];
+        }
+
+        return result;
+    }
+
+    const std::size_t kGrainSize = 1024;
+}
+
+
+YAGET_PERF(Parallel_For)
+{
+    using namespace yaget;
+
+    mt::JobPool pool("PERF");
+    for (std::size_t numItems : { 1'000, 10'000, 100'000, 1'000'000, 10'000'000 })
+    {
+        std::vector<float> values(numItems, 1.0f);
+
+        perf::Measure(fmt::format("serial for {}", numItems), numItems, [&values, numItems]()
+        {
+            Step(values, 0, numItems);
+        });
+
+        perf::Measure(fmt::format("parallel_for {}, threads {}", numItems, pool.MaxNumThreads() + 1), numItems, [&pool, &values, numItems]()
+        {
+            mt::parallel_for(pool, 0, numItems, kGrainSize, [&values](std::size_t begin, std::size_t end)
+            {
+                Step(values, begin, end);
+            });
+        });
+
+        YLOG_DEBUG("PROF", "Value: %f", values[numItems / 2]);
+    }
+}
+
+
+YAGET_PERF(Parallel_Reduce)
+{
+    using namespace yaget;
+
+    mt::JobPool pool("PERF");
+    for (std::size_t numItems : { 1'000, 10'000, 100'000, 1'000'000, 10'000'000 })
+    {
+        std::vector<float> values(numItems, 1.0f);
+        double result = 0.0;
+
+        // values change between runs, so sum can not be hoisted out of measured block
+        perf::Measure(fmt::format("serial reduce {}", numItems), numItems, [&values, &result, numItems]()
+        {
+            values[static_cast<std::size_t>(result) % numItems] += 1.0f;
+            result += Sum(values, 0, numItems);
+        });
+
+        perf::Measure(fmt::format("parallel_reduce {}, threads {}", numItems, pool.MaxNumThreads() + 1), numItems, [&pool, &values, &result, numItems]()
+        {
+            values[static_cast<std::size_t>(result) % numItems] += 1.0f;
+            result += mt::parallel_reduce(pool, 0, numItems, kGrainSize, 0.0, [&values](std::size_t begin, std::size_t end)
+            {
+                return Sum(values, begin, end);
+            }, std::plus<double>{});
+        });
+
+        YLOG_DEBUG("PROF", "Result: %f", result);
+    }
+}
@@ -0,0 +1,329 @@
+#include "PerfHarness.h"
+#include "MemoryManager/PoolAllocator.h"
+#include "MemoryManager/ConcurrentPoolAllocator.h"
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <thread>
+
+
+namespace
+{
+    struct PerfObject
+    {
+        PerfObject() = default;
+        PerfObject(int value) : mValue(value) {}
+
+        int mValue = 0;
+        float mPayload[7] = {};
+    };
+
+    constexpr std::size_t kNumObjects = 1'000'000;
+
+    // allocate all objects, then free them all
+    template <int E>
+    void RunCycles(const std::string& label)
+    {
+        using namespace yaget;
+
+        memory::PoolAllocator<PerfObject, E> poolAllocator;
+        std::vector<PerfObject*> objects(kNumObjects);
+
+        perf::Measure(fmt::format("{} allocate/free {}", label, kNumObjects), kNumObjects, [&poolAllocator, &objects]()
+        {
+            for (std::size_t i = 0; i < kNumObjects; ++i)
+            {
+                objects[i] = poolAllocator.Allocate(static_cast<int>(i));
+            }
+
+            for (auto object : objects)
+            {
+                poolAllocator.Free(object);
+            }
+        });
+    }
+
+    // keep pool full, free every other object in random order and allocate them again,
+    // so free slots are spread over all lines
+    template <int E>
+    void RunFragmented(const std::string& label)
+    {
+        using namespace yaget;
+
+        memory::PoolAllocator<PerfObject, E> poolAllocator;
+        std::vector<PerfObject*> objects(kNumObjects);
+        for (std::size_t i = 0; i < kNumObjects; ++i)
+        {
+            objects[i] = poolAllocator.Allocate(static_cast<int>(i));
+        }
+
+        std::vector<std::size_t> indexes;
+        for (std::size_t i = 0; i < kNumObjects; i += 2)
+        {
+            indexes.push_back(i);
+        }
+        std::shuffle(indexes.begin(), indexes.end(), std::mt19937(42));
+
+        perf::Measure(fmt::format("{} fragmented free/allocate {}", label, indexes.size()), indexes.size(), [&poolAllocator, &objects, &indexes]()
+        {
+            for (auto index : indexes)
+            {
+                poolAllocator.Free(objects[index]);
+            }
+
+            for (auto index : indexes)
+            {
+                objects[index] = poolAllocator.Allocate(static_cast<int>(index));
+            }
+        });
+
+        for (auto object : objects)
+        {
+            poolAllocator.Free(object);
+        }
+    }
+
+    // keep every keepEvery object allocated and walk pool with Iterator and ForEachAllocated
+    void RunIterate(const std::string& label, std::size_t keepEvery)
+    {
+        using namespace yaget;
+
+        memory::PoolAllocator<PerfObject, 4096> poolAllocator;
+        std::vector<PerfObject*> objects(kNumObjects);
+        for (std::size_t i = 0; i < kNumObjects; ++i)
+        {
+            objects[i] = poolAllocator.Allocate(static_cast<int>(i));
+        }
+
+        for (std::size_t i = 0; i < kNumObjects; ++i)
+        {
+            if (i % keepEvery)
+            {
+                poolAllocator.Free(objects[i]);
+                objects[i] = nullptr;
+            }
+        }
+
+        // items per run is pool capacity, so sparse and dense pools are comparable
+        int accumulator = 0;
+        perf::Measure(fmt::format("{} Iterator {}", label, kNumObjects), kNumObjects, [&poolAllocator, &accumulator]()
+        {
+            for (auto it = poolAllocator.begin(); it != poolAllocator.end(); ++it)
+            {
+                accumulator += it->mValue;
+            }
+        });
+
+        perf::Measure(fmt::format("{} ForEachAllocated {}", label, kNumObjects), kNumObjects, [&poolAllocator, &accumulator]()
+        {
+            poolAllocator.ForEachAllocated([&accumulator](const PerfObject& object)
+            {
+                accumulator += object.mValue;
+            });
+        });
+
+        YLOG_DEBUG("PROF", "Accumulator: %d", accumulator);
+
+        for (auto object : objects)
+        {
+            if (object)
+            {
+                poolAllocator.Free(object);
+            }
+        }
+    }
+
+    // PoolAllocator is single threaded, guard it with one lock to compare against ConcurrentPoolAllocator
+    struct LockedPoolAllocator
+    {
+        template <typename... Args>
+        PerfObject* Allocate(Args&&... args)
+        {
+            std::unique_lock<std::mutex> locker(mMutex);
+            return mPoolAllocator.Allocate(std::forward<Args>(args)...);
+        }
+
+        void Free(PerfObject* object)
+        {
+            std::unique_lock<std::mutex> locker(mMutex);
+            mPoolAllocator.Free(object);
+        }
+
+        std::mutex mMutex;
+        yaget::memory::PoolAllocator<PerfObject, 4096> mPoolAllocator;
+    };
+
+    // Each thread allocates kBatch objects and frees them, every other batch is freed by next thread (remote free)
+    template <typename A>
+    void RunContention(const std::string& label)
+    {
+        using namespace yaget;
+
+        constexpr std::size_t kBatch = 256;
+        constexpr std::size_t kNumBatches = 200;
+
+        for (std::size_t numThreads : { 1, 2, 4, 8, 16 })
+        {
+            A poolAllocator;
+            perf::Measure(fmt::format("{} {} threads", label, numThreads), numThreads * kBatch * kNumBatches, [&poolAllocator, numThreads]()
+            {
+                // batches handed from thread to next one
+                std::vector<std::vector<PerfObject*>> handOff(numThreads);
+                std::vector<std::mutex> handOffMutex(numThreads);
+
+                std::vector<std::thread> threads;
+                for (std::size_t t = 0; t < numThreads; ++t)
+                {
+                    threads.emplace_back([&poolAllocator, &handOff, &handOffMutex, numThreads, t]()
+                    {
+                        std::vector<PerfObject*> objects(kBatch);
+                        std::vector<PerfObject*> received;
+
+                        for (std::size_t batch = 0; batch < kNumBatches; ++batch)
+                        {
+                            for (auto& object : objects)
+                            {
+                                object = poolAllocator.Allocate(static_cast<int>(batch));
+                            }
+
+                            if (batch % 2 && numThreads > 1)
+                            {
+                                const std::size_t next = (t + 1) % numThreads;
+                                std::unique_lock<std::mutex> locker(handOffMutex[next]);
+                                handOff[next].insert(handOff[next].end(), objects.begin(), objects.end());
+                            }
+                            else
+                            {
+                                for (auto object : objects)
+                                {
+                                    poolAllocator.Free(object);
+                                }
+                            }
+
+                            {
+                                std::unique_lock<std::mutex> locker(handOffMutex[t]);
+                                received.swap(handOff[t]);
+                            }
+
+                            for (auto object : received)
+                            {
+                                poolAllocator.Free(object);
+                            }
+                            received.clear();
+                        }
+                    });
+                }
+
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+
+                // left overs after all threads are done
+                for (auto& objects : handOff)
+                {
+                    for (auto object : objects)
+                    {
+                        poolAllocator.Free(object);
+                    }
+                }
+            });
+        }
+    }
+
+    yaget::memory::PoolAllocator<PerfObject, 4096> staticPoolAllocator;
+
+    // create and destroy transient objects trough smart pointer, kBatch alive at any time
+    template <typename F>
+    void RunSmartPointers(const std::string& label, F&& create)
+    {
+        using namespace yaget;
+
+        constexpr std::size_t kBatch = 1000;
+        constexpr std::size_t kNumBatches = 100;
+
+        using Pointer = decltype(create(0));
+        std::vector<Pointer> objects(kBatch);
+
+        perf::Measure(fmt::format("{} {}", label, kBatch * kNumBatches), kBatch * kNumBatches, [&objects, &create]()
+        {
+            for (std::size_t batch = 0; batch < kNumBatches; ++batch)
+            {
+                for (std::size_t i = 0; i < kBatch; ++i)
+                {
+                    objects[i] = create(static_cast<int>(i));
+                }
+            }
+
+            for (auto& object : objects)
+            {
+                object.reset();
+            }
+        });
+    }
+
+} // namespace
+
+
+YAGET_PERF(PoolAllocator_Cycles)
+{
+    using namespace yaget;
+
+    RunCycles<64>("Line 64");
+    RunCycles<4096>("Line 4096");
+
+    std::vector<PerfObject*> objects(kNumObjects);
+    perf::Measure(fmt::format("new/delete {}", kNumObjects), kNumObjects, [&objects]()
+    {
+        for (std::size_t i = 0; i < kNumObjects; ++i)
+        {
+            objects[i] = new PerfObject(static_cast<int>(i));
+        }
+
+        for (auto object : objects)
+        {
+            delete object;
+        }
+    });
+}
+
+
+YAGET_PERF(PoolAllocator_Fragmented)
+{
+    RunFragmented<64>("Line 64");
+    RunFragmented<4096>("Line 4096");
+}
+
+
+YAGET_PERF(PoolAllocator_Iterate)
+{
+    RunIterate("Dense", 1);
+    RunIterate("Sparse 1%", 100);
+}
+
+
+YAGET_PERF(PoolAllocator_Contention)
+{
+    using namespace yaget;
+
+    RunContention<LockedPoolAllocator>("Locked PoolAllocator");
+    RunContention<memory::ConcurrentPoolAllocator<PerfObject, 4096>>("ConcurrentPoolAllocator");
+}
+
+
+YAGET_PERF(PoolAllocator_SmartPointers)
+{
+    using namespace yaget;
+
+    memory::PoolAllocator<PerfObject, 4096> poolAllocator;
+    memory::ControlBlockPool<> controlBlockPool;
+
+    RunSmartPointers("std::make_shared", [](int value) { return std::make_shared<PerfObject>(value); });
+    RunSmartPointers("memory::New", [&poolAllocator](int value) { return memory::New(poolAllocator, value); });
+    RunSmartPointers("memory::NewShared", [&poolAllocator, &controlBlockPool](int value) { return memory::NewShared(poolAllocator, controlBlockPool, value); });
+    memory::ControlBlockPool<128, 4096> objectBlockPool;
+    RunSmartPointers("memory::AllocateShared", [&objectBlockPool](int value) { return memory::AllocateShared<PerfObject>(objectBlockPool, value); });
+    RunSmartPointers("std::make_unique", [](int value) { return std::make_unique<PerfObject>(value); });
+    RunSmartPointers("memory::NewUnique", [&poolAllocator](int value) { return memory::NewUnique(poolAllocator, value); });
+    RunSmartPointers("memory::NewUnique static pool", [](int value) { return memory::NewUnique<staticPoolAllocator>(value); });
+}
@@ -0,0 +1,238 @@
+#include "PerfHarness.h"
+#include "Metrics/PerformanceTracer.h"
+#include "Metrics/TraceFormat.h"
+#include <sstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    constexpr std::size_t kNumPairs = 1000;
+
+#if YAGET_CONC_METRICS_ENABLED == 1
+    const char* const kMetricsState = "";
+#else
+    const char* const kMetricsState = " (metrics disabled)";
+#endif // YAGET_CONC_METRICS_ENABLED
+
+    // record as it was stored before per thread buffers, pushed into one vector under mutex
+    struct LockedTraceRecord
+    {
+        std::string mName;
+        yaget::time::TimeUnits_t mStart = 0;
+        yaget::time::TimeUnits_t mEnd = 0;
+        std::size_t mThreadID = 0;
+        yaget::metrics::TraceRecord::Event mEvent = yaget::metrics::TraceRecord::Event::Complete;
+        std::size_t mId = 0;
+        std::string mCategory;
+    };
+
+} // namespace
+
+
+// Begin and end of a Channel trough global TraceCollector, including time stamps.
+// Items are begin/end pairs. When DataSaver falls behind, records are dropped,
+// which costs recording thread the same as storing them.
+YAGET_PERF(Trace_Channel)
+{
+    using namespace yaget;
+
+    const std::string channelName = "Perf.Trace.Channel.BeginEnd";
+
+    for (std::size_t numThreads : { 1, 4 })
+    {
+        perf::Measure(fmt::format("Channel begin/end {} threads{}", numThreads, kMetricsState), numThreads * kNumPairs, [&channelName, numThreads]()
+        {
+            auto recordChannels = [&channelName]()
+            {
+                for (std::size_t i = 0; i < kNumPairs; ++i)
+                {
+                    metrics::Channel channel(channelName);
+                }
+            };
+
+            if (numThreads == 1)
+            {
+                recordChannels();
+                return;
+            }
+
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back(recordChannels);
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        });
+    }
+}
+
+
+// Channel name formatted on every tick (as SystemsCoordinator did for each system) against interned name.
+// Items are begin/end pairs.
+YAGET_PERF(Trace_Names)
+{
+    using namespace yaget;
+
+    const char* niceName = "PhysicsIntegrationSystem";
+
+    perf::Measure(fmt::format("Channel formatted name{}", kMetricsState), kNumPairs, [niceName]()
+    {
+        for (std::size_t i = 0; i < kNumPairs; ++i)
+        {
+            metrics::Channel channel(fmt::format("System Tick {}", niceName));
+        }
+    });
+
+    const metrics::TraceNameId tickName = metrics::InternTraceName(fmt::format("System Tick {}", niceName));
+    perf::Measure(fmt::format("Channel interned name{}", kMetricsState), kNumPairs, [tickName]()
+    {
+        for (std::size_t i = 0; i < kNumPairs; ++i)
+        {
+            metrics::Channel channel(tickName);
+        }
+    });
+}
+
+
+// Counter records each changed value, Gauge only updates atomic value and is recorded by SampleGauges.
+// Items are Set or Add calls.
+YAGET_PERF(Trace_Counters)
+{
+    using namespace yaget;
+
+    metrics::Counter counter(metrics::InternTraceName("Perf.Counter"));
+    perf::Measure(fmt::format("Counter set{}", kMetricsState), kNumPairs, [&counter]()
+    {
+        for (std::size_t i = 0; i < kNumPairs; ++i)
+        {
+            counter.Set(static_cast<int64_t>(i));
+        }
+    });
+
+    metrics::Gauge gauge("Perf.Gauge");
+    perf::Measure(fmt::format("Gauge add{}", kMetricsState), kNumPairs, [&gauge]()
+    {
+        for (std::size_t i = 0; i < kNumPairs; ++i)
+        {
+            gauge.Add(1);
+        }
+    });
+
+    // per logic tick cost, all gauges changed since last sample
+    std::vector<std::unique_ptr<metrics::Gauge>> gauges;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        gauges.push_back(std::make_unique<metrics::Gauge>(fmt::format("Perf.Gauge.{}", i)));
+    }
+
+    perf::Measure(fmt::format("SampleGauges 100 changed{}", kMetricsState), 1, [&gauges]()
+    {
+        for (auto& it : gauges)
+        {
+            it->Add(1);
+        }
+
+        metrics::SampleGauges();
+    });
+}
+
+
+// Recording path only, per thread ring buffer against previous mutex and vector of records with strings.
+// Items are begin/end pairs, buffer is drained once per run.
+YAGET_PERF(Trace_Recording)
+{
+    using namespace yaget;
+    using Event = metrics::TraceRecord::Event;
+
+    const std::string channelName = "Perf.Trace.Channel.BeginEnd";
+
+    std::mutex recordsMutex;
+    std::vector<LockedTraceRecord> lockedRecords;
+    perf::Measure("Mutex and vector<record>", kNumPairs, [&channelName, &recordsMutex, &lockedRecords]()
+    {
+        for (std::size_t i = 0; i < kNumPairs; ++i)
+        {
+            {
+                std::unique_lock<std::mutex> mutexLock(recordsMutex);
+                lockedRecords.push_back({ channelName, 0, 0, 0, Event::Begin, 0, "Channel" });
+            }
+            {
+                std::unique_lock<std::mutex> mutexLock(recordsMutex);
+                lockedRecords.push_back({ channelName, 0, 0, 0, Event::End, 0, "Channel" });
+            }
+        }
+
+        // saver swapped whole vector out
+        std::vector<LockedTraceRecord> savedRecords;
+        std::unique_lock<std::mutex> mutexLock(recordsMutex);
+        std::swap(savedRecords, lockedRecords);
+    });
+
+    const metrics::TraceNameId category = metrics::InternTraceName("Channel");
+    auto ringBuffer = std::make_unique<mt::SpscRingBuffer<metrics::TraceRecord, 4096>>();
+    std::size_t numSaved = 0;
+    perf::Measure("SpscRingBuffer<TraceRecord>", kNumPairs, [&channelName, category, &ringBuffer, &numSaved]()
+    {
+        for (std::size_t i = 0; i < kNumPairs; ++i)
+        {
+            const metrics::TraceName name = metrics::MakeTraceName(channelName);
+            ringBuffer->TryPush({ metrics::TraceNameId::Invalid, name, 0, 0, 0, Event::Begin, 0, category });
+            ringBuffer->TryPush({ metrics::TraceNameId::Invalid, name, 0, 0, 0, Event::End, 0, category });
+        }
+
+        numSaved += ringBuffer->PopAll([](const metrics::TraceRecord&) {});
+    });
+
+    YLOG_DEBUG("PROF", "Saved records: %d", numSaved);
+}
+
+
+// DataSaver side, encoding begin/end records into json text against binary stream.
+// Items are begin/end pairs, reported size is per pair.
+YAGET_PERF(Trace_Save)
+{
+    using namespace yaget;
+    using Event = metrics::TraceRecord::Event;
+
+    const metrics::TraceNameId name = metrics::InternTraceName("Perf.Trace.Save");
+    const metrics::TraceNameId category = metrics::InternTraceName("Channel");
+
+    std::size_t jsonSize = 0;
+    perf::Measure("Json text", kNumPairs, [name, category, &jsonSize]()
+    {
+        std::ostringstream output;
+        time::TimeUnits_t start = 1000000000;
+        for (std::size_t i = 0; i < kNumPairs; ++i, start += 25)
+        {
+            metrics::trace::WriteJsonRecord(output, { name, {}, start, start, 12345, Event::Begin, 0, category }, "Perf.Trace.Save", "Channel");
+            metrics::trace::WriteJsonRecord(output, { name, {}, start + 10, start + 10, 12345, Event::End, 0, category }, "Perf.Trace.Save", "Channel");
+        }
+
+        jsonSize = output.tellp();
+    });
+
+    std::size_t binarySize = 0;
+    perf::Measure("Binary stream", kNumPairs, [name, category, &binarySize]()
+    {
+        std::ostringstream output(std::ios::out | std::ios::binary);
+        metrics::trace::BinaryWriter writer(output, "Perf", "");
+        time::TimeUnits_t start = 1000000000;
+        for (std::size_t i = 0; i < kNumPairs; ++i, start += 25)
+        {
+            writer.AddRecord({ name, {}, start, start, 12345, Event::Begin, 0, category });
+            writer.AddRecord({ name, {}, start + 10, start + 10, 12345, Event::End, 0, category });
+        }
+        writer.Flush();
+
+        binarySize = writer.NumBytesWritten();
+    });
+
+    YLOG_DEBUG("PROF", "Bytes per begin/end pair, json: '%d', binary: '%d'.", jsonSize / kNumPairs, binarySize / kNumPairs);
+}
@@ -0,0 +1,154 @@
+#include "PerfHarness.h"
+#include "ThreadModel/Variables.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    constexpr std::size_t kNumThreads = 4;
+    constexpr std::size_t kOpsPerThread = 20'000;
+    constexpr std::size_t kNumFiles = 64;
+
+    // small trivially copyable value, same size as math::Box
+    struct PerfBounds
+    {
+        float mMin[3] = {};
+        float mMax[3] = {};
+    };
+
+    // list of watched files, long enough names that every copy allocates
+    yaget::Strings MakeFiles()
+    {
+        yaget::Strings files;
+        for (std::size_t i = 0; i < kNumFiles; ++i)
+        {
+            files.push_back(fmt::format("$(Data)/Textures/Terrain/chunk_{:04}.dds", i));
+        }
+
+        return files;
+    }
+
+    // each thread does kOpsPerThread operations where one of every readsPerWrite is write,
+    // read returns value which is accumulated, so compiler can not drop it
+    template <typename R, typename W>
+    void RunRatio(const std::string& label, std::size_t readsPerWrite, R read, W write)
+    {
+        using namespace yaget;
+
+        std::atomic<std::size_t> accumulator{ 0 };
+        perf::Measure(fmt::format("{} {}:1 reads/writes", label, readsPerWrite), kNumThreads * kOpsPerThread, [&read, &write, &accumulator, readsPerWrite]()
+        {
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t < kNumThreads; ++t)
+            {
+                threads.emplace_back([&read, &write, &accumulator, readsPerWrite, t]()
+                {
+                    std::size_t sum = 0;
+                    for (std::size_t i = 0; i < kOpsPerThread; ++i)
+                    {
+                        if ((i + t * 7) % readsPerWrite == 0)
+                        {
+                            write(i);
+                        }
+                        else
+                        {
+                            sum += read();
+                        }
+                    }
+
+                    accumulator.fetch_add(sum, std::memory_order_relaxed);
+                });
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        });
+
+        YLOG_DEBUG("PROF", "Accumulator: %d", accumulator.load());
+    }
+
+    constexpr std::size_t kRatios[] = { 1000, 100, 10, 1 };
+
+} // namespace
+
+
+// Strings list read by many threads (io::Watcher::GetWatchedFiles), writes change one entry
+YAGET_PERF(Variables_Strings)
+{
+    using namespace yaget;
+
+    const Strings files = MakeFiles();
+
+    for (std::size_t ratio : kRatios)
+    {
+        mt::Variable<Strings> variable(files);
+        RunRatio("Variable<Strings>", ratio, [&variable]()
+        {
+            const Strings value = variable;
+            return value.size();
+        }, [&variable](std::size_t i)
+        {
+            auto locker = variable.GetLocker();
+            locker.mDataValue[i % kNumFiles].back() = static_cast<char>('a' + i % 26);
+        });
+
+        mt::SharedVariable<Strings> sharedVariable(files);
+        RunRatio("SharedVariable<Strings>", ratio, [&sharedVariable]()
+        {
+            return sharedVariable.Get()->size();
+        }, [&sharedVariable](std::size_t i)
+        {
+            sharedVariable.Update([i](Strings& value) { value[i % kNumFiles].back() = static_cast<char>('a' + i % 26); });
+        });
+    }
+}
+
+
+// small value read every frame (bounds, settings), writes replace whole value
+YAGET_PERF(Variables_Trivial)
+{
+    using namespace yaget;
+
+    auto makeBounds = [](std::size_t i)
+    {
+        PerfBounds bounds;
+        bounds.mMax[0] = static_cast<float>(i);
+        return bounds;
+    };
+
+    for (std::size_t ratio : kRatios)
+    {
+        mt::Variable<PerfBounds> variable;
+        RunRatio("Variable<Bounds>", ratio, [&variable]()
+        {
+            const PerfBounds value = variable;
+            return static_cast<std::size_t>(value.mMax[0]);
+        }, [&variable, &makeBounds](std::size_t i)
+        {
+            variable = makeBounds(i);
+        });
+
+        mt::SharedVariable<PerfBounds> sharedVariable;
+        RunRatio("SharedVariable<Bounds>", ratio, [&sharedVariable]()
+        {
+            return static_cast<std::size_t>(sharedVariable.Get()->mMax[0]);
+        }, [&sharedVariable, &makeBounds](std::size_t i)
+        {
+            sharedVariable = makeBounds(i);
+        });
+
+        mt::SeqLockVariable<PerfBounds> seqLockVariable;
+        RunRatio("SeqLockVariable<Bounds>", ratio, [&seqLockVariable]()
+        {
+            const PerfBounds value = seqLockVariable;
+            return static_cast<std::size_t>(value.mMax[0]);
+        }, [&seqLockVariable, &makeBounds](std::size_t i)
+        {
+            seqLockVariable = makeBounds(i);
+        });
+    }
+}
@@ -0,0 +1,149 @@
+#include "PerfHarness.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif // _MSC_VER
+
+
+namespace
+{
+    std::atomic<std::size_t> AllocationCounter{ 0 };
+
+} // namespace
+
+
+//-------------------------------------------------------------------------------------------------
+// Counting of heap allocations. Only this executable replaces global new/delete.
+void* operator new(std::size_t size)
+{
+    AllocationCounter.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+// aligned overloads are used for over aligned types (chunk storage, cache line padded counters)
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    AllocationCounter.fetch_add(1, std::memory_order_relaxed);
+
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    const std::size_t alignedSize = (size ? size + align - 1 : align) / align * align;
+#if defined(_MSC_VER)
+    if (void* memory = _aligned_malloc(alignedSize, align))
+#else
+    if (void* memory = std::aligned_alloc(align, alignedSize))
+#endif // _MSC_VER
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+#if defined(_MSC_VER)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif // _MSC_VER
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept
+{
+    ::operator delete(memory, alignment);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(memory, alignment);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(memory, alignment);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+std::size_t yaget::perf::GetAllocationCount()
+{
+    return AllocationCounter.load(std::memory_order_relaxed);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::perf::Report(const Stats& stats)
+{
+    const std::string message = fmt::format("{:<48} {:>14.0f} items/sec, {:>10.1f} ns/item, {:>10.2f} allocs/run, runs: {}", stats.mName, stats.ItemsPerSecond(), stats.NanosecondsPerItem(), stats.AllocationsPerRun(), stats.mNumRuns);
+
+    std::cout << message << std::endl;
+    YLOG_NOTICE("PROF", "%s", message.c_str());
+}
+
+
+//-------------------------------------------------------------------------------------------------
+yaget::perf::Registry& yaget::perf::Registry::Get()
+{
+    static Registry registry;
+    return registry;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int yaget::perf::Registry::Add(const char* name, Benchmark benchmark)
+{
+    mBenchmarks.emplace_back(name, std::move(benchmark));
+    return static_cast<int>(mBenchmarks.size());
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void yaget::perf::Registry::Run(const std::string& filter) const
+{
+    for (const auto& [name, benchmark] : mBenchmarks)
+    {
+        if (filter.empty() || name.find(filter) != std::string::npos)
+        {
+            std::cout << "--- " << name << " ---" << std::endl;
+            benchmark();
+        }
+    }
+}
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////
+// PerfHarness.h
+//
+//  Copyright 10/17/2026 Edgar Glowacki
+//
+//  Maintained by: Edgar
+//
+//  NOTES:
+//      Minimal benchmark registration and reporting for YagetCore-Perf.
+//      Each perf file declares benchmarks with YAGET_PERF(Name) { ... }
+//      and uses perf::Measure to time a block of work.
+//      Heap allocations are counted trough global operator new replacement
+//      done in PerfHarness.cpp, which only lives in this executable.
+//
+//  #include "PerfHarness.h"
+//
+//////////////////////////////////////////////////////////////////////
+//! \file
+#pragma once
+
+#include "YagetCore.h"
+#include <chrono>
+#include <functional>
+
+
+namespace yaget::perf
+{
+    struct Stats
+    {
+        std::string mName;
+        std::size_t mNumRuns = 0;           // how many times block was executed
+        std::size_t mItemsPerRun = 0;       // how many items (iterations) one run processes
+        double mSeconds = 0.0;              // total time for all runs
+        std::size_t mAllocations = 0;       // total number of heap allocations for all runs
+
+        double ItemsPerSecond() const { return mSeconds > 0.0 ? (mNumRuns * mItemsPerRun) / mSeconds : 0.0; }
+        double NanosecondsPerItem() const { return mNumRuns * mItemsPerRun ? mSeconds * 1e9 / (mNumRuns * mItemsPerRun) : 0.0; }
+        double AllocationsPerRun() const { return mNumRuns ? static_cast<double>(mAllocations) / mNumRuns : 0.0; }
+    };
+
+    // Number of heap allocations done trough global operator new since start of this process
+    std::size_t GetAllocationCount();
+
+    // Print result to console and log
+    void Report(const Stats& stats);
+
+    // Run block repeatedly, at least minRuns times and until minDuration elapsed,
+    // where each call processes itemsPerRun items. Result is reported and returned.
+    template <typename F>
+    Stats Measure(const std::string& name, std::size_t itemsPerRun, F&& block, std::size_t minRuns = 3, std::chrono::milliseconds minDuration = std::chrono::milliseconds(500))
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // warm up caches and any lazy initialization
+        block();
+
+        Stats stats{ name, 0, itemsPerRun };
+        const std::size_t startAllocations = GetAllocationCount();
+        const auto start = Clock::now();
+        auto end = start;
+        while (stats.mNumRuns < minRuns || end - start < minDuration)
+        {
+            block();
+            ++stats.mNumRuns;
+            end = Clock::now();
+        }
+
+        stats.mAllocations = GetAllocationCount() - startAllocations;
+        stats.mSeconds = std::chrono::duration<double>(end - start).count();
+
+        Report(stats);
+        return stats;
+    }
+
+    using Benchmark = std::function<void()>;
+
+    class Registry : public Noncopyable<Registry>
+    {
+    public:
+        static Registry& Get();
+
+        // Return number of benchmarks registered so far
+        int Add(const char* name, Benchmark benchmark);
+
+        // Execute all benchmarks, if filter is not empty only ones which name contains filter
+        void Run(const std::string& filter) const;
+
+    private:
+        Registry() = default;
+
+        std::vector<std::pair<std::string, Benchmark>> mBenchmarks;
+    };
+
+} // namespace yaget::perf
+
+#define YAGET_PERF(name) \
+    static void name##_Perf(); \
+    static const int name##_PerfRegistered = yaget::perf::Registry::Get().Add(#name, &name##_Perf); \
+    static void name##_Perf()
@@ -2,6 +2,7 @@
 //
 
 #include "YagetCore.h"
+#include "PerfHarness.h"
 #include <iostream>
 
 
@@ -22,10 +23,13 @@ namespace yaget::ylog
 YAGET_BRAND_NAME_F("Beyond Limits")
 
 
-int main()
+// optional first argument will only run benchmarks which name contains it
+int main(int argc, char* argv[])
 {
     using namespace yaget;
 
     /*auto result =*/ system::InitializeSetup();
-    //std::cout << "Hello World!\n";
+
+    const std::string filter = argc > 1 ? argv[1] : "";
+    perf::Registry::Get().Run(filter);
 }
@@ -138,10 +138,11 @@ namespace json_blocks
         "VTSSections": 1,
         "VTS": 2,
         "Blob": 3,
-        "App": 4
+        "App": 4,
+        "Systems": 5
     })"_json;
 
-    const Configuration::Debug::Threads expectedThreads = { 1, 2, 3, 4 };
+    const Configuration::Debug::Threads expectedThreads = { 1, 2, 3, 4, 5 };
 
     //------------------------------------------------------------------------------------------------------------------------------------------------------
     const nlohmann::json metrics = R"({
@@ -149,10 +150,11 @@ namespace json_blocks
         "AllowFallbackToFile": true,
         "SocketConnectionTimeout": -1,
         "TraceFileName": "FooFileName",
-        "TraceOn": false
+        "TraceOn": false,
+        "TraceFormat": "Binary"
     })"_json;
 
-    const Configuration::Debug::Metrics expectedMetrics = { true, true, -1, "FooFileName", false };
+    const Configuration::Debug::Metrics expectedMetrics = { true, true, -1, "FooFileName", false, "Binary" };
 
     //------------------------------------------------------------------------------------------------------------------------------------------------------
     const nlohmann::json debug =
@@ -46,7 +46,14 @@ namespace TestObjects
 
     using EntityCoordinator = yaget::comp::Coordinator<Entity>;
 
-    using EntityCoordinatorSet = yaget::comp::CoordinatorSet<EntityCoordinator>;
+    // chunked components remember id of their item, so batch system can check that columns line up with ids
+    struct Pcomponent { Pcomponent(yaget::comp::Id_t id) : mId(id) {} yaget::comp::Id_t mId = 0; float mValue = 0.0f; };
+    struct Vcomponent { Vcomponent(yaget::comp::Id_t id) : mId(id) {} yaget::comp::Id_t mId = 0; float mValue = 1.0f; };
+
+    using ChunkedEntity = yaget::comp::ChunkedRowPolicy<Pcomponent*, Vcomponent*>;
+    using ChunkedEntityCoordinator = yaget::comp::Coordinator<ChunkedEntity>;
+
+    using EntityCoordinatorSet = yaget::comp::CoordinatorSet<EntityCoordinator, ChunkedEntityCoordinator>;
 
     class ABCD_EntitySystem : public yaget::comp::gs::GameSystem<EntityCoordinatorSet, yaget::comp::gs::NoEndMarker, Messaging, Acomponent*, Bcomponent*, Ccomponent*, Dcomponent*>
     {
@@ -115,9 +122,119 @@ namespace TestObjects
         }
     };
 
+    // runs on job pool, in chunks of 2 rows
+    class AParallel_EntitySystem : public yaget::comp::gs::GameSystem<EntityCoordinatorSet, yaget::comp::gs::Parallel<yaget::comp::gs::GenerateEndMarker, 2>, Messaging, Acomponent*>
+    {
+    public:
+        AParallel_EntitySystem(Messaging& messaging, yaget::Application& app, EntityCoordinatorSet& coordinatorSet)
+            : GameSystem("AParallel_EntitySystem", messaging, app, [this](auto&&... params) {OnUpdate(params...); }, coordinatorSet)
+        { }
+
+        std::atomic<int> mEntityCounter = 0;
+        int mEntityCounterAtEndMarker = -1;
+
+    private:
+        void OnUpdate(yaget::comp::Id_t id, const yaget::time::GameClock& /*gameClock*/, yaget::metrics::Channel& /*channel*/, Acomponent* aComponent)
+        {
+            if (id == yaget::comp::END_ID_MARKER)
+            {
+                mEntityCounterAtEndMarker = mEntityCounter;
+                return;
+            }
+
+            aComponent->mDummy++;
+            mEntityCounter++;
+        }
+    };
+
+    // read only systems, which can run at the same time as each other
+    template <typename... Comps>
+    class ReadOnly_EntitySystem : public yaget::comp::gs::GameSystem<EntityCoordinatorSet, yaget::comp::gs::NoEndMarker, Messaging, Comps...>
+    {
+    public:
+        using ConcurrentSafe = bool;
+
+        ReadOnly_EntitySystem(Messaging& messaging, yaget::Application& app, EntityCoordinatorSet& coordinatorSet)
+            : yaget::comp::gs::GameSystem<EntityCoordinatorSet, yaget::comp::gs::NoEndMarker, Messaging, Comps...>("ReadOnly_EntitySystem", messaging, app, [this](auto&&... /*params*/) { mEntityCounter++; }, coordinatorSet)
+        { }
+
+        std::atomic<int> mEntityCounter = 0;
+    };
+
+    using ReadA_EntitySystem = ReadOnly_EntitySystem<const Acomponent*>;
+    using ReadAC_EntitySystem = ReadOnly_EntitySystem<const Acomponent*, const Ccomponent*>;
+
+    // read only system which fails on every row, runs on job pool next to ReadA_EntitySystem
+    class ThrowA_EntitySystem : public yaget::comp::gs::GameSystem<EntityCoordinatorSet, yaget::comp::gs::NoEndMarker, Messaging, const Acomponent*>
+    {
+    public:
+        using ConcurrentSafe = bool;
+
+        ThrowA_EntitySystem(Messaging& messaging, yaget::Application& app, EntityCoordinatorSet& coordinatorSet)
+            : GameSystem("ThrowA_EntitySystem", messaging, app, [](auto&&... /*params*/) { throw std::runtime_error("ThrowA_EntitySystem failed"); }, coordinatorSet)
+        { }
+    };
+
+    // system called directly per row, without std::function
+    class StaticAC_EntitySystem : public yaget::comp::gs::StaticGameSystem<StaticAC_EntitySystem, EntityCoordinatorSet, yaget::comp::gs::GenerateEndMarker, Messaging, Acomponent*, const Ccomponent*>
+    {
+    public:
+        StaticAC_EntitySystem(Messaging& messaging, yaget::Application& app, EntityCoordinatorSet& coordinatorSet)
+            : StaticGameSystem("StaticAC_EntitySystem", messaging, app, coordinatorSet)
+        { }
+
+        void OnUpdate(yaget::comp::Id_t id, const yaget::time::GameClock& /*gameClock*/, yaget::metrics::Channel& /*channel*/, Acomponent* acomponent, const Ccomponent* ccomponent)
+        {
+            if (id == yaget::comp::END_ID_MARKER)
+            {
+                mEntityCounterAtEndMarker = mEntityCounter;
+                return;
+            }
+
+            acomponent->mDummy += ccomponent->mText.size();
+            mEntityCounter++;
+        }
+
+        int mEntityCounter = 0;
+        int mEntityCounterAtEndMarker = 0;
+    };
+
+    // system called with columns of chunked components, split into batches of 2 rows
+    class BatchPV_EntitySystem : public yaget::comp::gs::StaticGameSystem<BatchPV_EntitySystem, EntityCoordinatorSet, yaget::comp::gs::Parallel<yaget::comp::gs::NoEndMarker, 2>, Messaging, Pcomponent*, const Vcomponent*>
+    {
+    public:
+        BatchPV_EntitySystem(Messaging& messaging, yaget::Application& app, EntityCoordinatorSet& coordinatorSet)
+            : StaticGameSystem("BatchPV_EntitySystem", messaging, app, coordinatorSet)
+        { }
+
+        void OnUpdateBatch(std::span<const yaget::comp::Id_t> ids, const yaget::time::GameClock& /*gameClock*/, yaget::metrics::Channel& /*channel*/, std::span<Pcomponent> pcomponents, std::span<const Vcomponent> vcomponents)
+        {
+            if (ids.size() != pcomponents.size() || ids.size() != vcomponents.size())
+            {
+                mMismatchCounter++;
+                return;
+            }
+
+            for (std::size_t i = 0; i < ids.size(); ++i)
+            {
+                if (pcomponents[i].mId != ids[i] || vcomponents[i].mId != ids[i])
+                {
+                    mMismatchCounter++;
+                }
+
+                pcomponents[i].mValue += vcomponents[i].mValue;
+            }
+
+            mEntityCounter += static_cast<int>(ids.size());
+        }
+
+        std::atomic<int> mEntityCounter = 0;
+        std::atomic<int> mMismatchCounter = 0;
+    };
+
     namespace internal
     {
-        using SystemsCoordinatorE = yaget::comp::gs::SystemsCoordinator<EntityCoordinatorSet, Messaging, yaget::Application, ABCD_EntitySystem, AC_EntitySystem, A_EntitySystem>;
+        using SystemsCoordinatorE = yaget::comp::gs::SystemsCoordinator<EntityCoordinatorSet, Messaging, yaget::Application, ABCD_EntitySystem, AC_EntitySystem, A_EntitySystem, AParallel_EntitySystem, ReadA_EntitySystem, ReadAC_EntitySystem, StaticAC_EntitySystem, BatchPV_EntitySystem>;
     }
 
     class EntitySystemsCoordinator : public internal::SystemsCoordinatorE
@@ -131,6 +248,8 @@ namespace TestObjects
         { }
     };
 
+    using SystemsCoordinatorThrow = yaget::comp::gs::SystemsCoordinator<EntityCoordinatorSet, Messaging, yaget::Application, ReadA_EntitySystem, ThrowA_EntitySystem, A_EntitySystem>;
+
     using SystemsCoordinatorCapacity = yaget::comp::gs::SystemsCoordinator<EntityCoordinatorSet, Messaging, yaget::Application/*, ABCD_EntitySystem, AC_EntitySystem*/, A_EntitySystem>;
 
 
@@ -206,6 +325,286 @@ TEST_F(CoordinatorSet, CoordinatorSet2)
 }
 
 
+TEST_F(CoordinatorSet, QueryCache)
+{
+    using namespace yaget;
+
+    IdGameCache idGameCache(nullptr);
+    TestObjects::KnightEntityCoordinatorSet knightEntities(nullptr);
+
+    auto& coordinatorABCD = knightEntities.GetCoordinator<TestObjects::BaseEntity>();
+    auto& coordinatorEF = knightEntities.GetCoordinator<TestObjects::BuffedEntity>();
+    auto& coordinatorG = knightEntities.GetCoordinator<TestObjects::GlobalEntity>();
+
+    using RequestedRow = std::tuple<TestObjects::Acomponent*, TestObjects::Gcomponent*>;
+
+    auto collectIds = [&knightEntities]()
+    {
+        std::vector<comp::Id_t> ids;
+        knightEntities.ForEach<RequestedRow>([&ids](comp::Id_t id, const RequestedRow& row)
+        {
+            EXPECT_TRUE(std::get<TestObjects::Gcomponent*>(row) != nullptr);
+            ids.push_back(id);
+            return true;
+        });
+
+        return ids;
+    };
+
+    const comp::Id_t globalId = idspace::get_burnable(idGameCache);
+    coordinatorG.AddComponent<TestObjects::Gcomponent>(globalId);
+
+    // with no regular items, global one is returned by itself
+    EXPECT_EQ(collectIds(), std::vector<comp::Id_t>{ globalId });
+
+    std::vector<comp::Id_t> itemIds;
+    for (int i = 0; i < 5; ++i)
+    {
+        const comp::Id_t itemId = idspace::get_burnable(idGameCache);
+        coordinatorABCD.AddComponent<TestObjects::Acomponent>(itemId);
+        itemIds.push_back(itemId);
+    }
+
+    EXPECT_EQ(collectIds(), itemIds);
+
+    // incremental updates, rows are kept sorted by id
+    coordinatorABCD.RemoveComponent<TestObjects::Acomponent>(itemIds[2]);
+    coordinatorEF.AddComponent<TestObjects::Ecomponent>(itemIds[3]);
+    itemIds.erase(itemIds.begin() + 2);
+    EXPECT_EQ(collectIds(), itemIds);
+
+    const comp::Id_t lateId = idspace::get_burnable(idGameCache);
+    coordinatorABCD.AddComponent<TestObjects::Acomponent>(lateId);
+    itemIds.push_back(lateId);
+    EXPECT_EQ(collectIds(), itemIds);
+
+    // changes done from callback are visible on next ForEach
+    std::size_t numProcessed = knightEntities.ForEach<RequestedRow>([&coordinatorABCD, &itemIds](comp::Id_t id, const RequestedRow& /*row*/)
+    {
+        if (id == itemIds.front())
+        {
+            coordinatorABCD.RemoveComponent<TestObjects::Acomponent>(id);
+        }
+        return true;
+    });
+    EXPECT_EQ(numProcessed, itemIds.size());
+    itemIds.erase(itemIds.begin());
+    EXPECT_EQ(collectIds(), itemIds);
+
+    // more changes then cached rows, cache is rebuilt instead of updated
+    for (int i = 0; i < 20; ++i)
+    {
+        const comp::Id_t itemId = idspace::get_burnable(idGameCache);
+        coordinatorABCD.AddComponent<TestObjects::Acomponent>(itemId);
+        itemIds.push_back(itemId);
+    }
+    EXPECT_EQ(collectIds(), itemIds);
+
+    for (const auto& itemId : itemIds)
+    {
+        coordinatorABCD.RemoveComponents(itemId);
+    }
+    coordinatorEF.RemoveComponents(itemIds[1]);
+    coordinatorG.RemoveComponents(globalId);
+
+    EXPECT_TRUE(collectIds().empty());
+}
+
+
+TEST_F(CoordinatorSet, NestedQuery)
+{
+    using namespace yaget;
+
+    IdGameCache idGameCache(nullptr);
+    TestObjects::EntityCoordinatorSet entities(nullptr);
+
+    std::vector<comp::Id_t> itemIds;
+    for (int i = 0; i < 4; ++i)
+    {
+        const comp::Id_t itemId = idspace::get_burnable(idGameCache);
+        entities.AddComponent<TestObjects::Acomponent>(itemId);
+        itemIds.push_back(itemId);
+    }
+
+    using RowA = std::tuple<TestObjects::Acomponent*>;
+    EXPECT_EQ(entities.ForEach<RowA>([](comp::Id_t, const RowA&) { return true; }), itemIds.size());
+
+    // ForEach from callback sees component removed by outer one, while outer keeps iterating it's own rows
+    const std::vector<comp::Id_t> remainingIds(itemIds.begin(), itemIds.end() - 1);
+    std::size_t numProcessed = entities.ForEach<RowA>([&entities, &itemIds, &remainingIds](comp::Id_t id, const RowA& /*row*/)
+    {
+        if (id == itemIds.front())
+        {
+            entities.RemoveComponent<TestObjects::Acomponent>(itemIds.back());
+
+            std::vector<comp::Id_t> nestedIds;
+            entities.ForEach<RowA>([&nestedIds](comp::Id_t nestedId, const RowA& row)
+            {
+                EXPECT_EQ(std::get<TestObjects::Acomponent*>(row)->mText, "Acomponent");
+                nestedIds.push_back(nestedId);
+                return true;
+            });
+            EXPECT_EQ(nestedIds, remainingIds);
+        }
+
+        // outer rows still have removed item
+        return id != remainingIds.back();
+    });
+    EXPECT_EQ(numProcessed, remainingIds.size() - 1);
+    EXPECT_EQ(entities.ForEach<RowA>([](comp::Id_t, const RowA&) { return true; }), remainingIds.size());
+
+    entities.RemoveItems(comp::ItemIds(remainingIds.begin(), remainingIds.end()));
+}
+
+
+TEST_F(CoordinatorSet, AddItems)
+{
+    using namespace yaget;
+
+    IdGameCache idGameCache(nullptr);
+    TestObjects::KnightEntityCoordinatorSet knightEntities(nullptr);
+
+    comp::ItemIds itemIds;
+    for (int i = 0; i < 10; ++i)
+    {
+        itemIds.insert(idspace::get_burnable(idGameCache));
+    }
+
+    // all components in one coordinator, initializer is passed to it
+    using RowBA = comp::RowPolicy<TestObjects::Bcomponent*, TestObjects::Acomponent*>;
+    comp::ItemIds initializedIds;
+    knightEntities.AddItems<RowBA>(itemIds, [&initializedIds](comp::Id_t id, const RowBA::Row& row)
+    {
+        std::get<TestObjects::Acomponent*>(row)->mDummy = id;
+        std::get<TestObjects::Bcomponent*>(row)->mDummy = id;
+        initializedIds.insert(id);
+    });
+    EXPECT_EQ(initializedIds, itemIds);
+
+    // components from two coordinators, initializer gets complete row
+    using RowCE = comp::RowPolicy<TestObjects::Ccomponent*, TestObjects::Ecomponent*>;
+    initializedIds.clear();
+    knightEntities.AddItems<RowCE>(itemIds, [&initializedIds](comp::Id_t id, const RowCE::Row& row)
+    {
+        EXPECT_NE(std::get<TestObjects::Ccomponent*>(row), nullptr);
+        EXPECT_NE(std::get<TestObjects::Ecomponent*>(row), nullptr);
+        initializedIds.insert(id);
+    });
+    EXPECT_EQ(initializedIds, itemIds);
+
+    using RowABCE = std::tuple<TestObjects::Acomponent*, TestObjects::Bcomponent*, TestObjects::Ccomponent*, TestObjects::Ecomponent*>;
+    EXPECT_EQ(knightEntities.ForEach<RowABCE>([](comp::Id_t id, const RowABCE& row)
+    {
+        EXPECT_EQ(std::get<TestObjects::Acomponent*>(row)->mDummy, id);
+        EXPECT_EQ(std::get<TestObjects::Bcomponent*>(row)->mDummy, id);
+        return true;
+    }), itemIds.size());
+
+    knightEntities.RemoveItems(itemIds);
+}
+
+
+TEST_F(CoordinatorSet, CommandBuffer)
+{
+    using namespace yaget;
+
+    IdGameCache idGameCache(nullptr);
+    TestObjects::EntityCoordinatorSet entities(nullptr);
+
+    comp::ItemIds itemIds;
+    for (int i = 0; i < 6; ++i)
+    {
+        const comp::Id_t itemId = idspace::get_burnable(idGameCache);
+        entities.AddComponent<TestObjects::Acomponent>(itemId);
+        itemIds.insert(itemId);
+    }
+
+    using RowA = std::tuple<TestObjects::Acomponent*>;
+    using RowAB = std::tuple<TestObjects::Acomponent*, TestObjects::Bcomponent*>;
+
+    // changes are only recorded while iterating
+    auto& commands = entities.Commands();
+    std::size_t numProcessed = entities.ForEach<RowA>([&commands](comp::Id_t id, const RowA& /*row*/)
+    {
+        commands.AddComponent<TestObjects::Bcomponent>(id, std::string("Recorded"));
+        commands.RemoveComponent<TestObjects::Acomponent>(id);
+        commands.AddComponent<TestObjects::Acomponent>(id);
+        return true;
+    });
+    EXPECT_EQ(numProcessed, itemIds.size());
+    EXPECT_EQ(commands.Size(), itemIds.size() * 3);
+    EXPECT_EQ(entities.ForEach<RowAB>([](comp::Id_t, const RowAB&) { return true; }), 0u);
+
+    EXPECT_EQ(entities.PlaybackCommands(), itemIds.size() * 3);
+    EXPECT_TRUE(commands.IsEmpty());
+    EXPECT_EQ(entities.ForEach<RowAB>([](comp::Id_t id, const RowAB& row)
+    {
+        // recorded parameters are passed to component constructor, after id
+        EXPECT_EQ(std::get<1>(row)->mDummy, id);
+        EXPECT_EQ(std::get<1>(row)->mText, "Recorded");
+        return true;
+    }), itemIds.size());
+
+    // played back buffers are recycled for any thread, instead of one kept for every thread that ever recorded
+    const TestObjects::EntityCoordinatorSet::CommandBuffer* threadCommands = nullptr;
+    std::thread([&entities, &itemIds, &threadCommands]()
+    {
+        threadCommands = &entities.Commands();
+        entities.Commands().RemoveItems(itemIds);
+    }).join();
+    EXPECT_EQ(entities.ForEach<RowA>([](comp::Id_t, const RowA&) { return true; }), itemIds.size());
+
+    EXPECT_EQ(entities.PlaybackCommands(), 1u);
+    EXPECT_EQ(entities.ForEach<RowA>([](comp::Id_t, const RowA&) { return true; }), 0u);
+
+    std::thread([&entities, &threadCommands]()
+    {
+        EXPECT_EQ(&entities.Commands(), threadCommands);
+    }).join();
+    EXPECT_EQ(entities.PlaybackCommands(), 0u);
+}
+
+
+TEST_F(CoordinatorSet, CommandBufferException)
+{
+    using namespace yaget;
+
+    IdGameCache idGameCache(nullptr);
+    TestObjects::EntityCoordinatorSet entities(nullptr);
+
+    std::vector<comp::Id_t> itemIds;
+    for (int i = 0; i < 3; ++i)
+    {
+        const comp::Id_t itemId = idspace::get_burnable(idGameCache);
+        entities.AddComponent<TestObjects::Acomponent>(itemId);
+        itemIds.push_back(itemId);
+    }
+
+    using RowAB = std::tuple<TestObjects::Acomponent*, TestObjects::Bcomponent*>;
+    auto countAB = [&entities]() { return entities.ForEach<RowAB>([](comp::Id_t, const RowAB&) { return true; }); };
+
+    // second command adds component item already has and throws, third one is dropped
+    auto& commands = entities.Commands();
+    commands.AddComponent<TestObjects::Bcomponent>(itemIds[0]);
+    commands.AddComponent<TestObjects::Acomponent>(itemIds[1]);
+    commands.AddComponent<TestObjects::Bcomponent>(itemIds[2]);
+    EXPECT_ANY_THROW(entities.PlaybackCommands());
+
+    // change applied before failure is visible to queries
+    EXPECT_EQ(countAB(), 1u);
+
+    // next playback starts clean with recycled buffer
+    auto& nextCommands = entities.Commands();
+    EXPECT_EQ(&nextCommands, &commands);
+    EXPECT_TRUE(nextCommands.IsEmpty());
+    nextCommands.AddComponent<TestObjects::Bcomponent>(itemIds[1]);
+    EXPECT_EQ(entities.PlaybackCommands(), 1u);
+    EXPECT_EQ(countAB(), 2u);
+
+    entities.RemoveItems(comp::ItemIds(itemIds.begin(), itemIds.end()));
+}
+
+
 TEST_F(CoordinatorSet, ComponentAccess)
 {
     using namespace yaget;
@@ -278,6 +677,21 @@ TEST_F(CoordinatorSet, ComponentAccess)
     entityCoordinator.AddComponent<TestObjects::Acomponent>(itemId);
     entityCoordinator.AddComponent<TestObjects::Ccomponent>(itemId);
 
+    // chunked items, 5 with both P and V, one with only P and one with only V
+    auto& chunkedCoordinator = entitySystemsCoordinator.GetCoordinator<TestObjects::ChunkedEntity>();
+    for (int i = 0; i < 7; ++i)
+    {
+        itemId = idspace::get_burnable(idGameCache);
+        if (i != 6)
+        {
+            chunkedCoordinator.AddComponent<TestObjects::Pcomponent>(itemId);
+        }
+        if (i != 5)
+        {
+            chunkedCoordinator.AddComponent<TestObjects::Vcomponent>(itemId);
+        }
+    }
+
     time::GameClock gameClock;
     metrics::Channel channel("Test");
 
@@ -291,6 +705,85 @@ TEST_F(CoordinatorSet, ComponentAccess)
 
     const auto& systemA = entitySystemsCoordinator.GetSystem<TestObjects::A_EntitySystem>();
     EXPECT_EQ(7, systemA.mEntityCounter);
+
+    // all rows are done before end marker is called
+    const auto& systemAParallel = entitySystemsCoordinator.GetSystem<TestObjects::AParallel_EntitySystem>();
+    EXPECT_EQ(7, systemAParallel.mEntityCounter);
+    EXPECT_EQ(7, systemAParallel.mEntityCounterAtEndMarker);
+
+    const auto& systemReadA = entitySystemsCoordinator.GetSystem<TestObjects::ReadA_EntitySystem>();
+    EXPECT_EQ(7, systemReadA.mEntityCounter);
+
+    const auto& systemReadAC = entitySystemsCoordinator.GetSystem<TestObjects::ReadAC_EntitySystem>();
+    EXPECT_EQ(4, systemReadAC.mEntityCounter);
+
+    const auto& systemStaticAC = entitySystemsCoordinator.GetSystem<TestObjects::StaticAC_EntitySystem>();
+    EXPECT_EQ(4, systemStaticAC.mEntityCounter);
+    EXPECT_EQ(4, systemStaticAC.mEntityCounterAtEndMarker);
+
+    // every column entry belongs to the same item as ids entry at that index
+    const auto& systemBatchPV = entitySystemsCoordinator.GetSystem<TestObjects::BatchPV_EntitySystem>();
+    EXPECT_EQ(5, systemBatchPV.mEntityCounter);
+    EXPECT_EQ(0, systemBatchPV.mMismatchCounter);
+
+    int numUpdated = 0;
+    chunkedCoordinator.ForEach<comp::RowPolicy<TestObjects::Pcomponent*>>([&numUpdated](comp::Id_t id, const auto& row)
+    {
+        const TestObjects::Pcomponent* pcomponent = std::get<0>(row);
+        EXPECT_EQ(id, pcomponent->mId);
+        numUpdated += pcomponent->mValue == 1.0f ? 1 : 0;
+        return true;
+    });
+    EXPECT_EQ(5, numUpdated);
+}
+
+
+TEST_F(CoordinatorSet, SystemsGraph)
+{
+    using namespace yaget;
+
+    using Systems = std::tuple<TestObjects::A_EntitySystem, TestObjects::ReadA_EntitySystem, TestObjects::ReadAC_EntitySystem, TestObjects::AParallel_EntitySystem>;
+    using Graph = comp::gs::internal::SystemsGraph<Systems>;
+
+    // systems not marked as ConcurrentSafe conflict with everyone
+    EXPECT_TRUE(Graph::Dependencies[1][0]);
+    EXPECT_TRUE(Graph::Dependencies[3][2]);
+
+    // both only read Acomponent
+    EXPECT_FALSE(Graph::Dependencies[2][1]);
+    EXPECT_EQ(Graph::NumDependencies[2], 1);
+
+    EXPECT_FALSE(Graph::Concurrent[0]);
+    EXPECT_TRUE(Graph::Concurrent[1]);
+    EXPECT_TRUE(Graph::AnyConcurrent);
+}
+
+
+TEST_F(CoordinatorSet, SystemsException)
+{
+    using namespace yaget;
+
+    test::ApplicationFramework<TestObjects::Messaging, TestObjects::SystemsCoordinatorThrow> testerFramework("SystemsException");
+
+    auto& idGameCache = testerFramework.Ids();
+    auto& entitySystemsCoordinator = testerFramework.SystemsCoordinator();
+    auto& entityCoordinator = entitySystemsCoordinator.GetCoordinator<TestObjects::Entity>();
+
+    const comp::Id_t itemId = idspace::get_burnable(idGameCache);
+    entityCoordinator.AddComponent<TestObjects::Acomponent>(itemId);
+
+    time::GameClock gameClock;
+    metrics::Channel channel("Test");
+
+    // exception from system on job pool is rethrown by Tick, and system waiting on it is skipped
+    EXPECT_THROW(entitySystemsCoordinator.Tick(gameClock, channel), std::runtime_error);
+    EXPECT_EQ(entitySystemsCoordinator.GetSystem<TestObjects::A_EntitySystem>().mEntityCounter, 0);
+
+    // failed tick does not leave any state behind
+    EXPECT_THROW(entitySystemsCoordinator.Tick(gameClock, channel), std::runtime_error);
+    EXPECT_EQ(entitySystemsCoordinator.GetSystem<TestObjects::A_EntitySystem>().mEntityCounter, 0);
+
+    entityCoordinator.RemoveComponents(itemId);
 }
 
 
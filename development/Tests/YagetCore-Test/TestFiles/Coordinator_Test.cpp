@@ -47,6 +47,23 @@ public:
     static constexpr int Capacity = 4;
 };
 
+// chunked storage keeps components by value and moves them around, so they must be nothrow movable
+struct ChunkedLocation
+{
+    ChunkedLocation(yaget::comp::Id_t id) : mId(id), mName(fmt::format("Item {}", id))
+    {}
+
+    yaget::comp::Id_t mId = 0;
+    std::string mName;
+};
+
+struct ChunkedTag
+{
+    ChunkedTag() = default;
+
+    int mValue = 7;
+};
+
 
 //template <typename T, typename Tuple>
 //struct has_type;
@@ -367,3 +384,157 @@ TEST_F(Coordinator, Runtime)
     int z = 0;
     z;
 }
+
+
+TEST_F(Coordinator, Chunked)
+{
+    using namespace yaget;
+
+    using Entity = comp::ChunkedRowPolicy<ChunkedLocation*, ChunkedTag*>;
+    using EntityCoordinator = comp::Coordinator<Entity>;
+
+    using LocationEntity = comp::RowPolicy<ChunkedLocation*>;
+    using TagEntity = comp::RowPolicy<ChunkedLocation*, ChunkedTag*>;
+
+    EntityCoordinator coordinator;
+    IdGameCache idGameCache(nullptr);
+
+    // enough items to fill several chunks of each pattern
+    comp::ItemIds allIds;
+    comp::ItemIds tagIds;
+    for (int i = 0; i < 3000; ++i)
+    {
+        const comp::Id_t itemId = idspace::get_burnable(idGameCache);
+        allIds.insert(itemId);
+
+        coordinator.AddComponent<ChunkedLocation>(itemId);
+        if (i % 2)
+        {
+            coordinator.AddComponent<ChunkedTag>(itemId);
+            tagIds.insert(itemId);
+        }
+    }
+
+    EXPECT_EQ(coordinator.GetItemIds<LocationEntity>(), allIds);
+    EXPECT_EQ(coordinator.GetItemIds<TagEntity>(), tagIds);
+
+    // rows must point at components of the same item, and components which moved keep their values
+    auto verifyItems = [&coordinator]<typename R>(std::type_identity<R>, const comp::ItemIds& expectedIds)
+    {
+        comp::ItemIds visitedIds;
+        std::size_t numItems = coordinator.ForEachUnordered<R>([&coordinator, &visitedIds](comp::Id_t id, const typename R::Row& row)
+        {
+            const ChunkedLocation* location = std::get<ChunkedLocation*>(row);
+            EXPECT_EQ(location, coordinator.FindComponent<ChunkedLocation>(id));
+            EXPECT_EQ(location->mId, id);
+            EXPECT_EQ(location->mName, fmt::format("Item {}", id));
+            if constexpr (std::tuple_size_v<typename R::Row> > 1)
+            {
+                EXPECT_EQ(std::get<ChunkedTag*>(row), coordinator.FindComponent<ChunkedTag>(id));
+                EXPECT_EQ(std::get<ChunkedTag*>(row)->mValue, 7);
+            }
+
+            visitedIds.insert(id);
+            return true;
+        });
+
+        EXPECT_EQ(numItems, expectedIds.size());
+        EXPECT_EQ(visitedIds, expectedIds);
+    };
+
+    verifyItems(std::type_identity<TagEntity>{}, tagIds);
+    verifyItems(std::type_identity<LocationEntity>{}, allIds);
+
+    // removing component moves item to other pattern and last item of old pattern takes it's place
+    int index = 0;
+    for (auto it = tagIds.begin(); it != tagIds.end(); ++index)
+    {
+        if (index % 3 == 0)
+        {
+            EXPECT_TRUE(coordinator.RemoveComponent<ChunkedTag>(*it));
+            it = tagIds.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    verifyItems(std::type_identity<TagEntity>{}, tagIds);
+    verifyItems(std::type_identity<LocationEntity>{}, allIds);
+
+    // remove whole items from the front, which swaps items from the back of every chunk list
+    comp::ItemIds removedIds(allIds.begin(), std::next(allIds.begin(), 2000));
+    coordinator.RemoveItems(removedIds);
+    for (const auto& id : removedIds)
+    {
+        allIds.erase(id);
+        tagIds.erase(id);
+        EXPECT_EQ(coordinator.FindComponent<ChunkedLocation>(id), nullptr);
+    }
+
+    verifyItems(std::type_identity<TagEntity>{}, tagIds);
+    verifyItems(std::type_identity<LocationEntity>{}, allIds);
+    EXPECT_GT(coordinator.ReleaseMemory(), 0);
+    verifyItems(std::type_identity<LocationEntity>{}, allIds);
+
+    std::size_t numItems = coordinator.ForEachUnordered<LocationEntity>([](comp::Id_t /*id*/, const auto& /*row*/)
+    {
+        return false;
+    });
+    EXPECT_EQ(numItems, 1);
+
+    coordinator.RemoveItems(allIds);
+    EXPECT_TRUE(coordinator.GetItemIds<LocationEntity>().empty());
+}
+
+
+TEST_F(Coordinator, BulkItems)
+{
+    using namespace yaget;
+
+    using Entity = comp::RowPolicy<comp::LocationComponent*, DummyComp*, DummyComp2*>;
+    using EntityCoordinator = comp::Coordinator<Entity>;
+
+    EntityCoordinator coordinator;
+    IdGameCache idGameCache(nullptr);
+
+    comp::ItemIds allIds;
+    for (int i = 0; i < 100; ++i)
+    {
+        allIds.insert(idspace::get_burnable(idGameCache));
+    }
+
+    using LocationEntity = comp::RowPolicy<comp::LocationComponent*>;
+    using DummyEntity = comp::RowPolicy<comp::LocationComponent*, DummyComp*>;
+
+    comp::ItemIds initializedIds;
+    coordinator.AddItems<DummyEntity>(allIds, [&coordinator, &initializedIds](comp::Id_t id, const DummyEntity::Row& row)
+    {
+        EXPECT_EQ(std::get<comp::LocationComponent*>(row), coordinator.FindComponent<comp::LocationComponent>(id));
+        EXPECT_EQ(std::get<DummyComp*>(row), coordinator.FindComponent<DummyComp>(id));
+        initializedIds.insert(id);
+    });
+
+    EXPECT_EQ(initializedIds, allIds);
+    EXPECT_EQ(coordinator.GetItemIds<DummyEntity>(), allIds);
+    EXPECT_EQ(coordinator.GetAllocator<DummyComp>().NumAllocated(), allIds.size());
+
+    // add to existing items, moving them to new pattern
+    const comp::ItemIds someIds(allIds.begin(), std::next(allIds.begin(), 10));
+    coordinator.AddItems<comp::RowPolicy<DummyComp2*>>(someIds);
+    EXPECT_EQ((coordinator.GetItemIds<comp::RowPolicy<DummyComp*, DummyComp2*>>()), someIds);
+
+    coordinator.RemoveItems(someIds);
+    EXPECT_EQ(coordinator.GetItemIds<LocationEntity>().size(), allIds.size() - someIds.size());
+    EXPECT_EQ(coordinator.GetAllocator<DummyComp2>().NumAllocated(), 0u);
+
+    coordinator.Clear();
+    EXPECT_TRUE(coordinator.GetItemIds<LocationEntity>().empty());
+    EXPECT_EQ(coordinator.GetAllocator<comp::LocationComponent>().NumAllocated(), 0u);
+
+    // all pools are empty now, give their memory back
+    EXPECT_GT(coordinator.ReleaseMemory(), 0u);
+    EXPECT_EQ(coordinator.GetAllocator<comp::LocationComponent>().Capacity(), 0u);
+    EXPECT_EQ(coordinator.GetAllocator<DummyComp>().GetStats().mHighWaterMark, allIds.size());
+}
@@ -1,5 +1,8 @@
 #include "pch.h" 
 #include "ThreadModel/JobPool.h" 
+#include "ThreadModel/TaskGraph.h"
+#include "ThreadModel/Parallel.h"
+#include "ThreadModel/Coroutine.h"
 #include "fmt/format.h" 
 
 #include "LoggerCpp/OutputDebug.h"
@@ -8,6 +11,8 @@
 
 #include "Metrics/Gather.h" 
 #include "Metrics/Concurrency.h"
+#include <array>
+#include <numeric>
 
 #include "TestHelpers/TestHelpers.h"
 
@@ -144,3 +149,318 @@ TEST_F(Threads, AsyncWait)
     }
 }
 
+
+
+TEST_F(Threads, NestedTasks)
+{
+    using namespace yaget;
+
+    // each task adds 4 more from worker thread, those are pushed to worker's own queue and stolen by others
+    std::function<void(mt::JobPool&, std::atomic_int&, int)> spawn = [&spawn](mt::JobPool& pool, std::atomic_int& counter, int depth)
+    {
+        ++counter;
+        if (depth == 0)
+        {
+            return;
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            pool.AddTask([&spawn, &pool, &counter, depth]() { spawn(pool, counter, depth - 1); });
+        }
+    };
+
+    const int expected = 1 + 4 + 16 + 64 + 256 + 1024 + 4096;
+
+    mt::JobPool pool("NestedTasks", 4);
+    for (int i = 0; i < 3; ++i)
+    {
+        std::atomic_int counter{ 0 };
+        pool.AddTask([&spawn, &pool, &counter]() { spawn(pool, counter, 6); });
+        pool.Join();
+
+        EXPECT_EQ(counter, expected);
+    }
+
+    // single thread pool executes tasks in the order they were added, also ones added from a task
+    mt::JobPool serialPool("SerialTasks", 1);
+    std::vector<int> order;
+    for (int i = 0; i < 10; ++i)
+    {
+        serialPool.AddTask([&order, i]() { order.push_back(i); });
+    }
+    serialPool.AddTask([&serialPool, &order]()
+    {
+        for (int i = 10; i < 20; ++i)
+        {
+            serialPool.AddTask([&order, i]() { order.push_back(i); });
+        }
+    });
+    serialPool.Join();
+
+    std::vector<int> expectedOrder(20);
+    std::iota(expectedOrder.begin(), expectedOrder.end(), 0);
+    EXPECT_EQ(order, expectedOrder);
+}
+
+
+TEST_F(Threads, TaskGraph)
+{
+    using namespace yaget;
+
+    mt::JobPool pool("TaskGraph", 4);
+    mt::TaskGraph graph(pool);
+
+    // load -> resolve -> upload pipeline, joined with independent task
+    std::atomic_int numUploads{ 0 };
+    auto blob = graph.Add([]() { return std::string("blob"); });
+    auto asset = blob.Then([](const std::string& data) { return data + ".asset"; });
+    auto upload = asset.Then([&numUploads](const std::string& resolved) { numUploads += resolved == "blob.asset" ? 1 : 0; });
+    auto other = graph.Add([]() { return 5; });
+    auto all = graph.WhenAll({ upload, other });
+    auto total = all.Then([&numUploads, other]() { return numUploads + other.Result(); });
+
+    total.Wait();
+    EXPECT_EQ(total.State(), mt::TaskState::Done);
+    EXPECT_EQ(total.Result(), 6);
+    EXPECT_EQ(asset.Result(), "blob.asset");
+
+    // explicit dependency, cancelled before it started also cancels continuation
+    std::atomic_bool releaseBlocker = false;
+    std::atomic_int numRuns{ 0 };
+    auto blocker = graph.Add([&releaseBlocker]() { while (!releaseBlocker) { std::this_thread::yield(); } });
+    auto waiting = graph.Add([&numRuns]() { ++numRuns; }, { blocker });
+    auto continuation = waiting.Then([&numRuns]() { ++numRuns; });
+
+    EXPECT_TRUE(waiting.Cancel());
+    EXPECT_EQ(continuation.State(), mt::TaskState::Cancelled);
+
+    releaseBlocker = true;
+    blocker.Wait();
+    EXPECT_FALSE(blocker.Cancel());
+    EXPECT_EQ(blocker.State(), mt::TaskState::Done);
+
+    // exception fails task and cancels continuation
+    auto failed = graph.Add([]() -> int { throw std::runtime_error("TaskGraph test exception"); });
+    auto failedContinuation = failed.Then([&numRuns](int value) { ++numRuns; return value; });
+
+    failedContinuation.Wait();
+    EXPECT_EQ(failed.State(), mt::TaskState::Failed);
+    EXPECT_TRUE(failed.Exception() != nullptr);
+    EXPECT_EQ(failedContinuation.State(), mt::TaskState::Cancelled);
+
+    pool.Join();
+    EXPECT_EQ(numRuns, 0);
+
+    // tasks dropped by pool without running are cancelled together with their continuations
+    mt::Task dropped;
+    mt::Task droppedContinuation;
+    {
+        mt::JobPool pausedPool("TaskGraphPaused", 1, mt::JobPool::Behaviour::StartAsPause);
+        mt::TaskGraph pausedGraph(pausedPool);
+        auto droppedTask = pausedGraph.Add([&numRuns]() { ++numRuns; return 1; });
+        droppedContinuation = droppedTask.Then([&numRuns](int value) { ++numRuns; return value; });
+        dropped = droppedTask;
+    }
+
+    droppedContinuation.Wait();
+    EXPECT_EQ(dropped.State(), mt::TaskState::Cancelled);
+    EXPECT_EQ(droppedContinuation.State(), mt::TaskState::Cancelled);
+    EXPECT_EQ(numRuns, 0);
+}
+
+
+TEST_F(Threads, ParallelFor)
+{
+    using namespace yaget;
+
+    mt::JobPool pool("ParallelFor", 4);
+
+    for (std::size_t numItems : { 0, 1, 100, 100'003 })
+    {
+        std::vector<int> values(numItems, 0);
+        mt::parallel_for(pool, 0, numItems, 64, [&values](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                ++values[i];
+            }
+        });
+
+        mt::parallel_for(pool, values, 64, [](auto chunk)
+        {
+            for (int& value : chunk)
+            {
+                ++value;
+            }
+        });
+
+        EXPECT_TRUE(std::ranges::all_of(values, [](int value) { return value == 2; }));
+
+        std::iota(values.begin(), values.end(), 0);
+        const int64_t sum = mt::parallel_reduce(pool, 0, numItems, 64, int64_t{ 0 }, [&values](std::size_t begin, std::size_t end)
+        {
+            return std::accumulate(values.begin() + begin, values.begin() + end, int64_t{ 0 });
+        }, std::plus<int64_t>{});
+
+        EXPECT_EQ(sum, static_cast<int64_t>(numItems) * (static_cast<int64_t>(numItems) - 1) / 2);
+    }
+
+    // called from task running on the same pool
+    std::atomic<std::size_t> numProcessed{ 0 };
+    pool.AddTask([&pool, &numProcessed]()
+    {
+        mt::parallel_for(pool, 0, 10000, 16, [&numProcessed](std::size_t begin, std::size_t end) { numProcessed += end - begin; });
+    });
+    pool.Join();
+    EXPECT_EQ(numProcessed, 10000);
+
+    // exception is re-thrown on calling thread
+    EXPECT_THROW(mt::parallel_for(pool, 0, 1000, 16, [](std::size_t begin, std::size_t /*end*/)
+    {
+        if (begin >= 500)
+        {
+            throw std::runtime_error("ParallelFor test exception");
+        }
+    }), std::runtime_error);
+}
+
+
+
+TEST_F(Threads, UniqueFunction)
+{
+    using namespace yaget;
+
+    // move only capture
+    auto value = std::make_unique<int>(5);
+    mt::JobProcessor::Task_t task = [value = std::move(value)]() { ++*value; };
+    EXPECT_TRUE(task);
+    EXPECT_TRUE(task.IsInline());
+
+    mt::JobProcessor::Task_t movedTask = std::move(task);
+    EXPECT_FALSE(task);
+    EXPECT_TRUE(movedTask);
+    movedTask();
+
+    // bigger than inline storage goes to heap, and is still destroyed once
+    auto counter = std::make_shared<int>(0);
+    std::array<char, 128> payload{};
+    mt::JobProcessor::Task_t bigTask = [counter, payload]() { *counter += static_cast<int>(payload.size()); };
+    EXPECT_FALSE(bigTask.IsInline());
+    bigTask();
+    EXPECT_EQ(*counter, 128);
+    EXPECT_EQ(counter.use_count(), 2);
+    bigTask = nullptr;
+    EXPECT_EQ(counter.use_count(), 1);
+
+    EXPECT_FALSE(mt::JobProcessor::Task_t(std::function<void()>{}));
+
+    // move only data handed over to pool
+    mt::JobPool pool("UniqueFunction", 4);
+    std::atomic<int> sum{ 0 };
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.AddTask([data = std::make_unique<int>(i), &sum]() { sum += *data; });
+    }
+    pool.Join();
+    EXPECT_EQ(sum, 1000 * 999 / 2);
+}
+
+
+TEST_F(Threads, Priorities)
+{
+    using namespace yaget;
+
+    // all tasks are queued before single thread starts, so they run in priority order
+    mt::JobPool pool("Priorities", 1, mt::JobPool::Behaviour::StartAsPause);
+
+    std::vector<mt::JobPool::Priority> order;
+    const mt::JobPool::Priority priorities[] = { mt::JobPool::Priority::Low, mt::JobPool::Priority::Normal, mt::JobPool::Priority::High };
+    for (int i = 0; i < 10; ++i)
+    {
+        for (auto priority : priorities)
+        {
+            pool.AddTask([&order, priority]() { order.push_back(priority); }, priority);
+        }
+    }
+
+    pool.UnpauseAll();
+    pool.Join();
+
+    ASSERT_EQ(order.size(), 30);
+    EXPECT_TRUE(std::ranges::is_sorted(order));
+
+    for (auto priority : priorities)
+    {
+        EXPECT_EQ(pool.GetQueueLatency(priority).mNumTasks, 10);
+    }
+
+    const mt::JobPool::ThreadOptions threadOptions = mt::JobPool::ConfiguredThreadOptions("NotConfiguredPool");
+    EXPECT_EQ(threadOptions.mPriority, platform::ThreadPriority::Normal);
+    EXPECT_EQ(threadOptions.mAffinityMask, 0);
+}
+
+namespace
+{
+    yaget::mt::Coroutine<int> DoubleOnPool(yaget::mt::JobPool& pool, int value)
+    {
+        co_await yaget::mt::SwitchTo(pool);
+        co_return value * 2;
+    }
+
+    yaget::mt::Coroutine<int> SumOnPool(yaget::mt::JobPool& pool, int numValues)
+    {
+        int sum = 0;
+        for (int i = 0; i < numValues; ++i)
+        {
+            sum += co_await DoubleOnPool(pool, i);
+        }
+
+        co_return sum;
+    }
+
+    yaget::mt::Coroutine<> ThrowOnPool(yaget::mt::JobPool& pool)
+    {
+        co_await yaget::mt::SwitchTo(pool);
+        throw std::runtime_error("Coroutine test exception");
+    }
+
+    yaget::mt::Coroutine<> CountTimerSteps(yaget::mt::GameTimer& timer, std::atomic<int>& numSteps)
+    {
+        co_await timer.Delay(10);
+        ++numSteps;
+        // already passed, does not suspend
+        co_await timer.WaitUntil(5);
+        ++numSteps;
+        co_await timer.Delay(10);
+        ++numSteps;
+    }
+}
+
+
+TEST_F(Threads, Coroutine)
+{
+    using namespace yaget;
+
+    mt::JobPool pool("Coroutine", 4);
+
+    EXPECT_EQ(SumOnPool(pool, 20).Wait(), 380);
+    EXPECT_THROW(ThrowOnPool(pool).Wait(), std::runtime_error);
+
+    mt::GameTimer timer;
+    std::atomic<int> numSteps{ 0 };
+    CountTimerSteps(timer, numSteps).Start();
+    EXPECT_EQ(numSteps, 0);
+    EXPECT_EQ(timer.NumWaiting(), 1);
+
+    timer.Tick(5);
+    EXPECT_EQ(numSteps, 0);
+
+    timer.Tick(10);
+    EXPECT_EQ(numSteps, 2);
+    EXPECT_EQ(timer.NumWaiting(), 1);
+
+    timer.Tick(20);
+    EXPECT_EQ(numSteps, 3);
+    EXPECT_EQ(timer.NumWaiting(), 0);
+}
@@ -1,6 +1,8 @@
 #include "pch.h" 
 #include "YagetCore.h"
 #include "MemoryManager/PoolAllocator.h"
+#include "MemoryManager/ConcurrentPoolAllocator.h"
+#include "MemoryManager/HandlePool.h"
 #include "MathFacade.h"
 #include "Platform/Support.h"
 #include "Logger/YLog.h"
@@ -11,6 +13,8 @@
 //#include "ImageLoaders/lodepng.h"
 
 #include <functional>
+#include <set>
+#include <thread>
 
 class PoolAllocators : public ::testing::Test
 {
@@ -44,6 +48,10 @@ namespace
         int z;
     };
 
+    // over aligned elements, so pool lines are packed in memory next to each other (one slot)
+    // or line memory size is not power of two (three slots)
+    struct alignas(16) SmallAlignedClass { int z = 0; };
+    struct alignas(32) OddAlignedClass { int z = 0; };
 
 
 } // namespace
@@ -247,8 +255,8 @@ TEST_F(PoolAllocators, Iterators)
     {
         auto object = &(*it);
         
-        auto* blockHeader = PoolAllocator::PoolLine::GetBlockHeader(object);
-        const auto cellNumber = blockHeader->mLineIndex * kPoolLineSize + blockHeader->mSlotIndex;
+        const auto [lineIndex, slotIndex] = testPoolAllocator.Locate(object);
+        const auto cellNumber = lineIndex * kPoolLineSize + slotIndex;
 
         EXPECT_TRUE(object->z == cellNumber);
 
@@ -274,6 +282,471 @@ TEST_F(PoolAllocators, Iterators)
     z;
 }
 
+TEST_F(PoolAllocators, FreeSlots)
+{
+    using namespace yaget;
+    // not a multiple of 64, last occupancy word is partially used
+    constexpr int kPoolLineSize = 100;
+    constexpr int kNumberItems = kPoolLineSize * 10;
+
+    using PoolAllocator = memory::PoolAllocator<TestClass, kPoolLineSize>;
+    PoolAllocator testPoolAllocator;
+
+    std::vector<TestClass*> objects;
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        objects.push_back(testPoolAllocator.Allocate(i));
+    }
+    EXPECT_EQ(testPoolAllocator.Capacity(), static_cast<std::size_t>(kNumberItems));
+    EXPECT_EQ(testPoolAllocator.NumAllocated(), static_cast<std::size_t>(kNumberItems));
+
+    // free slots spread over all lines must be reused before any new line is added
+    for (int i = 0; i < kNumberItems; i += 3)
+    {
+        testPoolAllocator.Free(objects[i]);
+        objects[i] = nullptr;
+    }
+
+    for (int i = 0; i < kNumberItems; i += 3)
+    {
+        objects[i] = testPoolAllocator.Allocate(i);
+    }
+    EXPECT_EQ(testPoolAllocator.Capacity(), static_cast<std::size_t>(kNumberItems));
+
+    std::set<TestClass*> uniqueObjects(objects.begin(), objects.end());
+    EXPECT_EQ(uniqueObjects.size(), objects.size());
+
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        EXPECT_EQ(objects[i]->z, i);
+        testPoolAllocator.Free(objects[i]);
+    }
+    EXPECT_EQ(testPoolAllocator.NumAllocated(), 0u);
+}
+
+TEST_F(PoolAllocators, LineLookup)
+{
+    using namespace yaget;
+
+    auto checkPool = []<typename T, int E>(memory::PoolAllocator<T, E>& testPoolAllocator, int numItems)
+    {
+        std::vector<T*> objects;
+        for (int i = 0; i < numItems; ++i)
+        {
+            T* object = testPoolAllocator.Allocate();
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(object) % alignof(T), 0u);
+            object->z = i;
+            objects.push_back(object);
+        }
+
+        // lines are filled one at the time, in slot order
+        for (const T* object : objects)
+        {
+            const auto [lineIndex, slotIndex] = testPoolAllocator.Locate(object);
+            EXPECT_EQ(lineIndex * E + slotIndex, object->z);
+        }
+
+        // elements are still found after some lines are released
+        for (std::size_t i = 0; i < objects.size(); i += 2)
+        {
+            testPoolAllocator.Free(objects[i]);
+        }
+        testPoolAllocator.ReleaseEmptyLines();
+
+        for (std::size_t i = 1; i < objects.size(); i += 2)
+        {
+            const auto [lineIndex, slotIndex] = testPoolAllocator.Locate(objects[i]);
+            EXPECT_EQ(lineIndex * E + slotIndex, objects[i]->z);
+            testPoolAllocator.Free(objects[i]);
+        }
+        EXPECT_EQ(testPoolAllocator.NumAllocated(), 0u);
+    };
+
+    memory::PoolAllocator<SmallAlignedClass, 1> smallPoolAllocator;
+    checkPool(smallPoolAllocator, 200);
+
+    memory::PoolAllocator<OddAlignedClass, 3> oddPoolAllocator;
+    checkPool(oddPoolAllocator, 300);
+}
+
+TEST_F(PoolAllocators, SparseIteration)
+{
+    using namespace yaget;
+    constexpr int kPoolLineSize = 128;
+    constexpr int kNumberItems = kPoolLineSize * 8;
+
+    using PoolAllocator = memory::PoolAllocator<TestClass, kPoolLineSize>;
+    PoolAllocator testPoolAllocator;
+
+    std::vector<TestClass*> objects;
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        objects.push_back(testPoolAllocator.Allocate(i));
+    }
+
+    // leave few objects, with completely empty lines between them
+    std::vector<int> expectedValues;
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        const int lineIndex = i / kPoolLineSize;
+        if ((lineIndex == 1 || lineIndex == 5) && i % 37 == 0)
+        {
+            expectedValues.push_back(i);
+        }
+        else
+        {
+            testPoolAllocator.Free(objects[i]);
+        }
+    }
+
+    std::vector<int> iteratedValues;
+    for (auto it = testPoolAllocator.begin(); it != testPoolAllocator.end(); ++it)
+    {
+        iteratedValues.push_back(it->z);
+    }
+    EXPECT_EQ(iteratedValues, expectedValues);
+
+    iteratedValues.clear();
+    testPoolAllocator.ForEachAllocated([&iteratedValues](TestClass& object)
+    {
+        iteratedValues.push_back(object.z);
+    });
+    EXPECT_EQ(iteratedValues, expectedValues);
+
+    // callback is allowed to free element it was given
+    testPoolAllocator.ForEachAllocated([&testPoolAllocator](TestClass& object)
+    {
+        testPoolAllocator.Free(&object);
+    });
+    EXPECT_EQ(testPoolAllocator.NumAllocated(), 0u);
+    EXPECT_TRUE(testPoolAllocator.begin() == testPoolAllocator.end());
+}
+
+TEST_F(PoolAllocators, ConcurrentStress)
+{
+    using namespace yaget;
+    constexpr int kNumThreads = 8;
+    constexpr int kNumberItems = 2000;
+    constexpr int kNumRounds = 20;
+
+    using PoolAllocator = memory::ConcurrentPoolAllocator<TestClass, 64>;
+    PoolAllocator testPoolAllocator;
+
+    // each thread keeps it's own objects, and every round frees objects of next thread (remote free)
+    // and allocates new ones in their place
+    std::vector<std::vector<TestClass*>> objects(kNumThreads, std::vector<TestClass*>(kNumberItems, nullptr));
+
+    auto runThreads = [](auto&& threadFunction)
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kNumThreads; ++t)
+        {
+            threads.emplace_back(threadFunction, t);
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    };
+
+    runThreads([&testPoolAllocator, &objects](int t)
+    {
+        for (int i = 0; i < kNumberItems; ++i)
+        {
+            objects[t][i] = testPoolAllocator.Allocate(t * kNumberItems + i);
+        }
+    });
+
+    for (int round = 0; round < kNumRounds; ++round)
+    {
+        runThreads([&testPoolAllocator, &objects, round](int t)
+        {
+            const int other = (t + 1 + round) % kNumThreads;
+            for (int i = 0; i < kNumberItems; ++i)
+            {
+                TestClass*& object = objects[other][i];
+                if (i % 2 == round % 2)
+                {
+                    testPoolAllocator.Free(object);
+                    object = testPoolAllocator.Allocate(other * kNumberItems + i);
+                }
+            }
+        });
+    }
+
+    EXPECT_EQ(testPoolAllocator.NumAllocated(), static_cast<std::size_t>(kNumThreads * kNumberItems));
+
+    std::set<TestClass*> uniqueObjects;
+    for (int t = 0; t < kNumThreads; ++t)
+    {
+        for (int i = 0; i < kNumberItems; ++i)
+        {
+            EXPECT_EQ(objects[t][i]->z, t * kNumberItems + i);
+            uniqueObjects.insert(objects[t][i]);
+        }
+    }
+    EXPECT_EQ(uniqueObjects.size(), static_cast<std::size_t>(kNumThreads * kNumberItems));
+
+    runThreads([&testPoolAllocator, &objects](int t)
+    {
+        for (auto object : objects[t])
+        {
+            testPoolAllocator.Free(object);
+        }
+    });
+
+    EXPECT_EQ(testPoolAllocator.NumAllocated(), 0u);
+}
+
+TEST_F(PoolAllocators, ConcurrentThreadExit)
+{
+    using namespace yaget;
+    constexpr int kPoolLineSize = 64;
+    constexpr int kNumRounds = 50;
+
+    using PoolAllocator = memory::ConcurrentPoolAllocator<TestClass, kPoolLineSize>;
+    PoolAllocator testPoolAllocator;
+
+    // every round short lived thread allocates and exits, objects are freed on this thread which never allocated,
+    // so they go to cache of exited thread, which is retired and reused by next thread instead of leaking it's blocks
+    std::vector<TestClass*> objects;
+    for (int round = 0; round < kNumRounds; ++round)
+    {
+        std::thread([&testPoolAllocator, &objects, round]()
+        {
+            for (int i = 0; i < kPoolLineSize; ++i)
+            {
+                objects.push_back(testPoolAllocator.Allocate(round * kPoolLineSize + i));
+            }
+        }).join();
+
+        for (auto object : objects)
+        {
+            testPoolAllocator.Free(object);
+        }
+        objects.clear();
+    }
+
+    EXPECT_EQ(testPoolAllocator.NumAllocated(), 0u);
+    EXPECT_LE(testPoolAllocator.Capacity(), static_cast<std::size_t>(kPoolLineSize * 2));
+}
+
+TEST_F(PoolAllocators, ReleaseEmptyLines)
+{
+    using namespace yaget;
+    constexpr int kPoolLineSize = 64;
+    constexpr int kNumberItems = kPoolLineSize * 8;
+
+    using PoolAllocator = memory::PoolAllocator<TestClass, kPoolLineSize>;
+    PoolAllocator testPoolAllocator;
+
+    std::vector<TestClass*> objects;
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        objects.push_back(testPoolAllocator.Allocate(i));
+    }
+
+    // keep first and last line, rest become empty
+    for (int i = kPoolLineSize; i < kNumberItems - kPoolLineSize; ++i)
+    {
+        testPoolAllocator.Free(objects[i]);
+        objects[i] = nullptr;
+    }
+
+    // keep one free line around
+    EXPECT_EQ(testPoolAllocator.ReleaseEmptyLines(kPoolLineSize), 5u);
+    auto stats = testPoolAllocator.GetStats();
+    EXPECT_EQ(stats.mNumLines, 3u);
+    EXPECT_EQ(stats.mNumAllocated, static_cast<std::size_t>(kPoolLineSize * 2));
+    EXPECT_EQ(stats.mHighWaterMark, static_cast<std::size_t>(kNumberItems));
+    EXPECT_EQ(stats.mNumReleasedLines, 5u);
+
+    EXPECT_EQ(testPoolAllocator.ReleaseEmptyLines(), 1u);
+    EXPECT_EQ(testPoolAllocator.NumLines(), 2u);
+
+    // surviving objects did not move and iteration skips released lines
+    std::vector<int> iteratedValues;
+    testPoolAllocator.ForEachAllocated([&iteratedValues](TestClass& object)
+    {
+        iteratedValues.push_back(object.z);
+    });
+    EXPECT_EQ(iteratedValues.size(), static_cast<std::size_t>(kPoolLineSize * 2));
+
+    std::size_t numIterated = 0;
+    for (auto it = testPoolAllocator.begin(); it != testPoolAllocator.end(); ++it)
+    {
+        ++numIterated;
+    }
+    EXPECT_EQ(numIterated, static_cast<std::size_t>(kPoolLineSize * 2));
+
+    // released lines are reused
+    for (int i = kPoolLineSize; i < kNumberItems - kPoolLineSize; ++i)
+    {
+        objects[i] = testPoolAllocator.Allocate(i);
+    }
+    EXPECT_EQ(testPoolAllocator.NumLines(), 8u);
+
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        EXPECT_EQ(objects[i]->z, i);
+        testPoolAllocator.Free(objects[i]);
+    }
+    EXPECT_EQ(testPoolAllocator.NumAllocated(), 0u);
+}
+
+TEST_F(PoolAllocators, HandlePool)
+{
+    using namespace yaget;
+    constexpr int kPoolLineSize = 32;
+    constexpr int kNumberItems = kPoolLineSize * 10;
+
+    using HandlePool = memory::HandlePool<TestClass, kPoolLineSize>;
+    HandlePool testHandlePool(memory::CompactionPolicy{ 0.5f, 2 });
+
+    std::vector<HandlePool::Handle> handles;
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        handles.push_back(testHandlePool.Allocate(i));
+    }
+    EXPECT_EQ(testHandlePool.NumLines(), 10u);
+    EXPECT_FALSE(testHandlePool.ShouldCompact());
+
+    // stale handle does not resolve, even after it's index is reused
+    const HandlePool::Handle staleHandle = handles[0];
+    testHandlePool.Free(staleHandle);
+    handles[0] = testHandlePool.Allocate(0);
+    EXPECT_EQ(handles[0].Index(), staleHandle.Index());
+    EXPECT_FALSE(testHandlePool.IsValid(staleHandle));
+    EXPECT_EQ(testHandlePool.Get(staleHandle), nullptr);
+    EXPECT_EQ(testHandlePool.Get(HandlePool::Handle{}), nullptr);
+
+    // leave every 4th object alive, spread over all lines
+    std::vector<int> aliveIndexes;
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        if (i % 4)
+        {
+            testHandlePool.Free(handles[i]);
+        }
+        else
+        {
+            aliveIndexes.push_back(i);
+        }
+    }
+    EXPECT_EQ(testHandlePool.NumLines(), 10u);
+    EXPECT_TRUE(testHandlePool.ShouldCompact());
+
+    const std::size_t numMoved = testHandlePool.MaybeCompact();
+    EXPECT_GT(numMoved, 0u);
+    EXPECT_EQ(testHandlePool.NumCompactions(), 1u);
+
+    const auto stats = testHandlePool.GetStats();
+    EXPECT_EQ(stats.mNumLines, static_cast<std::size_t>((aliveIndexes.size() + kPoolLineSize - 1) / kPoolLineSize));
+    EXPECT_EQ(stats.mNumAllocated, aliveIndexes.size());
+    EXPECT_EQ(stats.mHighWaterMark, static_cast<std::size_t>(kNumberItems));
+    EXPECT_EQ(stats.mNumReleasedLines, 10u - stats.mNumLines);
+    EXPECT_FALSE(testHandlePool.ShouldCompact());
+
+    // handles still resolve to the same values after objects moved
+    for (int i : aliveIndexes)
+    {
+        const TestClass* object = testHandlePool.Get(handles[i]);
+        ASSERT_NE(object, nullptr);
+        EXPECT_EQ(object->z, i);
+    }
+
+    std::size_t numIterated = 0;
+    testHandlePool.ForEachAllocated([&testHandlePool, &numIterated](HandlePool::Handle handle, TestClass& object)
+    {
+        EXPECT_EQ(testHandlePool.Get(handle), &object);
+        ++numIterated;
+    });
+    EXPECT_EQ(numIterated, aliveIndexes.size());
+
+    // allocations after compaction reuse released lines
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        if (i % 4)
+        {
+            handles[i] = testHandlePool.Allocate(i);
+        }
+    }
+    EXPECT_EQ(testHandlePool.NumLines(), 10u);
+
+    for (int i = 0; i < kNumberItems; ++i)
+    {
+        EXPECT_EQ(testHandlePool.Get(handles[i])->z, i);
+        testHandlePool.Free(handles[i]);
+    }
+    EXPECT_EQ(testHandlePool.NumAllocated(), 0u);
+    EXPECT_EQ(testHandlePool.ReleaseEmptyLines(), 10u);
+}
+
+namespace
+{
+    yaget::memory::PoolAllocator<TestClass, 16> staticTestPoolAllocator;
+}
+
+TEST_F(PoolAllocators, SmartPointers)
+{
+    using namespace yaget;
+    constexpr int kNumberItems = 100;
+
+    using PoolAllocator = memory::PoolAllocator<TestClass, 16>;
+    PoolAllocator testPoolAllocator;
+    memory::ControlBlockPool<> controlBlockPool;
+
+    {
+        std::vector<std::shared_ptr<TestClass>> sharedObjects;
+        for (int i = 0; i < kNumberItems; ++i)
+        {
+            sharedObjects.push_back(memory::NewShared(testPoolAllocator, controlBlockPool, i));
+        }
+        EXPECT_EQ(testPoolAllocator.NumAllocated(), static_cast<std::size_t>(kNumberItems));
+        EXPECT_EQ(controlBlockPool.NumAllocated(), static_cast<std::size_t>(kNumberItems));
+
+        // copies share control block
+        std::shared_ptr<TestClass> copy = sharedObjects[5];
+        sharedObjects.clear();
+        EXPECT_EQ(copy->z, 5);
+        EXPECT_EQ(controlBlockPool.NumAllocated(), 1u);
+
+        std::weak_ptr<TestClass> weakObject = copy;
+        copy.reset();
+        EXPECT_TRUE(weakObject.expired());
+        EXPECT_EQ(testPoolAllocator.NumAllocated(), 0u);
+        // weak reference keeps control block alive
+        EXPECT_EQ(controlBlockPool.NumAllocated(), 1u);
+    }
+    EXPECT_EQ(controlBlockPool.NumAllocated(), 0u);
+
+    {
+        // object and control block share one block
+        memory::ControlBlockPool<128> objectBlockPool;
+        std::shared_ptr<TestClass> sharedObject = memory::AllocateShared<TestClass>(objectBlockPool, 3);
+        EXPECT_EQ(sharedObject->z, 3);
+        EXPECT_EQ(objectBlockPool.NumAllocated(), 1u);
+        sharedObject.reset();
+        EXPECT_EQ(objectBlockPool.NumAllocated(), 0u);
+    }
+
+    {
+        auto uniqueObject = memory::NewUnique(testPoolAllocator, 7);
+        EXPECT_EQ(uniqueObject->z, 7);
+        EXPECT_EQ(testPoolAllocator.NumAllocated(), 1u);
+    }
+    EXPECT_EQ(testPoolAllocator.NumAllocated(), 0u);
+
+    {
+        auto uniqueObject = memory::NewUnique<staticTestPoolAllocator>(9);
+        static_assert(sizeof(uniqueObject) == sizeof(TestClass*), "Static pool deleter must not add any state.");
+        EXPECT_EQ(uniqueObject->z, 9);
+        EXPECT_EQ(staticTestPoolAllocator.NumAllocated(), 1u);
+    }
+    EXPECT_EQ(staticTestPoolAllocator.NumAllocated(), 0u);
+}
+
 TEST_F(PoolAllocators, Hashes)
 {
     using namespace yaget;
@@ -2,6 +2,7 @@
 
 #include "App/AppHarness.h"
 #include "ThreadModel/JobPool.h"
+#include "ThreadModel/SpscRingBuffer.h"
 #include "ThreadModel/Variables.h"
 #include "TestHelpers/TestHelpers.h"
 
@@ -147,3 +148,217 @@ TEST_F(Threading, Variable)
 
     quit = true;
 }
+
+
+TEST_F(Threading, SharedVariable)
+{
+    using namespace yaget;
+    using Numbers = std::vector<int>;
+
+    mt::SharedVariable<Numbers> numbers;
+    EXPECT_TRUE(numbers.Get()->empty());
+
+    numbers.Update([](Numbers& value) { value.push_back(0); });
+    mt::SharedVariable<Numbers>::Snapshot snapshot = numbers.Get();
+    numbers.Update([](Numbers& value) { value.push_back(1); });
+
+    // snapshot held by reader does not change, new readers see new value
+    EXPECT_EQ(Numbers({ 0 }), *snapshot);
+    EXPECT_EQ(Numbers({ 0, 1 }), numbers.GetValue());
+
+    mt::SharedVariable<Numbers>::Snapshot previous = numbers.Exchange({ 5 });
+    EXPECT_EQ(Numbers({ 0, 1 }), *previous);
+    EXPECT_EQ(Numbers({ 5 }), *numbers.Get());
+
+    numbers = Numbers{};
+
+    // readers always see complete value, growing one element at a time
+    constexpr int kNumUpdates = 2000;
+    constexpr uint32_t kNumReaders = 2;
+    std::atomic_bool quit{ false };
+    std::atomic<int> numErrors{ 0 };
+
+    mt::JobPool pool("SHARED_VARIABLE_TEST", kNumReaders);
+    for (uint32_t i = 0; i < kNumReaders; ++i)
+    {
+        pool.AddTask([&numbers, &quit, &numErrors]()
+        {
+            std::size_t lastSize = 0;
+            while (!quit)
+            {
+                const auto current = numbers.Get();
+                for (std::size_t n = 0; n < current->size(); ++n)
+                {
+                    numErrors += (*current)[n] != static_cast<int>(n) ? 1 : 0;
+                }
+
+                numErrors += current->size() < lastSize ? 1 : 0;
+                lastSize = current->size();
+            }
+        });
+    }
+
+    // concurrent writers do not lose updates
+    mt::JobPool writers("SHARED_VARIABLE_WRITERS", 2);
+    for (int i = 0; i < kNumUpdates; ++i)
+    {
+        writers.AddTask([&numbers]()
+        {
+            numbers.Update([](Numbers& value) { value.push_back(static_cast<int>(value.size())); });
+        });
+    }
+
+    writers.Join();
+    quit = true;
+    pool.Join();
+
+    EXPECT_EQ(0, numErrors.load());
+    EXPECT_EQ(static_cast<std::size_t>(kNumUpdates), numbers.Get()->size());
+}
+
+
+TEST_F(Threading, SeqLockVariable)
+{
+    using namespace yaget;
+
+    // size is not multiple of a word, to check partial last word
+    struct Bounds
+    {
+        float mMin[3] = {};
+        float mMax[3] = {};
+        uint32_t mVersion = 0;
+    };
+
+    auto makeBounds = [](uint32_t version)
+    {
+        Bounds bounds;
+        for (int i = 0; i < 3; ++i)
+        {
+            bounds.mMin[i] = -static_cast<float>(version);
+            bounds.mMax[i] = static_cast<float>(version);
+        }
+        bounds.mVersion = version;
+        return bounds;
+    };
+
+    mt::SeqLockVariable<Bounds> bounds(makeBounds(1));
+    Bounds value = bounds;
+    EXPECT_EQ(1u, value.mVersion);
+    EXPECT_EQ(-1.0f, value.mMin[2]);
+
+    bounds.Update([](Bounds& current) { current.mVersion += 1; });
+    EXPECT_EQ(2u, bounds.Get().mVersion);
+    EXPECT_EQ(1.0f, bounds.Get().mMax[0]);
+
+    bounds = makeBounds(0);
+
+    constexpr uint32_t kNumUpdates = 100000;
+    constexpr uint32_t kNumReaders = 2;
+    std::atomic_bool quit{ false };
+    std::atomic<int> numErrors{ 0 };
+
+    // readers never see torn value and version never goes back
+    mt::JobPool pool("SEQLOCK_VARIABLE_TEST", kNumReaders);
+    for (uint32_t i = 0; i < kNumReaders; ++i)
+    {
+        pool.AddTask([&bounds, &quit, &numErrors]()
+        {
+            uint32_t lastVersion = 0;
+            while (!quit)
+            {
+                const Bounds current = bounds;
+                const float version = static_cast<float>(current.mVersion);
+                for (int n = 0; n < 3; ++n)
+                {
+                    numErrors += (current.mMin[n] != -version || current.mMax[n] != version) ? 1 : 0;
+                }
+
+                numErrors += current.mVersion < lastVersion ? 1 : 0;
+                lastVersion = current.mVersion;
+            }
+        });
+    }
+
+    for (uint32_t i = 1; i <= kNumUpdates; ++i)
+    {
+        bounds = makeBounds(i);
+    }
+
+    quit = true;
+    pool.Join();
+
+    EXPECT_EQ(0, numErrors.load());
+    EXPECT_EQ(kNumUpdates, bounds.Get().mVersion);
+}
+
+
+TEST_F(Threading, SpscRingBuffer)
+{
+    using namespace yaget;
+
+    struct Record
+    {
+        uint64_t mIndex = 0;
+        uint64_t mCheck = 0;
+    };
+
+    using Buffer = mt::SpscRingBuffer<Record, 64>;
+    auto buffer = std::make_unique<Buffer>();
+
+    // fills up to capacity, then rejects
+    for (uint64_t i = 0; i < Buffer::kCapacity; ++i)
+    {
+        EXPECT_TRUE(buffer->TryPush({ i, ~i }));
+    }
+    EXPECT_FALSE(buffer->TryPush({}));
+    EXPECT_EQ(Buffer::kCapacity, buffer->Size());
+
+    uint64_t expected = 0;
+    EXPECT_EQ(Buffer::kCapacity, buffer->PopAll([&expected](const Record& record)
+    {
+        EXPECT_EQ(expected++, record.mIndex);
+    }));
+    EXPECT_TRUE(buffer->Empty());
+    EXPECT_TRUE(buffer->TryPush({ 1, ~1ull }));
+    buffer->PopAll([](const Record&) {});
+
+    // producer and consumer on different threads, items come out in order and not torn,
+    // dropped ones are only the ones producer was told about
+    constexpr uint64_t kNumItems = 200000;
+    std::atomic_bool done{ false };
+    std::atomic<uint64_t> numDropped{ 0 };
+
+    mt::JobPool pool("SPSC_TEST", 1);
+    pool.AddTask([&buffer, &done, &numDropped]()
+    {
+        uint64_t dropped = 0;
+        for (uint64_t i = 0; i < kNumItems; ++i)
+        {
+            dropped += buffer->TryPush({ i, ~i }) ? 0 : 1;
+        }
+
+        numDropped = dropped;
+        done = true;
+    });
+
+    uint64_t numReceived = 0;
+    uint64_t lastIndex = 0;
+    int numErrors = 0;
+    auto consumer = [&numReceived, &lastIndex, &numErrors](const Record& record)
+    {
+        numErrors += record.mCheck != ~record.mIndex ? 1 : 0;
+        numErrors += numReceived && record.mIndex <= lastIndex ? 1 : 0;
+        lastIndex = record.mIndex;
+        ++numReceived;
+    };
+
+    while (!done)
+    {
+        buffer->PopAll(consumer);
+    }
+    buffer->PopAll(consumer);
+    pool.Join();
+
+    EXPECT_EQ(0, numErrors);
+    EXPECT_EQ(kNumItems, numReceived + numDropped);
+}
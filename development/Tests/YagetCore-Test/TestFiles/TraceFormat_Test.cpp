@@ -0,0 +1,160 @@
+#include "pch.h"
+
+#include "Metrics/PerformanceTracer.h"
+#include "Metrics/TraceFormat.h"
+#include "TestHelpers/TestHelpers.h"
+#include <limits>
+#include <sstream>
+
+
+class TraceFormat : public ::testing::Test
+{
+};
+
+
+namespace
+{
+    using Event = yaget::metrics::TraceRecord::Event;
+
+    const yaget::metrics::TraceNameId kTickName = static_cast<yaget::metrics::TraceNameId>(1);
+    const yaget::metrics::TraceNameId kCategory = static_cast<yaget::metrics::TraceNameId>(2);
+    const yaget::metrics::TraceNameId kLoadName = static_cast<yaget::metrics::TraceNameId>(3);
+
+    // two flushes, second one adds new name and continues time deltas from first one
+    std::string WriteBinaryTrace()
+    {
+        using namespace yaget::metrics;
+
+        std::ostringstream output(std::ios::out | std::ios::binary);
+        trace::BinaryWriter writer(output, "TraceTest", "Today");
+
+        writer.AddName(kTickName, "Input.Tick");
+        writer.AddName(kCategory, "Channel");
+        writer.AddRecord({ kTickName, {}, 1000000, 1000000, 7, Event::Begin, 0, kCategory });
+        writer.AddRecord({ kTickName, {}, 1000250, 1000250, 7, Event::End, 0, kCategory });
+        writer.AddRecord({ kTickName, {}, 999000, 1003000, 9, Event::Complete, 0, kCategory });
+        writer.Flush();
+
+        writer.AddName(kLoadName, "c:\\assets\\\"level\".pak");
+        writer.AddRecord({ kLoadName, {}, 1000100, 1000100, 7, Event::AsyncBegin, 42, kCategory });
+        writer.AddRecord({ kLoadName, {}, 1000050, 1000050, 7, Event::Instant, 0, kCategory, MessageScope::Global });
+        writer.AddRecord({ kTickName, {}, 1000300, 1000300, 9, Event::Counter, 0, kCategory, MessageScope::Thread, -12 });
+        writer.AddThreadName(7, "Main");
+        writer.Flush();
+
+        EXPECT_EQ(writer.NumBytesWritten(), output.str().size());
+        return output.str();
+    }
+}
+
+
+TEST_F(TraceFormat, Varint)
+{
+    using namespace yaget::metrics;
+
+    for (uint64_t value : std::initializer_list<uint64_t>{ 0, 1, 127, 128, 300, 0xFFFFFFFF, std::numeric_limits<uint64_t>::max() })
+    {
+        std::string buffer;
+        trace::WriteVarint(buffer, value);
+
+        std::string_view data = buffer;
+        uint64_t readValue = 0;
+        EXPECT_TRUE(trace::ReadVarint(data, readValue));
+        EXPECT_EQ(readValue, value);
+        EXPECT_TRUE(data.empty());
+    }
+
+    for (int64_t value : std::initializer_list<int64_t>{ 0, 1, -1, 1000, -1000, std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min() })
+    {
+        EXPECT_EQ(trace::UnZigZag(trace::ZigZag(value)), value);
+    }
+
+    EXPECT_EQ(trace::ZigZag(-1), 1u);
+
+    std::string_view truncated = "\x80";
+    uint64_t readValue = 0;
+    EXPECT_FALSE(trace::ReadVarint(truncated, readValue));
+}
+
+
+TEST_F(TraceFormat, ConvertToJson)
+{
+    using namespace yaget::metrics;
+
+    std::istringstream input(WriteBinaryTrace(), std::ios::in | std::ios::binary);
+    std::ostringstream output;
+    const auto [result, errorMessage] = trace::ConvertToJson(input, output);
+    EXPECT_TRUE(result) << errorMessage;
+
+    const nlohmann::json trace = nlohmann::json::parse(output.str());
+    EXPECT_EQ(trace["otherData"]["Application"], "TraceTest");
+    EXPECT_EQ(trace["otherData"]["Date"], "Today");
+
+    // first one is empty object
+    const auto& events = trace["traceEvents"];
+    ASSERT_EQ(events.size(), 8);
+
+    EXPECT_EQ(events[1]["name"], "Input.Tick");
+    EXPECT_EQ(events[1]["cat"], "Channel");
+    EXPECT_EQ(events[1]["ph"], "B");
+    EXPECT_EQ(events[1]["tid"], 7);
+    EXPECT_EQ(events[1]["ts"], 1000000);
+    EXPECT_EQ(events[2]["ph"], "E");
+    EXPECT_EQ(events[2]["ts"], 1000250);
+
+    EXPECT_EQ(events[3]["ph"], "X");
+    EXPECT_EQ(events[3]["tid"], 9);
+    EXPECT_EQ(events[3]["ts"], 999000);
+    EXPECT_EQ(events[3]["dur"], 4000);
+
+    EXPECT_EQ(events[4]["name"], "c:\\assets\\\"level\".pak");
+    EXPECT_EQ(events[4]["ph"], "b");
+    EXPECT_EQ(events[4]["ts"], 1000100);
+    EXPECT_EQ(events[4]["id"], 42);
+
+    EXPECT_EQ(events[5]["ph"], "I");
+    EXPECT_EQ(events[5]["ts"], 1000050);
+    EXPECT_EQ(events[5]["s"], "g");
+
+    EXPECT_EQ(events[6]["ph"], "C");
+    EXPECT_EQ(events[6]["tid"], 9);
+    EXPECT_EQ(events[6]["ts"], 1000300);
+    EXPECT_EQ(events[6]["args"]["value"], -12);
+
+    EXPECT_EQ(events[7]["name"], "thread_name");
+    EXPECT_EQ(events[7]["ph"], "M");
+    EXPECT_EQ(events[7]["args"]["name"], "Main");
+}
+
+
+TEST_F(TraceFormat, ConvertTruncated)
+{
+    using namespace yaget::metrics;
+
+    const std::string binaryTrace = WriteBinaryTrace();
+
+    // capture cut in the middle of last block keeps everything before it
+    std::istringstream input(binaryTrace.substr(0, binaryTrace.size() - 3), std::ios::in | std::ios::binary);
+    std::ostringstream output;
+    const auto [result, errorMessage] = trace::ConvertToJson(input, output);
+    EXPECT_FALSE(result);
+    EXPECT_FALSE(errorMessage.empty());
+
+    // only last ThreadNames block is lost
+    const nlohmann::json trace = nlohmann::json::parse(output.str());
+    EXPECT_EQ(trace["traceEvents"].size(), 7);
+
+    // corrupted block size is rejected before payload is allocated
+    std::string corruptedTrace = binaryTrace;
+    corruptedTrace.push_back(static_cast<char>(trace::Block::Events));
+    trace::WriteVarint(corruptedTrace, std::numeric_limits<uint64_t>::max());
+    std::istringstream corruptedInput(corruptedTrace, std::ios::in | std::ios::binary);
+    std::ostringstream corruptedOutput;
+    const auto [corruptedResult, corruptedErrorMessage] = trace::ConvertToJson(corruptedInput, corruptedOutput);
+    EXPECT_FALSE(corruptedResult);
+    EXPECT_FALSE(corruptedErrorMessage.empty());
+
+    std::istringstream jsonInput("{\"traceEvents\":[]}");
+    const auto [jsonResult, jsonErrorMessage] = trace::ConvertToJson(jsonInput, output);
+    EXPECT_FALSE(jsonResult);
+}
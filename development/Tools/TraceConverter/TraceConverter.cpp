@@ -0,0 +1,68 @@
+// TraceConverter.cpp : Converts binary trace file (Debug.Metrics.TraceFormat = Binary) to chrome://tracing json,
+// which can be loaded into chrome://tracing or Perfetto UI (https://ui.perfetto.dev).
+//
+//  TraceConverter <trace.ytrace> [trace.json]
+//
+
+#include "YagetCore.h"
+#include "Metrics/TraceFormat.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+
+namespace yaget::ylog
+{
+  yaget::Strings GetRegisteredTags()
+  {
+      yaget::Strings tags =
+      {
+          #include "Logger/CoreLogTags.h"
+      };
+
+      return tags;
+  }
+} // namespace yaget::ylog
+
+
+YAGET_BRAND_NAME_F("Beyond Limits")
+
+int main(int argc, char* argv[])
+{
+    using namespace yaget;
+    namespace fs = std::filesystem;
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage: TraceConverter <trace.ytrace> [trace.json]\n";
+        return 1;
+    }
+
+    const fs::path inputPath = argv[1];
+    const fs::path outputPath = argc > 2 ? fs::path(argv[2]) : fs::path(inputPath).replace_extension(".json");
+
+    std::ifstream input(inputPath, std::ios::in | std::ios::binary);
+    if (!input.is_open())
+    {
+        std::cerr << "Could not open input trace file: '" << inputPath.generic_string() << "'.\n";
+        return 1;
+    }
+
+    std::ofstream output(outputPath);
+    if (!output.is_open())
+    {
+        std::cerr << "Could not create output json file: '" << outputPath.generic_string() << "'.\n";
+        return 1;
+    }
+
+    const auto [result, errorMessage] = metrics::trace::ConvertToJson(input, output);
+    if (!result)
+    {
+        // json is still valid and has all events up to the error
+        std::cerr << "Trace file: '" << inputPath.generic_string() << "' converted partially. " << errorMessage << "\n";
+        return 2;
+    }
+
+    std::cout << "Converted '" << inputPath.generic_string() << "' to '" << outputPath.generic_string() << "'.\n";
+    return 0;
+}